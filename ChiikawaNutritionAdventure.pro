@@ -8,12 +8,30 @@ CONFIG += c++17
 # In order to do so, uncomment the following line.
 #DEFINES += QT_DISABLE_DEPRECATED_BEFORE=0x060000    # disables all the APIs deprecated before Qt 6.0.0
 
+# 统计帧循环线程与任务线程上的malloc/operator new调用次数，配合--check-allocs验证帧循环无堆分配：qmake CONFIG+=alloc_tracking
+alloc_tracking: DEFINES += SUGAR_OIL_ALLOC_TRACKING
+
+# 性能基准和堆分配检查（--bench-*、--check-allocs，见benchmarks.h）不编进游戏本体：qmake CONFIG+=benchmarks
+# 分配检查只在alloc_tracking构建中有意义，因此alloc_tracking隐含benchmarks
+alloc_tracking: CONFIG += benchmarks
+benchmarks {
+    DEFINES += CHIIKAWA_BENCHMARKS
+    SOURCES += benchmarks.cpp
+    HEADERS += benchmarks.h
+}
+
 SOURCES += \
     main.cpp \
     mainwindow.cpp \
     loginwindow.cpp \
     audio_manager.cpp \
     nutrition_quiz_window.cpp \
+    replay_log.cpp \
+    snapshot_io.cpp \
+    resource_bundle.cpp \
+    startup_trace.cpp \
+    render_profile.cpp \
+    asset_cache.cpp \
     mode1_carbohydrate_battle/carbohydrate_game_window.cpp \
     mode1_carbohydrate_battle/carbohydrate_game_scene.cpp \
     mode1_carbohydrate_battle/game_map.cpp \
@@ -30,13 +48,33 @@ SOURCES += \
     mode2_sugar_oil_battle/enemy_base.cpp \
     mode2_sugar_oil_battle/bullet_base.cpp \
     mode2_sugar_oil_battle/creature_system.cpp \
-    mode2_sugar_oil_battle/item_system.cpp
+    mode2_sugar_oil_battle/item_system.cpp \
+    mode2_sugar_oil_battle/steering_system.cpp \
+    mode2_sugar_oil_battle/spatial_grid.cpp \
+    mode2_sugar_oil_battle/swept_collision.cpp \
+    mode2_sugar_oil_battle/frame_arena.cpp \
+    mode2_sugar_oil_battle/effect_scheduler.cpp \
+    mode2_sugar_oil_battle/game_clock.cpp \
+    mode2_sugar_oil_battle/entity_query.cpp \
+    mode2_sugar_oil_battle/skill_scheduler.cpp \
+    mode2_sugar_oil_battle/bullet_store.cpp \
+    mode2_sugar_oil_battle/bullet_patterns.cpp \
+    mode2_sugar_oil_battle/bullet_store_item.cpp \
+    mode2_sugar_oil_battle/wave_director.cpp \
+    mode2_sugar_oil_battle/job_system.cpp \
+    mode2_sugar_oil_battle/animation_clips.cpp
 
 HEADERS += \
     mainwindow.h \
     loginwindow.h \
     audio_manager.h \
     nutrition_quiz_window.h \
+    replay_log.h \
+    snapshot_io.h \
+    resource_bundle.h \
+    startup_trace.h \
+    render_profile.h \
+    asset_cache.h \
     mode1_carbohydrate_battle/carbohydrate_config.h \
     mode1_carbohydrate_battle/carbohydrate_game_window.h \
     mode1_carbohydrate_battle/carbohydrate_game_scene.h \
@@ -55,7 +93,22 @@ HEADERS += \
     mode2_sugar_oil_battle/creature_system.h \
     mode2_sugar_oil_battle/item_system.h \
     mode2_sugar_oil_battle/enemy_base.h \
-    mode2_sugar_oil_battle/bullet_base.h
+    mode2_sugar_oil_battle/bullet_base.h \
+    mode2_sugar_oil_battle/steering_system.h \
+    mode2_sugar_oil_battle/spatial_grid.h \
+    mode2_sugar_oil_battle/swept_collision.h \
+    mode2_sugar_oil_battle/entity_list.h \
+    mode2_sugar_oil_battle/frame_arena.h \
+    mode2_sugar_oil_battle/effect_scheduler.h \
+    mode2_sugar_oil_battle/game_clock.h \
+    mode2_sugar_oil_battle/entity_query.h \
+    mode2_sugar_oil_battle/skill_scheduler.h \
+    mode2_sugar_oil_battle/bullet_store.h \
+    mode2_sugar_oil_battle/bullet_patterns.h \
+    mode2_sugar_oil_battle/bullet_store_item.h \
+    mode2_sugar_oil_battle/wave_director.h \
+    mode2_sugar_oil_battle/job_system.h \
+    mode2_sugar_oil_battle/animation_clips.h
 
 FORMS += \
     mainwindow.ui
@@ -63,7 +116,53 @@ FORMS += \
 RESOURCES += \
     resources.qrc
 
+# 构建时图集：qmake CONFIG+=sprite_atlas [ATLAS_PACKER=<atlas_packer路径>]
+# 先构建tools/atlas_packer，再由下面的额外编译步骤把角色图和道具图缩到屏幕尺寸（含2x）打包成图集，
+# 镜像图在运行时翻转生成；原图不再打包进程序。未开启时照旧打包sprites.qrc中的原图
+sprite_atlas {
+    isEmpty(ATLAS_PACKER): ATLAS_PACKER = $$OUT_PWD/tools/atlas_packer/atlas_packer
+    !exists($$ATLAS_PACKER): error("sprite_atlas: atlas_packer not found at $$ATLAS_PACKER")
+
+    ATLAS_SPECS = sprites_atlas.json
+    atlas.input = ATLAS_SPECS
+    atlas.output = $$OUT_PWD/atlas/${QMAKE_FILE_BASE}.qrc
+    atlas.commands = $$shell_path($$ATLAS_PACKER) ${QMAKE_FILE_IN} $$shell_path($$OUT_PWD/atlas)
+    atlas.depends = $$ATLAS_PACKER $$files($$PWD/img/roles/*.png) $$files($$PWD/img/items/*.png)
+    atlas.variable_out = RESOURCES
+    atlas.CONFIG += target_predeps
+    QMAKE_EXTRA_COMPILERS += atlas
+} else {
+    RESOURCES += sprites.qrc
+}
+
+# 外部资源包：背景图和音频不嵌入可执行文件，用rcc -binary打包到可执行文件旁的external_assets.rcc，
+# 启动时由ResourceBundle映射注册，路径仍是":/..."和"qrc:/..."。不压缩，条目直接从映射的文件页中读取
+# qmake CONFIG+=embedded_assets时照旧编译进程序，用于以--startup-trace对比两种方式的启动时间和内存
+embedded_assets {
+    RESOURCES += external_assets.qrc
+    DEFINES += EMBED_EXTERNAL_ASSETS
+} else {
+    EXTERNAL_RESOURCES = external_assets.qrc
+    qtPrepareTool(QMAKE_RCC, rcc, _DEP)
+    external_rcc.input = EXTERNAL_RESOURCES
+    external_rcc.output = $$OUT_PWD/${QMAKE_FILE_BASE}.rcc
+    external_rcc.commands = $$QMAKE_RCC -binary -no-compress ${QMAKE_FILE_IN} -o ${QMAKE_FILE_OUT}
+    external_rcc.depend_command = $$QMAKE_RCC_DEP -list ${QMAKE_FILE_IN}
+    external_rcc.CONFIG += no_link target_predeps
+    QMAKE_EXTRA_COMPILERS += external_rcc
+}
+
+# 启动追踪读取进程内存用
+win32: LIBS += -lpsapi
+
 # Default rules for deployment.
 qnx: target.path = /tmp/$${TARGET}/bin
 else: unix:!android: target.path = /opt/$${TARGET}/bin
 !isEmpty(target.path): INSTALLS += target
+
+!isEmpty(target.path):!embedded_assets {
+    external_assets.files = $$OUT_PWD/external_assets.rcc
+    external_assets.path = $$target.path
+    external_assets.CONFIG += no_check_exist
+    INSTALLS += external_assets
+}
@@ -0,0 +1,300 @@
+#include "asset_cache.h"
+#include <QDirIterator>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QGuiApplication>
+#include <QImageReader>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QThread>
+#include <QMutexLocker>
+#include <QDebug>
+#include "startup_trace.h"
+
+namespace
+{
+    // 构建时图集的清单，由tools/atlas_packer生成
+    const char* const ATLAS_MANIFEST = ":/atlas/sprites.json";
+    const char* const ATLAS_PREFIX = ":/atlas/";
+
+    // 游戏场景经AssetCache取用的非精灵图，进入游戏前解码好。
+    // 外部资源包中的其它背景图由各界面按需加载，不在这里解码
+    const char* const PRELOAD_IMAGES[] = {
+        ":/img/GameBackground.png",
+        ":/img/bulletsample.png",
+        ":/img/enemybulletsample.png"
+    };
+
+    // 精灵原图所在的目录（sprites.qrc）；开启图集时原图不打包，这些目录为空，改由图集清单提供
+    const char* const SPRITE_DIRS[] = {
+        ":/img/roles",
+        ":/img/items"
+    };
+
+    struct AtlasCut {
+        QString key;
+        QRect rect;
+        int sourceWidth;
+        QStringList mirrors;
+    };
+
+    struct AtlasPage {
+        QString path;
+        QVector<AtlasCut> cuts;
+    };
+
+    // 选不低于屏幕像素比的最小倍率，都低于时选最大的
+    QVector<AtlasPage> readAtlasManifest(qreal devicePixelRatio)
+    {
+        QFile file(ATLAS_MANIFEST);
+        if (!file.open(QIODevice::ReadOnly)) {
+            return {};
+        }
+        const QJsonObject manifest = QJsonDocument::fromJson(file.readAll()).object();
+        const QJsonArray scales = manifest.value("scales").toArray();
+
+        int chosen = -1;
+        int chosenScale = 0;
+        for (int i = 0; i < scales.size(); ++i) {
+            const int scale = scales.at(i).toObject().value("scale").toInt();
+            const bool better = chosen < 0
+                || (chosenScale < devicePixelRatio && scale > chosenScale)
+                || (scale >= devicePixelRatio && scale < chosenScale);
+            if (better) {
+                chosen = i;
+                chosenScale = scale;
+            }
+        }
+        if (chosen < 0) {
+            return {};
+        }
+
+        QVector<AtlasPage> pages;
+        for (const QJsonValue &page : scales.at(chosen).toObject().value("pages").toArray()) {
+            pages.append({ ATLAS_PREFIX + page.toString(), {} });
+        }
+        for (const QJsonValue &value : manifest.value("sprites").toArray()) {
+            const QJsonObject sprite = value.toObject();
+            // [页号, x, y, 宽, 高]
+            const QJsonArray rect = sprite.value("rects").toArray().at(chosen).toArray();
+            const int page = rect.at(0).toInt(-1);
+            if (page < 0 || page >= pages.size()) {
+                continue;
+            }
+            AtlasCut cut;
+            cut.key = sprite.value("key").toString();
+            cut.rect = QRect(rect.at(1).toInt(), rect.at(2).toInt(), rect.at(3).toInt(), rect.at(4).toInt());
+            cut.sourceWidth = sprite.value("width").toInt(cut.rect.width());
+            for (const QJsonValue &mirror : sprite.value("mirrors").toArray()) {
+                cut.mirrors.append(mirror.toString());
+            }
+            pages[page].cuts.append(cut);
+        }
+        return pages;
+    }
+}
+
+AssetCache* AssetCache::getInstance()
+{
+    static AssetCache cache;
+    return &cache;
+}
+
+AssetCache::AssetCache()
+    : mMissCount(0)
+{
+}
+
+QPixmap AssetCache::pixmap(const QString &path)
+{
+    const auto it = mPixmaps.constFind(path);
+    if (it != mPixmaps.constEnd()) {
+        return it.value();
+    }
+
+    const QPixmap pixmap(path);
+    mPixmaps.insert(path, pixmap);
+    if (!pixmap.isNull()) {
+        ++mMissCount;
+        qDebug() << "AssetCache: decoded outside preload" << path;
+    }
+    return pixmap;
+}
+
+QPixmap AssetCache::scaledPixmap(const QString &path, int size)
+{
+    const QString key = path + QLatin1Char('@') + QString::number(size);
+    const auto it = mPixmaps.constFind(key);
+    if (it != mPixmaps.constEnd()) {
+        return it.value();
+    }
+
+    // 按像素缩放后重置设备像素比，逻辑尺寸正好落在size以内
+    QPixmap scaled = pixmap(path);
+    if (!scaled.isNull()) {
+        scaled = scaled.scaled(size, size, Qt::KeepAspectRatio, Qt::SmoothTransformation);
+        scaled.setDevicePixelRatio(1.0);
+    }
+    mPixmaps.insert(key, scaled);
+    return scaled;
+}
+
+AssetPreloader::AssetPreloader(QObject *parent)
+    : QObject(parent)
+    , mSliceTimer(new QTimer(this))
+    , mStarted(false)
+    , mLoaded(0)
+    , mTotal(0)
+{
+    // 留一个核给界面线程
+    mPool.setMaxThreadCount(qMax(1, QThread::idealThreadCount() - 1));
+    mSliceTimer->setInterval(SLICE_BUDGET_MS * 2);
+    connect(mSliceTimer, &QTimer::timeout, this, &AssetPreloader::convertSlice);
+}
+
+AssetPreloader::~AssetPreloader()
+{
+    // 解码任务引用了mMutex和mDecoded，必须先等它们结束
+    mPool.waitForDone();
+}
+
+QStringList AssetPreloader::imagePaths()
+{
+    QStringList paths;
+    for (const char* path : PRELOAD_IMAGES) {
+        if (QFile::exists(path)) {
+            paths.append(path);
+        }
+    }
+    for (const char* dir : SPRITE_DIRS) {
+        QDirIterator it(dir, { "*.png" }, QDir::Files);
+        while (it.hasNext()) {
+            paths.append(it.next());
+        }
+    }
+    paths.sort();
+    return paths;
+}
+
+void AssetPreloader::start()
+{
+    if (mStarted) {
+        return;
+    }
+    mStarted = true;
+
+    const QStringList paths = imagePaths();
+    mTotal = paths.size();
+    for (const QString &path : paths) {
+        mPool.start([this, path]() {
+            QImageReader reader(path);
+            QImage image = reader.read();
+            // 预乘格式转QPixmap时不需要再逐像素转换，主线程上的开销只剩一次拷贝
+            if (!image.isNull()) {
+                image = image.convertToFormat(QImage::Format_ARGB32_Premultiplied);
+            }
+            QMutexLocker locker(&mMutex);
+            mDecoded.append(qMakePair(path, image));
+        });
+    }
+
+    mTotal += queueAtlasPages();
+
+    if (mTotal == 0) {
+        emit finished();
+        return;
+    }
+    mSliceTimer->start();
+}
+
+int AssetPreloader::queueAtlasPages()
+{
+    const qreal devicePixelRatio = qGuiApp ? qGuiApp->devicePixelRatio() : 1.0;
+    const QVector<AtlasPage> pages = readAtlasManifest(devicePixelRatio);
+
+    int count = 0;
+    for (const AtlasPage &page : pages) {
+        for (const AtlasCut &cut : page.cuts) {
+            count += 1 + cut.mirrors.size();
+        }
+        mPool.start([this, page]() {
+            QImageReader reader(page.path);
+            const QImage atlas = reader.read().convertToFormat(QImage::Format_ARGB32_Premultiplied);
+
+            QVector<QPair<QString, QImage>> sprites;
+            for (const AtlasCut &cut : page.cuts) {
+                QImage sprite = atlas.copy(cut.rect);
+                sprite.setDevicePixelRatio(static_cast<qreal>(cut.sourceWidth) / qMax(1, cut.rect.width()));
+                for (const QString &mirror : cut.mirrors) {
+                    QImage mirrored = sprite.mirrored(true, false);
+                    mirrored.setDevicePixelRatio(sprite.devicePixelRatio());
+                    sprites.append(qMakePair(mirror, mirrored));
+                }
+                sprites.append(qMakePair(cut.key, sprite));
+            }
+            QMutexLocker locker(&mMutex);
+            mDecoded += sprites;
+        });
+    }
+    return count;
+}
+
+void AssetPreloader::finishNow()
+{
+    if (!mStarted) {
+        start();
+    }
+    if (isFinished()) {
+        return;
+    }
+    mPool.waitForDone();
+    reportProgress(convertDecoded(0));
+}
+
+void AssetPreloader::convertSlice()
+{
+    reportProgress(convertDecoded(SLICE_BUDGET_MS));
+}
+
+int AssetPreloader::convertDecoded(qint64 budgetMs)
+{
+    QVector<QPair<QString, QImage>> batch;
+    {
+        QMutexLocker locker(&mMutex);
+        batch.swap(mDecoded);
+    }
+
+    QElapsedTimer timer;
+    timer.start();
+    AssetCache* cache = AssetCache::getInstance();
+    int converted = 0;
+    for (; converted < batch.size(); ++converted) {
+        if (budgetMs > 0 && converted > 0 && timer.elapsed() >= budgetMs) {
+            break;
+        }
+        const QPair<QString, QImage> &entry = batch.at(converted);
+        cache->insert(entry.first, QPixmap::fromImage(entry.second));
+    }
+
+    // 超时未转换的放回队列前端，下一片继续
+    if (converted < batch.size()) {
+        QMutexLocker locker(&mMutex);
+        mDecoded = batch.mid(converted) + mDecoded;
+    }
+    return converted;
+}
+
+void AssetPreloader::reportProgress(int converted)
+{
+    if (converted <= 0) {
+        return;
+    }
+    mLoaded += converted;
+    emit progress(mLoaded, mTotal);
+    if (mLoaded == mTotal) {
+        mSliceTimer->stop();
+        StartupTrace::mark("asset_preload_finished");
+        emit finished();
+    }
+}
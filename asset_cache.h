@@ -0,0 +1,95 @@
+#ifndef ASSET_CACHE_H
+#define ASSET_CACHE_H
+
+#include <QObject>
+#include <QHash>
+#include <QImage>
+#include <QMutex>
+#include <QPair>
+#include <QPixmap>
+#include <QString>
+#include <QStringList>
+#include <QThreadPool>
+#include <QTimer>
+#include <QVector>
+
+// 共享图片缓存：按资源路径（如":/img/roles/usagi1.png"）保存已转换好的QPixmap
+// 图片在登录界面由AssetPreloader预先解码，游戏中取图只查表。
+// 未预载的路径在第一次取用时同步解码并记一次未命中；不存在的路径也会缓存空图，不会反复尝试。
+// 使用构建时图集（CONFIG+=sprite_atlas）时，角色图和道具图是缩小过的图集子图，
+// 设备像素比设为原图宽度/子图宽度，逻辑尺寸与原图一致，场景中的缩放、包围盒和碰撞都不变
+class AssetCache
+{
+public:
+    static AssetCache* getInstance();
+
+    QPixmap pixmap(const QString &path);
+    // 缩放到size×size以内（保持比例）、设备像素比为1的图，结果同样缓存
+    QPixmap scaledPixmap(const QString &path, int size);
+    bool contains(const QString &path) const { return mPixmaps.contains(path); }
+    void insert(const QString &path, const QPixmap &pixmap) { mPixmaps.insert(path, pixmap); }
+
+    int size() const { return mPixmaps.size(); }
+    // 预载之外同步解码的次数，正常情况下应为0
+    int getMissCount() const { return mMissCount; }
+
+private:
+    AssetCache();
+
+    QHash<QString, QPixmap> mPixmaps;
+    int mMissCount;
+};
+
+// 资源图片预载器
+// 工作线程用QImageReader解码qrc中的全部图片并转成预乘ARGB格式；
+// 有图集时按屏幕像素比选一套图集页，解码后切出子图并翻转生成镜像图，
+// 主线程每次定时器回调只转换不超过SLICE_BUDGET_MS的QPixmap，界面保持响应；
+// 转换好的图片放入AssetCache，每完成一批发出progress
+class AssetPreloader : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit AssetPreloader(QObject *parent = nullptr);
+    ~AssetPreloader();
+
+    // 需要预载的图片路径（不含图集页）：游戏场景用到的几张非精灵图，加上未开启图集时的精灵原图
+    static QStringList imagePaths();
+
+    void start();
+    // 等待剩余图片解码并全部转换完（进入游戏前调用，保证游戏中不再解码）
+    void finishNow();
+
+    bool isFinished() const { return mStarted && mLoaded == mTotal; }
+    int getLoaded() const { return mLoaded; }
+    int getTotal() const { return mTotal; }
+
+signals:
+    void progress(int loaded, int total);
+    void finished();
+
+private slots:
+    void convertSlice();
+
+private:
+    // 转换已解码的图片，budgetMs<=0时不限时间；返回本次转换的数量
+    int convertDecoded(qint64 budgetMs);
+    // 提交图集页的解码任务，返回将产生的图片数（含镜像），没有图集时为0
+    int queueAtlasPages();
+    void reportProgress(int converted);
+
+    QThreadPool mPool;
+    QTimer* mSliceTimer;
+
+    // 工作线程的解码结果，主线程取走
+    QMutex mMutex;
+    QVector<QPair<QString, QImage>> mDecoded;
+
+    bool mStarted;
+    int mLoaded;
+    int mTotal;
+
+    static const int SLICE_BUDGET_MS = 4;
+};
+
+#endif // ASSET_CACHE_H
@@ -1,12 +1,15 @@
 #include "audio_manager.h"
 #include <QDebug>
+#include "startup_trace.h"
 
 AudioManager* AudioManager::instance = nullptr;
 
 AudioManager* AudioManager::getInstance()
 {
     if (!instance) {
+        StartupTrace::mark("audio_manager_begin");
         instance = new AudioManager();
+        StartupTrace::mark("audio_manager");
     }
     return instance;
 }
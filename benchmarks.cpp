@@ -0,0 +1,743 @@
+#include "benchmarks.h"
+#include "asset_cache.h"
+#include "render_profile.h"
+#include "replay_log.h"
+#include "mode1_carbohydrate_battle/carbohydrate_game_scene.h"
+#include "mode2_sugar_oil_battle/sugar_oil_game_scene_new.h"
+#include <QApplication>
+#include <QDebug>
+#include <QElapsedTimer>
+#include <QRandomGenerator>
+#include <QTemporaryDir>
+#include <QtMath>
+#include <functional>
+
+typedef SugarOilGameSceneNew Scene;
+
+namespace
+{
+    // 删除基准用的最小实体，只有EntityList需要的槽位接口
+    struct BenchEntity {
+        int slot = -1;
+        bool pending = false;
+
+        void setEntitySlot(int value) { slot = value; }
+        int getEntitySlot() const { return slot; }
+        void setPendingRemoval(bool value) { pending = value; }
+        bool isPendingRemoval() const { return pending; }
+    };
+
+    // 查询基准不创建真实实体：索引只保存指针、从不解引用，用下标+1充当指针，回调里再还原成下标
+    GameObjectBase* benchTag(int index)
+    {
+        return reinterpret_cast<GameObjectBase*>(static_cast<quintptr>(index + 1));
+    }
+
+    int benchIndex(const GameObjectBase* tag)
+    {
+        return static_cast<int>(reinterpret_cast<quintptr>(tag)) - 1;
+    }
+
+    // 带可选整数参数的开关，如"--bench-render 600"；参数缺失或不是正整数时用fallback
+    int optionValue(const QStringList &arguments, int index, int fallback)
+    {
+        bool ok = false;
+        const int value = index + 1 < arguments.size() ? arguments.at(index + 1).toInt(&ok) : 0;
+        return ok && value > 0 ? value : fallback;
+    }
+
+    // 逐档位绘制frames帧并输出平均绘制耗时
+    void benchmarkProfiles(const QString &mode, ProfiledGraphicsView &view, int frames,
+                           const std::function<void(RenderProfile)> &applyScene,
+                           const std::function<void()> &step)
+    {
+        view.show();
+        for (int i = 0; i < RenderProfiles::PROFILE_COUNT; ++i) {
+            const RenderProfile profile = static_cast<RenderProfile>(i);
+            RenderProfiles::apply(&view, profile);
+            applyScene(profile);
+            QApplication::processEvents();
+
+            int count = 0;
+            qreal averageUs = 0.0;
+            view.takePaintStats(count, averageUs);
+
+            QElapsedTimer timer;
+            timer.start();
+            for (int frame = 0; frame < frames; ++frame) {
+                step();
+                QApplication::processEvents();
+            }
+            const qint64 elapsedMs = timer.elapsed();
+            view.takePaintStats(count, averageUs);
+
+            qDebug() << "Render benchmark - Mode:" << mode
+                     << "Profile:" << RenderProfiles::name(profile)
+                     << "Frames painted:" << count
+                     << "Paint us/frame:" << QString::number(averageUs, 'f', 1)
+                     << "Wall ms:" << elapsedMs;
+        }
+    }
+}
+
+bool Benchmarks::dispatch(const QStringList &arguments, int &exitCode)
+{
+    exitCode = 0;
+
+    // 并行模拟基准：--bench-parallel [实体数]，默认2万
+    const int parallelIndex = arguments.indexOf("--bench-parallel");
+    if (parallelIndex >= 0) {
+        runParallel(optionValue(arguments, parallelIndex, 20000));
+        return true;
+    }
+
+    // 转向基准：--bench-steering，敌人数从100到10万
+    if (arguments.contains("--bench-steering")) {
+        runSteering();
+        return true;
+    }
+
+    // 删除基准：--bench-removal，列表规模从500到5000
+    if (arguments.contains("--bench-removal")) {
+        runRemoval();
+        return true;
+    }
+
+    // 查询基准：--bench-query，实体数从1000到2万
+    if (arguments.contains("--bench-query")) {
+        runQuery();
+        return true;
+    }
+
+    // 最近邻基准：--bench-nearest，敌人数从100到1万
+    if (arguments.contains("--bench-nearest")) {
+        runNearest();
+        return true;
+    }
+
+    // 敌人子弹基准：--bench-bullets，存量从1000到1万颗
+    if (arguments.contains("--bench-bullets")) {
+        runBullets();
+        return true;
+    }
+
+    // 波次基准：--bench-waves，按帧耗时模型比较有无退避
+    if (arguments.contains("--bench-waves")) {
+        runWaves();
+        return true;
+    }
+
+    // 堆分配回归检查：--check-allocs，需以qmake CONFIG+=alloc_tracking构建，计数非零时返回1
+    if (arguments.contains("--check-allocs")) {
+        AssetPreloader preloader;
+        preloader.finishNow();
+        SugarOilGameSceneNew scene;
+        exitCode = runAllocationCheck(scene, 1200, 3600) ? 0 : 1;
+        return true;
+    }
+
+    // 绘制基准：--bench-render [帧数]，默认300帧
+    const int renderIndex = arguments.indexOf("--bench-render");
+    if (renderIndex >= 0) {
+        runRender(optionValue(arguments, renderIndex, 300));
+        return true;
+    }
+
+    return false;
+}
+
+Benchmarks::EnemyFixture Benchmarks::makeEnemyFixture(QRandomGenerator &random, int count)
+{
+    EnemyFixture fixture;
+    fixture.x.resize(count);
+    fixture.y.resize(count);
+    fixture.speed.resize(count);
+    fixture.group.resize(count);
+    for (int i = 0; i < count; ++i) {
+        fixture.x[i] = static_cast<float>(random.bounded(Scene::SCENE_WIDTH + 2 * Scene::ENEMY_GRID_MARGIN)
+                                          - Scene::ENEMY_GRID_MARGIN);
+        fixture.y[i] = static_cast<float>(random.bounded(Scene::SCENE_HEIGHT + 2 * Scene::ENEMY_GRID_MARGIN)
+                                          - Scene::ENEMY_GRID_MARGIN);
+        fixture.speed[i] = static_cast<float>(1.0 + random.generateDouble() * 2.0);
+        fixture.group[i] = static_cast<quint8>(random.bounded(EnemyBase::ENEMY_TYPE_COUNT));
+    }
+    return fixture;
+}
+
+void Benchmarks::runParallel(int entityCount)
+{
+    const int frames = 120;
+    entityCount = qMax(1, entityCount);
+
+    // 固定种子生成场景内外的初始位置，每种线程数都从同一份数据开始
+    QRandomGenerator random(1);
+    const EnemyFixture fixture = makeEnemyFixture(random, entityCount);
+
+    QVector<float> referenceX;
+    QVector<float> referenceY;
+    double baselineMs = 0.0;
+    for (int threads : { 1, 2, 4, 8 }) {
+        JobSystem jobs(threads);
+        SpatialGrid grid(-Scene::ENEMY_GRID_MARGIN, -Scene::ENEMY_GRID_MARGIN,
+                         Scene::SCENE_WIDTH + 2 * Scene::ENEMY_GRID_MARGIN,
+                         Scene::SCENE_HEIGHT + 2 * Scene::ENEMY_GRID_MARGIN,
+                         Scene::ENEMY_GRID_CELL_SIZE);
+        BulletStore bullets(entityCount);
+        for (int i = 0; i < entityCount; ++i) {
+            bullets.spawn(fixture.x[i], fixture.y[i], fixture.speed[i] * 0.01f, -fixture.speed[i] * 0.01f, 1);
+        }
+        QVector<float> xs = fixture.x;
+        QVector<float> ys = fixture.y;
+        QVector<float> dirX(entityCount);
+        QVector<float> dirY(entityCount);
+
+        QElapsedTimer timer;
+        timer.start();
+        for (int frame = 0; frame < frames; ++frame) {
+            SteeringSystem::steer(&jobs, xs.data(), ys.data(), entityCount, entityCount,
+                                  Scene::SCENE_WIDTH * 0.5f, Scene::SCENE_HEIGHT * 0.5f, 0.0f, &grid,
+                                  fixture.group.constData(), EnemyBase::getCrowdParamsTable(),
+                                  fixture.speed.constData(), dirX.data(), dirY.data());
+            bullets.integrate(Scene::UPDATE_INTERVAL, &jobs);
+        }
+        const double msPerFrame = timer.nsecsElapsed() / 1000000.0 / frames;
+
+        if (referenceX.isEmpty()) {
+            referenceX = xs;
+            referenceY = ys;
+            baselineMs = msPerFrame;
+        }
+        qDebug() << "Parallel benchmark - Threads:" << jobs.getThreadCount()
+                 << "Entities:" << entityCount
+                 << "ms/frame:" << msPerFrame
+                 << "Speedup:" << (msPerFrame > 0.0 ? baselineMs / msPerFrame : 0.0)
+                 << "Matches single thread:" << (xs == referenceX && ys == referenceY);
+    }
+}
+
+void Benchmarks::runSteering()
+{
+    const int frames = 60;
+    const float targetX = Scene::SCENE_WIDTH * 0.5f;
+    const float targetY = Scene::SCENE_HEIGHT * 0.5f;
+
+    for (int count : { 100, 1000, 10000, 100000 }) {
+        // 固定种子，三种路径都从同一份位置开始
+        QRandomGenerator random(1);
+        const EnemyFixture fixture = makeEnemyFixture(random, count);
+        QVector<float> dirX(count);
+        QVector<float> dirY(count);
+        QVector<float> scalarDirX(count);
+        QVector<float> scalarDirY(count);
+
+        // SIMD与标量在同一组位置上的偏差
+        SteeringSystem::computeSeekDirections(fixture.x.constData(), fixture.y.constData(), count,
+                                              targetX, targetY, 0.0f, dirX.data(), dirY.data());
+        SteeringSystem::computeSeekDirectionsScalar(fixture.x.constData(), fixture.y.constData(), 0, count,
+                                                    targetX, targetY, 0.0f, scalarDirX.data(), scalarDirY.data());
+        float maxError = 0.0f;
+        for (int i = 0; i < count; ++i) {
+            maxError = qMax(maxError, qMax(qAbs(dirX[i] - scalarDirX[i]), qAbs(dirY[i] - scalarDirY[i])));
+        }
+
+        QVector<float> xs = fixture.x;
+        QVector<float> ys = fixture.y;
+        QElapsedTimer timer;
+        timer.start();
+        for (int frame = 0; frame < frames; ++frame) {
+            SteeringSystem::computeSeekDirections(xs.constData(), ys.constData(), count, targetX, targetY, 0.0f,
+                                                  dirX.data(), dirY.data());
+            SteeringSystem::integratePositions(xs.data(), ys.data(), dirX.constData(), dirY.constData(),
+                                               fixture.speed.constData(), count);
+        }
+        const double simdUs = timer.nsecsElapsed() / 1000.0 / frames;
+
+        xs = fixture.x;
+        ys = fixture.y;
+        timer.restart();
+        for (int frame = 0; frame < frames; ++frame) {
+            SteeringSystem::computeSeekDirectionsScalar(xs.constData(), ys.constData(), 0, count, targetX, targetY, 0.0f,
+                                                        dirX.data(), dirY.data());
+            SteeringSystem::integratePositions(xs.data(), ys.data(), dirX.constData(), dirY.constData(),
+                                               fixture.speed.constData(), count);
+        }
+        const double scalarUs = timer.nsecsElapsed() / 1000.0 / frames;
+
+        xs = fixture.x;
+        ys = fixture.y;
+        SpatialGrid grid(-Scene::ENEMY_GRID_MARGIN, -Scene::ENEMY_GRID_MARGIN,
+                         Scene::SCENE_WIDTH + 2 * Scene::ENEMY_GRID_MARGIN,
+                         Scene::SCENE_HEIGHT + 2 * Scene::ENEMY_GRID_MARGIN,
+                         Scene::ENEMY_GRID_CELL_SIZE);
+        timer.restart();
+        for (int frame = 0; frame < frames; ++frame) {
+            SteeringSystem::steer(nullptr, xs.data(), ys.data(), count, count, targetX, targetY, 0.0f, &grid,
+                                  fixture.group.constData(), EnemyBase::getCrowdParamsTable(),
+                                  fixture.speed.constData(), dirX.data(), dirY.data());
+        }
+        const double crowdUs = timer.nsecsElapsed() / 1000.0 / frames;
+
+        qDebug() << "Steering benchmark - Enemies:" << count
+                 << "SIMD seek us/frame:" << simdUs
+                 << "Scalar seek us/frame:" << scalarUs
+                 << "Crowd pipeline us/frame:" << crowdUs
+                 << "Max SIMD error:" << maxError;
+    }
+}
+
+void Benchmarks::runRemoval()
+{
+    const int rounds = 20;
+
+    for (int count : { 500, 1000, 2000, 5000 }) {
+        QVector<BenchEntity> entities(count);
+        // 固定种子的删除顺序，两种列表删除同一批实体
+        QRandomGenerator random(1);
+        QVector<int> victims(count);
+        for (int i = 0; i < count; ++i) {
+            victims[i] = i;
+        }
+        for (int i = count - 1; i > 0; --i) {
+            qSwap(victims[i], victims[random.bounded(i + 1)]);
+        }
+        victims.resize(count / 2);
+
+        qint64 queueNsecs = 0;
+        qint64 listNsecs = 0;
+        QElapsedTimer timer;
+        for (int round = 0; round < rounds; ++round) {
+            EntityList<BenchEntity> entityList;
+            QList<BenchEntity*> plainList;
+            entityList.reserve(count);
+            plainList.reserve(count);
+            for (BenchEntity &entity : entities) {
+                entityList.append(&entity);
+                plainList.append(&entity);
+            }
+
+            timer.start();
+            for (int index : victims) {
+                entityList.queueRemoval(&entities[index]);
+            }
+            entityList.flushRemovals([](BenchEntity*) {});
+            queueNsecs += timer.nsecsElapsed();
+
+            timer.start();
+            for (int index : victims) {
+                plainList.removeOne(&entities[index]);
+            }
+            listNsecs += timer.nsecsElapsed();
+        }
+
+        const double removals = static_cast<double>(rounds) * victims.size();
+        qDebug() << "Removal benchmark - Entities:" << count
+                 << "Death queue ns/entity:" << queueNsecs / removals
+                 << "QList::removeOne ns/entity:" << listNsecs / removals;
+    }
+}
+
+void Benchmarks::runQuery()
+{
+    const int queries = 512;
+    const qreal radius = 200.0; // 与吸铁石的吸引半径相同
+    const QRectF screenRect(0, 0, Scene::SCENE_WIDTH, Scene::SCENE_HEIGHT);
+
+    for (int count : { 1000, 5000, 20000 }) {
+        // 固定种子，索引查询与暴力遍历使用同一组实体和查询点
+        QRandomGenerator random(1);
+        const EnemyFixture fixture = makeEnemyFixture(random, count);
+        const QVector<float> &xs = fixture.x;
+        const QVector<float> &ys = fixture.y;
+        QVector<QPointF> centers(queries);
+        for (QPointF &center : centers) {
+            center = QPointF(random.bounded(Scene::SCENE_WIDTH), random.bounded(Scene::SCENE_HEIGHT));
+        }
+
+        EntityQueryIndex index(-Scene::ENEMY_GRID_MARGIN, -Scene::ENEMY_GRID_MARGIN,
+                               Scene::SCENE_WIDTH + 2 * Scene::ENEMY_GRID_MARGIN,
+                               Scene::SCENE_HEIGHT + 2 * Scene::ENEMY_GRID_MARGIN,
+                               Scene::QUERY_GRID_CELL_SIZE);
+        QElapsedTimer timer;
+        timer.start();
+        index.clearLayer(QUERY_ENEMIES);
+        for (int i = 0; i < count; ++i) {
+            index.add(QUERY_ENEMIES, benchTag(i), QPointF(xs[i], ys[i]));
+        }
+        index.buildLayer(QUERY_ENEMIES);
+        const double buildUs = timer.nsecsElapsed() / 1000.0;
+
+        // 两条路径各自累计命中数和下标和，用于核对结果一致
+        qint64 indexHits = 0;
+        qint64 indexSum = 0;
+        timer.restart();
+        for (const QPointF &center : centers) {
+            index.queryRadius(center, radius, QUERY_ENEMIES, [&](GameObjectBase* object, EntityQueryFaction) {
+                ++indexHits;
+                indexSum += benchIndex(object);
+                return true;
+            });
+        }
+        const double indexRadiusNs = static_cast<double>(timer.nsecsElapsed()) / queries;
+
+        qint64 bruteHits = 0;
+        qint64 bruteSum = 0;
+        const float r2 = static_cast<float>(radius * radius);
+        timer.restart();
+        for (const QPointF &center : centers) {
+            const float cx = static_cast<float>(center.x());
+            const float cy = static_cast<float>(center.y());
+            for (int i = 0; i < count; ++i) {
+                const float dx = xs[i] - cx;
+                const float dy = ys[i] - cy;
+                if (dx * dx + dy * dy <= r2) {
+                    ++bruteHits;
+                    bruteSum += i;
+                }
+            }
+        }
+        const double bruteRadiusNs = static_cast<double>(timer.nsecsElapsed()) / queries;
+
+        // 炸弹用的整屏矩形查询
+        qint64 rectHits = 0;
+        timer.restart();
+        index.queryRect(screenRect, QUERY_ENEMIES, [&](GameObjectBase*, EntityQueryFaction) {
+            ++rectHits;
+            return true;
+        });
+        const double rectUs = timer.nsecsElapsed() / 1000.0;
+        qint64 bruteRectHits = 0;
+        for (int i = 0; i < count; ++i) {
+            bruteRectHits += (xs[i] >= 0.0f && xs[i] <= Scene::SCENE_WIDTH
+                              && ys[i] >= 0.0f && ys[i] <= Scene::SCENE_HEIGHT) ? 1 : 0;
+        }
+
+        qDebug() << "Query benchmark - Entities:" << count
+                 << "Build us:" << buildUs
+                 << "Radius query ns:" << indexRadiusNs
+                 << "Brute force ns:" << bruteRadiusNs
+                 << "Screen rect us:" << rectUs
+                 << "Matches brute force:" << (indexHits == bruteHits && indexSum == bruteSum
+                                                && rectHits == bruteRectHits);
+    }
+}
+
+void Benchmarks::runNearest()
+{
+    const int turrets = 64;
+    const int k = Scene::TURRET_TARGET_CANDIDATES;
+    const qreal range = Scene::TURRET_RANGE;
+    const float range2 = static_cast<float>(range * range);
+
+    for (int count : { 100, 1000, 10000 }) {
+        // 固定种子，网格逐圈搜索与暴力遍历使用同一组敌人和炮台位置
+        QRandomGenerator random(1);
+        const EnemyFixture fixture = makeEnemyFixture(random, count);
+        const QVector<float> &xs = fixture.x;
+        const QVector<float> &ys = fixture.y;
+        QVector<QPointF> origins(turrets);
+        for (QPointF &origin : origins) {
+            origin = QPointF(random.bounded(Scene::SCENE_WIDTH), random.bounded(Scene::SCENE_HEIGHT));
+        }
+
+        EntityQueryIndex index(-Scene::ENEMY_GRID_MARGIN, -Scene::ENEMY_GRID_MARGIN,
+                               Scene::SCENE_WIDTH + 2 * Scene::ENEMY_GRID_MARGIN,
+                               Scene::SCENE_HEIGHT + 2 * Scene::ENEMY_GRID_MARGIN,
+                               Scene::QUERY_GRID_CELL_SIZE);
+        index.clearLayer(QUERY_ENEMIES);
+        for (int i = 0; i < count; ++i) {
+            index.add(QUERY_ENEMIES, benchTag(i), QPointF(xs[i], ys[i]));
+        }
+        index.buildLayer(QUERY_ENEMIES);
+
+        // 两条路径的结果按炮台依次存下距离，最后逐个比较；距离相同的敌人先后不定，所以不比较下标
+        QVector<float> gridDist2(turrets * k, -1.0f);
+        QVector<float> bruteDist2(turrets * k, -1.0f);
+        GameObjectBase* found[EntityQueryIndex::MAX_NEAREST];
+
+        QElapsedTimer timer;
+        timer.start();
+        for (int t = 0; t < turrets; ++t) {
+            const int n = index.findNearest(origins[t], range, QUERY_ENEMIES, found, k);
+            for (int j = 0; j < n; ++j) {
+                const int i = benchIndex(found[j]);
+                const float dx = xs[i] - static_cast<float>(origins[t].x());
+                const float dy = ys[i] - static_cast<float>(origins[t].y());
+                gridDist2[t * k + j] = dx * dx + dy * dy;
+            }
+        }
+        const double gridNs = static_cast<double>(timer.nsecsElapsed()) / turrets;
+
+        timer.restart();
+        for (int t = 0; t < turrets; ++t) {
+            const float cx = static_cast<float>(origins[t].x());
+            const float cy = static_cast<float>(origins[t].y());
+            float* best = bruteDist2.data() + t * k;
+            int n = 0;
+            for (int i = 0; i < count; ++i) {
+                const float dx = xs[i] - cx;
+                const float dy = ys[i] - cy;
+                const float d2 = dx * dx + dy * dy;
+                if (d2 > range2 || (n == k && d2 >= best[k - 1])) {
+                    continue;
+                }
+                int pos = (n < k) ? n++ : k - 1;
+                while (pos > 0 && best[pos - 1] > d2) {
+                    best[pos] = best[pos - 1];
+                    --pos;
+                }
+                best[pos] = d2;
+            }
+        }
+        const double bruteNs = static_cast<double>(timer.nsecsElapsed()) / turrets;
+
+        qDebug() << "Nearest benchmark - Enemies:" << count
+                 << "k:" << k
+                 << "Grid search ns/turret:" << gridNs
+                 << "Brute force ns/turret:" << bruteNs
+                 << "Matches brute force:" << (gridDist2 == bruteDist2);
+    }
+}
+
+void Benchmarks::runBullets()
+{
+    const int frames = 300;
+    const QRectF bounds(-Scene::BULLET_BOUNDS_MARGIN, -Scene::BULLET_BOUNDS_MARGIN,
+                        Scene::SCENE_WIDTH + 2 * Scene::BULLET_BOUNDS_MARGIN,
+                        Scene::SCENE_HEIGHT + 2 * Scene::BULLET_BOUNDS_MARGIN);
+    const QRectF playerRect(Scene::SCENE_WIDTH * 0.5 - 16, Scene::SCENE_HEIGHT * 0.5 - 16, 32, 32);
+
+    for (int target : { 1000, 5000, 10000 }) {
+        QVector<float> referenceX;
+        QVector<float> referenceY;
+        double singleUs = 0.0;
+        for (int threads : { 1, 0 }) {
+            // 固定种子，单线程和多线程发射同一串弹幕；每帧用环形和螺旋补足到目标数量，越界的子弹照常剔除
+            QRandomGenerator random(1);
+            JobSystem jobs(threads);
+            BulletStore store(Scene::MAX_ENEMY_BULLETS);
+            float spiralAngle = 0.0f;
+            int hits = 0;
+
+            QElapsedTimer timer;
+            timer.start();
+            for (int frame = 0; frame < frames; ++frame) {
+                while (store.size() < target) {
+                    const QPointF origin(random.bounded(Scene::SCENE_WIDTH), random.bounded(Scene::SCENE_HEIGHT));
+                    const bool spiral = random.bounded(2) == 0;
+                    BulletPatterns::fire(store, spiral ? BulletPatternId::Spiral : BulletPatternId::Ring,
+                                         origin, spiralAngle, 1);
+                    spiralAngle += BulletPatterns::getPattern(BulletPatternId::Spiral).rotationStep;
+                }
+                store.integrate(Scene::UPDATE_INTERVAL, &jobs);
+                store.removeOutside(bounds);
+                hits += store.collideRect(playerRect, [](int) {});
+            }
+            const double usPerFrame = timer.nsecsElapsed() / 1000.0 / frames;
+
+            const QVector<float> xs(store.xData(), store.xData() + store.size());
+            const QVector<float> ys(store.yData(), store.yData() + store.size());
+            if (referenceX.isEmpty()) {
+                referenceX = xs;
+                referenceY = ys;
+                singleUs = usPerFrame;
+            }
+            qDebug() << "Bullet benchmark - Bullets:" << target
+                     << "Threads:" << jobs.getThreadCount()
+                     << "us/frame:" << usPerFrame
+                     << "Share of 16 ms frame (%):" << usPerFrame / (Scene::UPDATE_INTERVAL * 10.0)
+                     << "Speedup:" << (usPerFrame > 0.0 ? singleUs / usPerFrame : 0.0)
+                     << "Player hits:" << hits
+                     << "Matches single thread:" << (xs == referenceX && ys == referenceY);
+        }
+    }
+}
+
+void Benchmarks::runWaves()
+{
+    // 帧耗时模型：固定开销加上每个存活敌人的开销，显示帧不短于16毫秒；
+    // 敌人平均存活6秒后被玩家消灭。模型只用于比较有无退避，不代表真实机器的数值
+    const qint64 durationMs = 10 * 60 * 1000;
+    const qreal baseFrameMs = 4.0;
+    const qreal enemyLifetimeMs = 6000.0;
+    const qreal budgetMs = 1000.0 / 60.0;
+    const QRectF sceneBounds(0, 0, Scene::SCENE_WIDTH, Scene::SCENE_HEIGHT);
+
+    for (qreal perEnemyMs : { 0.01, 0.05, 0.1 }) {
+        for (bool backoff : { false, true }) {
+            // 固定种子，有无退避两次运行读同一张波次表
+            QRandomGenerator random(1);
+            WaveDirector director;
+            director.setRandomGenerator(&random);
+            director.loadFromFile(":/data/sugar_oil_waves.json");
+            director.reset();
+            director.setAutoBackoff(backoff);
+
+            QVector<WaveSpawn> spawns;
+            qint64 now = 0;
+            int alive = 0;
+            qreal pendingKills = 0.0;
+            int frames = 0;
+            int slowFrames = 0;
+            int peakAlive = 0;
+            qreal worstFrameMs = 0.0;
+            qint64 advanceNsecs = 0;
+            QElapsedTimer timer;
+            while (now < durationMs) {
+                const qreal frameMs = qMax(budgetMs, baseFrameMs + perEnemyMs * alive);
+                director.reportFrameTime(frameMs);
+                now += qRound64(frameMs);
+
+                spawns.clear();
+                timer.start();
+                alive += director.advance(now, alive, sceneBounds, spawns);
+                advanceNsecs += timer.nsecsElapsed();
+
+                pendingKills += alive * frameMs / enemyLifetimeMs;
+                const int kills = qMin(alive, static_cast<int>(pendingKills));
+                alive -= kills;
+                pendingKills -= kills;
+
+                ++frames;
+                slowFrames += frameMs > budgetMs * 1.1 ? 1 : 0;
+                peakAlive = qMax(peakAlive, alive);
+                worstFrameMs = qMax(worstFrameMs, frameMs);
+            }
+
+            qDebug() << "Wave benchmark - Cost per enemy ms:" << perEnemyMs
+                     << "Backoff:" << backoff
+                     << "Frames:" << frames
+                     << "Over budget (%):" << 100.0 * slowFrames / frames
+                     << "Worst frame ms:" << worstFrameMs
+                     << "Peak alive:" << peakAlive
+                     << "Final backoff:" << director.getBackoff()
+                     << "advance() ns:" << static_cast<double>(advanceNsecs) / frames;
+        }
+    }
+}
+
+void Benchmarks::runRender(int frames)
+{
+    // 与进入游戏时一样先预载全部图片，计时中不含解码
+    AssetPreloader preloader;
+    preloader.finishNow();
+
+    {
+        SugarOilGameSceneNew scene;
+        ProfiledGraphicsView view(&scene);
+        view.setFixedSize(SUGAR_OIL_SCENE_WIDTH, SUGAR_OIL_SCENE_HEIGHT);
+        prepareRenderScene(scene, 300, 5000);
+        benchmarkProfiles("SugarOil", view, frames,
+                          [&scene](RenderProfile profile) { scene.applyRenderProfile(profile); },
+                          [&scene]() { stepRenderScene(scene); });
+    }
+
+    {
+        CarbohydrateGameScene scene;
+        CarbohydrateGameView view(&scene);
+        view.setFixedSize(GAME_SCENE_WIDTH, GAME_SCENE_HEIGHT);
+        benchmarkProfiles("Carbohydrate", view, frames,
+                          [&scene](RenderProfile profile) { scene.applyRenderProfile(profile); },
+                          [&scene]() { scene.update(); });
+    }
+}
+
+void Benchmarks::prepareRenderScene(SugarOilGameSceneNew &scene, int enemyCount, int bulletCount)
+{
+    scene.stopGame();
+    scene.clearEntities();
+
+    // 固定种子，每个档位看到的画面完全相同
+    scene.mRandom.seed(1);
+    scene.mTick = 0;
+    for (int i = 0; i < enemyCount; ++i) {
+        const QPointF position(scene.mRandom.bounded(Scene::SCENE_WIDTH), scene.mRandom.bounded(Scene::SCENE_HEIGHT));
+        scene.spawnEnemy(static_cast<EnemyBase::EnemyType>(i % EnemyBase::ENEMY_TYPE_COUNT), position)->stopAI();
+    }
+    for (int i = 0; i < bulletCount; ++i) {
+        const qreal angle = scene.mRandom.generateDouble() * 2.0 * M_PI;
+        scene.mEnemyBulletStore.spawn(static_cast<float>(scene.mRandom.bounded(Scene::SCENE_WIDTH)),
+                                      static_cast<float>(scene.mRandom.bounded(Scene::SCENE_HEIGHT)),
+                                      static_cast<float>(qCos(angle) * 0.05), static_cast<float>(qSin(angle) * 0.05), 1);
+    }
+    scene.publishRenderState();
+}
+
+void Benchmarks::stepRenderScene(SugarOilGameSceneNew &scene)
+{
+    // 敌人绕各自的圆心小幅转圈，子弹沿直线飞行，画面中每个图元每帧都在变化
+    const qreal phase = scene.mTick * 0.1;
+    for (int i = 0; i < scene.mEnemies.size(); ++i) {
+        scene.mEnemies[i]->moveBy(qCos(phase + i) * 2.0, qSin(phase + i) * 2.0);
+    }
+    scene.mEnemyBulletStore.integrate(Scene::UPDATE_INTERVAL, &scene.mJobs);
+    scene.publishRenderState();
+    ++scene.mTick;
+}
+
+bool Benchmarks::runAllocationCheck(SugarOilGameSceneNew &scene, int warmupTicks, int measuredTicks)
+{
+    if (!AllocTracker::isEnabled()) {
+        qDebug() << "Allocation check needs a build with CONFIG+=alloc_tracking";
+        return false;
+    }
+
+    // 脚本化输入写成录像：每秒换一次移动方向（KeyMask的低4位为W/S/A/D），
+    // 每8帧朝玩家周围转动的目标点射击一次
+    const int totalTicks = warmupTicks + measuredTicks;
+    const int directions = 4;
+    ReplayWriter script;
+    script.begin(ReplayWriter::SugarOil, 1);
+    for (int tick = 0; tick < totalTicks; ++tick) {
+        if (tick % 60 == 0) {
+            script.append({ tick, ReplayEvent::KeyMask, 1 << ((tick / 60) % directions), 0 });
+        }
+        if (tick % 8 == 0) {
+            const qreal angle = tick * 0.05;
+            script.append({ tick, ReplayEvent::MousePress,
+                            ReplayWriter::quantizeCoord(Scene::SCENE_WIDTH / 2 + qCos(angle) * 200.0),
+                            ReplayWriter::quantizeCoord(Scene::SCENE_HEIGHT / 2 + qSin(angle) * 200.0) });
+        }
+    }
+    script.finish(totalTicks + 1);
+
+    // 回放本身不存档，这里打开自动存档并写到临时目录，不碰玩家的存档
+    QTemporaryDir saveDir;
+    scene.mAutosavePath = saveDir.filePath("allocation_check.cnss");
+    if (!scene.startReplay(script.data())) {
+        scene.mAutosavePath = Scene::getAutosavePath();
+        return false;
+    }
+    scene.mUpdateTimer->stop();
+    scene.mAutosaveEnabled = true;
+
+    quint64 allocations = 0;
+    quint64 worstAllocations = 0;
+    qint64 worstTick = -1;
+    int measured = 0;
+    while (scene.mGameRunning && scene.mTick < totalTicks) {
+        // 玩家每帧回满血，保证整段都能跑完
+        scene.mPlayer->heal(scene.mPlayer->getMaxHP());
+        const qint64 tick = scene.mTick;
+        scene.updateGame();
+        if (tick < warmupTicks) {
+            continue;
+        }
+        ++measured;
+        allocations += scene.mLastTickAllocations;
+        if (scene.mLastTickAllocations > worstAllocations) {
+            worstAllocations = scene.mLastTickAllocations;
+            worstTick = tick;
+        }
+    }
+    scene.stopGame();
+    scene.mAutosaver.waitForPending();
+    scene.mAutosavePath = Scene::getAutosavePath();
+
+    const bool passed = measured == measuredTicks && allocations == 0;
+    qDebug() << "Allocation check -" << (passed ? "ok" : "FAIL")
+             << "Warm-up ticks:" << warmupTicks
+             << "Measured ticks:" << measured << "/" << measuredTicks
+             << "Heap allocations:" << allocations
+             << "Worst tick:" << worstTick << worstAllocations;
+    return passed;
+}
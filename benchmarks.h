@@ -0,0 +1,72 @@
+#ifndef BENCHMARKS_H
+#define BENCHMARKS_H
+
+#include <QtGlobal>
+#include <QVector>
+#include <QStringList>
+
+class QRandomGenerator;
+class SugarOilGameSceneNew;
+
+// 性能基准和堆分配回归检查，不随游戏本体编译：qmake CONFIG+=benchmarks（alloc_tracking隐含benchmarks）
+// 全部由命令行参数触发，运行完即退出：
+//   --bench-parallel [实体数] --bench-steering --bench-removal --bench-query --bench-nearest
+//   --bench-bullets --bench-waves --bench-render [帧数] --check-allocs
+// 基准作为SugarOilGameSceneNew的友元使用场景的常量和内部状态，游戏场景中不再保留基准代码
+class Benchmarks
+{
+public:
+    // 参数中有上面任一开关时运行对应基准并返回true，exitCode为main()应返回的值；没有时返回false
+    static bool dispatch(const QStringList &arguments, int &exitCode);
+
+private:
+    // 合成实体：在场景外扩ENEMY_GRID_MARGIN的范围内均匀撒点，附带随机速度和敌人类型
+    struct EnemyFixture {
+        QVector<float> x;
+        QVector<float> y;
+        QVector<float> speed;
+        QVector<quint8> group;
+    };
+    // 各基准共用同一份分布，random由调用方以固定种子创建，之后可继续用它生成查询点等数据
+    static EnemyFixture makeEnemyFixture(QRandomGenerator &random, int count);
+
+    // 并行模拟：合成entityCount个敌人和子弹，按1/2/4/8个线程分别运行转向流水线与子弹积分，
+    // 输出每帧耗时、加速比以及结果是否与单线程一致
+    static void runParallel(int entityCount);
+
+    // 转向：敌人数从100到10万，分别测SIMD追踪+积分、纯标量追踪+积分和带网格群体转向的整条流水线（单线程），
+    // 并输出SIMD与标量结果的最大偏差
+    static void runSteering();
+
+    // 删除：列表规模从500到5000，各随机删除一半，对比销毁队列+swap-and-pop与QList::removeOne的单次删除耗时
+    static void runRemoval();
+
+    // 查询：实体数从1000到2万，建一次索引后做512次200像素半径查询和一次整屏矩形查询，
+    // 与暴力遍历对比单次耗时，并核对两者命中的实体相同
+    static void runQuery();
+
+    // 最近邻：敌人数从100到1万，64个炮台位置各取最近的TURRET_TARGET_CANDIDATES个敌人，
+    // 对比网格逐圈搜索与暴力遍历的单次耗时，并核对两者找到的距离相同
+    static void runNearest();
+
+    // 敌人子弹：存量1000到1万颗，每帧用环形/螺旋弹幕补足后积分、剔除越界并与玩家碰撞，
+    // 分别用单线程和默认线程数运行300帧，输出每帧耗时、占16毫秒帧预算的比例以及结果是否与单线程一致
+    static void runBullets();
+
+    // 波次：用"固定开销+每个敌人开销"的帧耗时模型，按真实波次表模拟10分钟游戏时间，
+    // 对三种机器速度分别比较开启与关闭帧预算退避时的超预算帧比例、最慢帧、敌人峰值和advance()本身的耗时
+    static void runWaves();
+
+    // 绘制：两个模式的场景按三个档位各绘制frames帧（可配合QT_QPA_PLATFORM=offscreen使用）
+    static void runRender(int frames);
+    // 模式2不运行模拟，直接摆放enemyCount个敌人和bulletCount颗子弹，每调用一次stepRenderScene()让它们各移动一步
+    static void prepareRenderScene(SugarOilGameSceneNew &scene, int enemyCount, int bulletCount);
+    static void stepRenderScene(SugarOilGameSceneNew &scene);
+
+    // 堆分配回归检查（需以CONFIG+=alloc_tracking构建）：用固定种子和脚本化输入（移动、射击）
+    // 无界面运行一局，前warmupTicks帧让对象池、帧内存池和各缓冲区长到稳定大小，
+    // 之后measuredTicks帧（含自动存档）的堆分配必须为0，否则返回false。存档写到临时目录
+    static bool runAllocationCheck(SugarOilGameSceneNew &scene, int warmupTicks, int measuredTicks);
+};
+
+#endif // BENCHMARKS_H
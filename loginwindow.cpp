@@ -2,12 +2,15 @@
 #include <QApplication>
 #include <QScreen>
 #include <QDebug>
+#include "startup_trace.h"
 
 LoginWindow::LoginWindow(QWidget *parent)
     : QWidget(parent)
 {
     setupUI();
+    StartupTrace::mark("login_ui");
     setupDatabase();
+    StartupTrace::mark("login_database");
     applyStyles();
     
     // 设置窗口属性
@@ -20,6 +23,8 @@ LoginWindow::LoginWindow(QWidget *parent)
     int x = (screenGeometry.width() - width()) / 2;
     int y = (screenGeometry.height() - height()) / 2;
     move(x, y);
+    
+    StartupTrace::markFirstPaint(this, "login_first_paint");
 }
 
 LoginWindow::~LoginWindow()
@@ -74,6 +79,13 @@ void LoginWindow::setupUI()
     registerButton = new QPushButton("注册", this);
     registerButton->setObjectName("secondaryButton");
     
+    // 资源预载进度
+    preloadBar = new QProgressBar(this);
+    preloadBar->setObjectName("preloadBar");
+    preloadBar->setRange(0, 0);
+    preloadBar->setFormat("正在加载资源 %v/%m");
+    preloadBar->setAlignment(Qt::AlignCenter);
+    
     // 添加到表单布局
     formLayout->addWidget(usernameLabel);
     formLayout->addWidget(usernameEdit);
@@ -91,6 +103,7 @@ void LoginWindow::setupUI()
     mainLayout->addLayout(formLayout);
     mainLayout->addStretch();
     mainLayout->addLayout(buttonLayout);
+    mainLayout->addWidget(preloadBar);
     
     // 连接信号槽
     connect(loginButton, &QPushButton::clicked, this, &LoginWindow::onLoginClicked);
@@ -393,6 +406,15 @@ void LoginWindow::setupDatabase()
     }
 }
 
+void LoginWindow::setPreloadProgress(int loaded, int total)
+{
+    preloadBar->setRange(0, total);
+    preloadBar->setValue(loaded);
+    if (loaded >= total) {
+        preloadBar->hide();
+    }
+}
+
 void LoginWindow::onLoginClicked()
 {
     QString username = usernameEdit->text().trimmed();
@@ -601,5 +623,19 @@ void LoginWindow::applyStyles()
         "    background: qlineargradient(x1:0, y1:0, x2:0, y2:1, "
         "                                stop:0 #d0d0d0, stop:1 #c0c0c0);"
         "}"
+        
+        "#preloadBar {"
+        "    background: #f0f0f0;"
+        "    border: 1px solid #ccc;"
+        "    border-radius: 6px;"
+        "    height: 14px;"
+        "    font-size: 11px;"
+        "    color: #666;"
+        "}"
+        
+        "#preloadBar::chunk {"
+        "    background: #4a90e2;"
+        "    border-radius: 5px;"
+        "}"
     );
 }
\ No newline at end of file
@@ -6,6 +6,7 @@
 #include <QHBoxLayout>
 #include <QLabel>
 #include <QLineEdit>
+#include <QProgressBar>
 #include <QPushButton>
 #include <QMessageBox>
 #include <QSqlDatabase>
@@ -23,6 +24,7 @@ class QHBoxLayout;
 class QLabel;
 class QLineEdit;
 class QPushButton;
+class QProgressBar;
 QT_END_NAMESPACE
 
 class LoginWindow : public QWidget
@@ -33,6 +35,10 @@ public:
     LoginWindow(QWidget *parent = nullptr);
     ~LoginWindow();
 
+public slots:
+    // 资源预载进度，全部完成后隐藏进度条
+    void setPreloadProgress(int loaded, int total);
+
 private slots:
     void onLoginClicked();
     void onRegisterClicked();
@@ -59,6 +65,8 @@ private:
     QPushButton *loginButton;
     QPushButton *registerButton;
     
+    QProgressBar *preloadBar;
+    
     QSqlDatabase database;
 
 signals:
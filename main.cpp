@@ -1,18 +1,128 @@
 #include <QApplication>
+#include <QFile>
+#include <QDebug>
 #include "mainwindow.h"
+#include "replay_log.h"
+#include "render_profile.h"
+#include "asset_cache.h"
+#include "resource_bundle.h"
+#include "startup_trace.h"
+#ifdef CHIIKAWA_BENCHMARKS
+#include "benchmarks.h"
+#endif
+#include "mode1_carbohydrate_battle/carbohydrate_game_scene.h"
+#include "mode2_sugar_oil_battle/sugar_oil_game_scene_new.h"
+
+// 播放回放文件：支持无界面模式（--headless），模式2用作固定的性能回归负载，模式1用来检查回放是否逐帧一致
+static int runReplay(QApplication &app, const QString &path, bool headless)
+{
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly)) {
+        qDebug() << "Cannot open replay" << path;
+        return 1;
+    }
+    const QByteArray data = file.readAll();
+    
+    ReplayReader reader;
+    if (!reader.open(data)) {
+        qDebug() << "Invalid replay file" << path;
+        return 1;
+    }
+    
+    if (!headless) {
+        // 走与点击模式按钮相同的路径：主窗口预载并创建游戏窗口
+        MainWindow window;
+        window.playReplay(data, reader.getMode() == ReplayWriter::SugarOil);
+        return app.exec();
+    }
+    
+    // 无界面回放不经过主窗口，开始前一次性预载全部图片
+    AssetPreloader preloader;
+    preloader.finishNow();
+    if (reader.getMode() == ReplayWriter::SugarOil) {
+        SugarOilGameSceneNew scene;
+        return scene.runReplayHeadless(data) ? 0 : 1;
+    }
+    // 模式1逐个比对录像中的状态校验值，有分歧时返回非0
+    CarbohydrateGameScene scene;
+    return scene.runReplayHeadless(data) ? 0 : 1;
+}
+
+// --startup-trace时输出启动报告并检查预算，超出预算返回3
+// --startup-record-budgets <文件>：以--startup-budget给出的文件为模板，按本次实测耗时的1.5倍写出新预算
+static int finishStartupTrace(const QStringList &arguments, int result)
+{
+    if (!StartupTrace::isEnabled()) {
+        return result;
+    }
+    StartupTrace::printReport();
+    const int budgetIndex = arguments.indexOf("--startup-budget");
+    const int recordIndex = arguments.indexOf("--startup-record-budgets");
+    if (recordIndex >= 0 && recordIndex + 1 < arguments.size()) {
+        const QString templatePath = budgetIndex >= 0 && budgetIndex + 1 < arguments.size()
+            ? arguments.at(budgetIndex + 1) : QString("startup_budgets.json");
+        return StartupTrace::recordBudgets(templatePath, arguments.at(recordIndex + 1), 1.5) ? result : 3;
+    }
+    if (budgetIndex >= 0 && budgetIndex + 1 < arguments.size()
+        && !StartupTrace::checkBudgets(arguments.at(budgetIndex + 1))) {
+        return 3;
+    }
+    return result;
+}
 
 int main(int argc, char *argv[])
 {
+    StartupTrace::mark("main");
     QApplication a(argc, argv);
+    StartupTrace::mark("qapplication");
     
     // 设置应用程序信息
     a.setApplicationName("ちいかわ营养大冒险");
     a.setApplicationVersion("1.0");
     a.setOrganizationName("ChiikawaGame");
     
+    // 背景图和音频在外部资源包中，先于所有窗口和场景注册
+    ResourceBundle::registerExternal();
+    StartupTrace::mark("resource_bundle");
+    
+    // 启动追踪：--startup-trace [--startup-budget <文件>] [--startup-exit-after <打点名>]
+    const QStringList arguments = a.arguments();
+    StartupTrace::setEnabled(arguments.contains("--startup-trace"));
+    const int exitAfterIndex = arguments.indexOf("--startup-exit-after");
+    if (exitAfterIndex >= 0 && exitAfterIndex + 1 < arguments.size()) {
+        StartupTrace::setExitAfter(arguments.at(exitAfterIndex + 1));
+    }
+    
+    // 渲染档位：--render-profile quality|balanced|performance，需在创建窗口之前设置，回放和绘制基准同样适用
+    const int profileIndex = arguments.indexOf("--render-profile");
+    if (profileIndex >= 0 && profileIndex + 1 < arguments.size()) {
+        RenderProfile profile;
+        if (RenderProfiles::fromName(arguments.at(profileIndex + 1), profile)) {
+            RenderProfiles::setCurrent(profile);
+        } else {
+            qDebug() << "Unknown render profile" << arguments.at(profileIndex + 1) << "- using balanced";
+        }
+    }
+    
+    // 回放：--replay <文件> [--headless]
+    const int replayIndex = arguments.indexOf("--replay");
+    if (replayIndex >= 0 && replayIndex + 1 < arguments.size()) {
+        const int result = runReplay(a, arguments.at(replayIndex + 1), arguments.contains("--headless"));
+        return finishStartupTrace(arguments, result);
+    }
+    
+#ifdef CHIIKAWA_BENCHMARKS
+    // 性能基准和堆分配检查：--bench-*、--check-allocs，见benchmarks.h
+    int benchmarkResult = 0;
+    if (Benchmarks::dispatch(arguments, benchmarkResult)) {
+        return benchmarkResult;
+    }
+#endif
+    
     // 创建主窗口（会自动显示登录窗口）
     MainWindow w;
+    StartupTrace::mark("main_window");
     // 不在这里显示主窗口，由登录成功后显示
     
-    return a.exec();
+    return finishStartupTrace(arguments, a.exec());
 }
@@ -10,14 +10,20 @@
 #include <QCheckBox>
 #include <QLabel>
 #include <QPushButton>
+#include <QTimer>
+#include "startup_trace.h"
 
 MainWindow::MainWindow(QWidget *parent)
     : QMainWindow(parent)
     , ui(new Ui::MainWindow)
     , loginWindow(nullptr)
+    , assetPreloader(nullptr)
     , gameWidget(nullptr)
     , carbohydrateGameWindow(nullptr)
     , sugarOilGameWindow(nullptr)
+    , warmUpStep(-1)
+    , warmUpPaused(false)
+    , replayOnly(false)
 {
     ui->setupUi(this);
     
@@ -36,6 +42,12 @@ MainWindow::MainWindow(QWidget *parent)
     loginWindow = new LoginWindow(nullptr);
     connect(loginWindow, &LoginWindow::loginSuccessful, this, &MainWindow::onLoginSuccessful);
     
+    // 用户输入账号密码的同时预载图片资源，进入游戏时不再解码
+    assetPreloader = new AssetPreloader(this);
+    connect(assetPreloader, &AssetPreloader::progress, loginWindow, &LoginWindow::setPreloadProgress);
+    assetPreloader->start();
+    StartupTrace::mark("asset_preload_started");
+    
     // 隐藏主窗口，先显示登录窗口
     this->hide();
     loginWindow->show();
@@ -63,6 +75,104 @@ void MainWindow::onLoginSuccessful()
     
     // 开始播放背景音乐
     AudioManager::getInstance()->playBackgroundMusic();
+    
+    // 用户浏览主菜单时预先创建游戏窗口，点击模式后直接显示
+    warmUpGameWindows();
+}
+
+void MainWindow::warmUpGameWindows()
+{
+    if (warmUpStep >= 0) {
+        // 已经开始过，只在暂停后继续
+        if (warmUpPaused) {
+            warmUpPaused = false;
+            QTimer::singleShot(0, this, &MainWindow::warmUpNextStep);
+        }
+        return;
+    }
+    warmUpStep = 0;
+    
+    // 等图片预载完成后再创建，场景取图全部命中缓存
+    if (!assetPreloader->isFinished()) {
+        connect(assetPreloader, &AssetPreloader::finished, this, [this]() {
+            QTimer::singleShot(0, this, &MainWindow::warmUpNextStep);
+        }, Qt::SingleShotConnection);
+        return;
+    }
+    QTimer::singleShot(0, this, &MainWindow::warmUpNextStep);
+}
+
+void MainWindow::warmUpNextStep()
+{
+    // 游戏进行中不做预热，避免在对局里卡顿；回到主菜单时继续
+    if (!isVisible()) {
+        warmUpPaused = true;
+        return;
+    }
+    
+    // 每步之间回到事件循环处理输入和绘制；用户先点了某个模式时窗口已经存在，创建步骤直接跳过
+    switch (warmUpStep++) {
+    case 0:
+        createSugarOilGameWindow();
+        break;
+    case 1:
+        // 提前完成样式、布局和原生窗口的创建，show()时只剩绘制
+        sugarOilGameWindow->ensurePolished();
+        sugarOilGameWindow->layout()->activate();
+        sugarOilGameWindow->winId();
+        break;
+    case 2:
+        createCarbohydrateGameWindow();
+        break;
+    case 3:
+        carbohydrateGameWindow->ensurePolished();
+        carbohydrateGameWindow->layout()->activate();
+        carbohydrateGameWindow->winId();
+        break;
+    default:
+        StartupTrace::mark("game_windows_warm");
+        return;
+    }
+    QTimer::singleShot(0, this, &MainWindow::warmUpNextStep);
+}
+
+void MainWindow::playReplay(const QByteArray &data, bool sugarOil)
+{
+    replayOnly = true;
+    loginWindow->hide();
+    StartupTrace::mark("game_requested");
+    
+    // 与点击模式按钮相同：预载没完成时在这里补完，再创建游戏窗口
+    assetPreloader->finishNow();
+    if (sugarOil) {
+        createSugarOilGameWindow();
+        sugarOilGameWindow->show();
+        sugarOilGameWindow->startReplay(data);
+    } else {
+        createCarbohydrateGameWindow();
+        carbohydrateGameWindow->show();
+        carbohydrateGameWindow->startReplay(data);
+    }
+}
+
+void MainWindow::createCarbohydrateGameWindow()
+{
+    if (carbohydrateGameWindow) {
+        return;
+    }
+    carbohydrateGameWindow = new CarbohydrateGameWindow();
+    connect(carbohydrateGameWindow, &CarbohydrateGameWindow::gameWindowClosed,
+            this, &MainWindow::onCarbohydrateGameClosed);
+}
+
+void MainWindow::createSugarOilGameWindow()
+{
+    if (sugarOilGameWindow) {
+        return;
+    }
+    sugarOilGameWindow = new SugarOilGameWindow(this);
+    connect(sugarOilGameWindow, &SugarOilGameWindow::gameWindowClosed,
+            this, &MainWindow::onSugarOilGameClosed);
 }
 
 void MainWindow::setupGameUI()
@@ -487,24 +597,33 @@ void MainWindow::onLogoutClicked()
 
 void MainWindow::onCarbohydrateBattleClicked()
 {
+    StartupTrace::mark("game_requested");
+    
     // 停止背景音乐，播放模式1游戏音乐
     AudioManager::getInstance()->playGameMusic(AudioManager::MusicType::Mode1Game);
     
-    // 创建并显示碳水化合物之战游戏窗口
-    if (!carbohydrateGameWindow) {
-        carbohydrateGameWindow = new CarbohydrateGameWindow();
-        connect(carbohydrateGameWindow, &CarbohydrateGameWindow::gameWindowClosed,
-                this, &MainWindow::onCarbohydrateGameClosed);
-    }
+    // 预载没完成时在这里补完，游戏中不再解码图片
+    assetPreloader->finishNow();
+    
+    // 窗口通常已在空闲时预先创建，预热还没轮到时在这里创建
+    createCarbohydrateGameWindow();
     
     // 隐藏主窗口，显示游戏窗口
     this->hide();
     carbohydrateGameWindow->show();
-    carbohydrateGameWindow->startNewGame();
+    // 有未完成的对局时先询问是否继续
+    if (!carbohydrateGameWindow->continueSavedGame()) {
+        carbohydrateGameWindow->startNewGame();
+    }
 }
 
 void MainWindow::onCarbohydrateGameClosed()
 {
+    if (replayOnly) {
+        QApplication::quit();
+        return;
+    }
+    
     // 停止游戏音乐，恢复背景音乐
     AudioManager::getInstance()->playBackgroundMusic();
     
@@ -513,21 +632,22 @@ void MainWindow::onCarbohydrateGameClosed()
         carbohydrateGameWindow->hide();
     }
     this->show();
+    warmUpGameWindows();
 }
 
 void MainWindow::onSugarOilBattleClicked()
 {
     qDebug() << "模式2按钮被点击";
+    StartupTrace::mark("game_requested");
     
     // 停止背景音乐，播放模式2游戏音乐
     AudioManager::getInstance()->playGameMusic(AudioManager::MusicType::Mode2Game);
     
-    if (!sugarOilGameWindow) {
-        qDebug() << "创建新的SugarOilGameWindow";
-        sugarOilGameWindow = new SugarOilGameWindow(this);
-        connect(sugarOilGameWindow, &SugarOilGameWindow::gameWindowClosed,
-                this, &MainWindow::onSugarOilGameClosed);
-    }
+    // 预载没完成时在这里补完，游戏中不再解码图片
+    assetPreloader->finishNow();
+    
+    // 窗口通常已在空闲时预先创建，预热还没轮到时在这里创建
+    createSugarOilGameWindow();
     
     // 检查窗口是否已经可见，避免重复操作
     if (sugarOilGameWindow->isVisible()) {
@@ -548,14 +668,14 @@ void MainWindow::onSugarOilBattleClicked()
         sugarOilGameWindow->raise();
         sugarOilGameWindow->activateWindow();
         
-        // 只在必要时进行单次刷新
-        QApplication::processEvents();
-        
         qDebug() << "游戏窗口显示状态:" << sugarOilGameWindow->isVisible();
         qDebug() << "游戏窗口是否为活动窗口:" << sugarOilGameWindow->isActiveWindow();
         
-        qDebug() << "启动新游戏";
-        sugarOilGameWindow->startNewGame();
+        // 有未完成的对局时先询问是否继续
+        if (!sugarOilGameWindow->continueSavedGame()) {
+            qDebug() << "启动新游戏";
+            sugarOilGameWindow->startNewGame();
+        }
     } else {
         qDebug() << "错误：游戏窗口显示失败";
         this->show(); // 恢复主窗口显示
@@ -567,6 +687,11 @@ void MainWindow::onSugarOilBattleClicked()
 
 void MainWindow::onSugarOilGameClosed()
 {
+    if (replayOnly) {
+        QApplication::quit();
+        return;
+    }
+    
     // 停止游戏音乐，恢复背景音乐
     AudioManager::getInstance()->playBackgroundMusic();
     
@@ -576,6 +701,7 @@ void MainWindow::onSugarOilGameClosed()
     this->show();
     this->raise();
     this->activateWindow();
+    warmUpGameWindows();
 }
 
 void MainWindow::applyGameStyles()
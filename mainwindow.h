@@ -13,6 +13,7 @@
 #include "mode1_carbohydrate_battle/carbohydrate_game_window.h"
 #include "mode2_sugar_oil_battle/sugar_oil_game_window.h"
 #include "audio_manager.h"
+#include "asset_cache.h"
 
 QT_BEGIN_NAMESPACE
 namespace Ui {
@@ -27,6 +28,9 @@ class MainWindow : public QMainWindow
 public:
     MainWindow(QWidget *parent = nullptr);
     ~MainWindow();
+    
+    // 回放录像：跳过登录和主菜单，经与点击模式按钮相同的路径预载并创建游戏窗口
+    void playReplay(const QByteArray &data, bool sugarOil);
 
 private slots:
     void onLoginSuccessful();
@@ -39,12 +43,19 @@ private slots:
     void onSugarOilBattleClicked();
     void onSugarOilGameClosed();
 
+    void warmUpNextStep();
+
 private:
     void setupGameUI();
     void applyGameStyles();
+    // 登录后利用空闲时间预先创建两个游戏窗口，每次事件循环空闲时只做一步
+    void warmUpGameWindows();
+    void createCarbohydrateGameWindow();
+    void createSugarOilGameWindow();
     
     Ui::MainWindow *ui;
     LoginWindow *loginWindow;
+    AssetPreloader *assetPreloader; // 登录界面显示期间在后台解码全部图片
     QWidget *gameWidget;
     QHBoxLayout *gameLayout;
     QHBoxLayout *buttonLayout;
@@ -58,6 +69,9 @@ private:
     // 游戏窗口
     CarbohydrateGameWindow *carbohydrateGameWindow;
     SugarOilGameWindow *sugarOilGameWindow;
+    int warmUpStep; // 预热进行到第几步，-1为未开始
+    bool warmUpPaused; // 主窗口隐藏（游戏中或已登出）时暂停预热
+    bool replayOnly; // 回放启动时没有主菜单可回，游戏窗口关闭即退出
 };
 
 #endif // MAINWINDOW_H
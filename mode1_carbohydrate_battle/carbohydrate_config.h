@@ -26,6 +26,10 @@
 #define MOVEMENT_SPEED 4
 #define CARBOHYDRATE_COLLISION_DISTANCE 16
 
+// 游戏帧：玩家、BOSS、纤维剑和倒计时都由场景按帧推进，不再各自使用定时器，回放可逐帧重现
+#define GAME_TICK_MS 16
+#define TICKS_PER_SECOND (1000 / GAME_TICK_MS) // 倒计时每隔这么多帧减1秒
+
 // 游戏对象类型
 enum GameObjectType {
     TYPE_PLAYER = 1001,
@@ -4,7 +4,11 @@
 #include <QPen>
 #include <QFont>
 #include <QDebug>
+#include <QElapsedTimer>
 #include <QApplication>
+#include <QStandardPaths>
+#include <QFile>
+#include "../asset_cache.h"
 
 CarbohydrateGameScene::CarbohydrateGameScene(QObject *parent)
     : QGraphicsScene(parent)
@@ -13,6 +17,10 @@ CarbohydrateGameScene::CarbohydrateGameScene(QObject *parent)
     , boss(nullptr)
     , currentState(GAME_READY)
     , gameTimeRemaining(300) // 300秒游戏时间
+    , replaying(false)
+    , gameTick(0)
+    , replayHashChecks(0)
+    , replayHashMismatches(0)
     , fiberValueLabel(nullptr)
     , bossHealthBar(nullptr)
     , gameStatusLabel(nullptr)
@@ -20,27 +28,25 @@ CarbohydrateGameScene::CarbohydrateGameScene(QObject *parent)
     , pauseButton(nullptr)
     , resumeButton(nullptr)
     , uiWidget(nullptr)
-
+    , renderProfile(RenderProfiles::current())
 {
     // 设置场景大小
     setSceneRect(0, 0, GAME_SCENE_WIDTH, GAME_SCENE_HEIGHT);
     
     // 加载背景图片
-    backgroundPixmap = QPixmap(":/img/GameBackground.png");
+    backgroundPixmap = AssetCache::getInstance()->pixmap(":/img/GameBackground.png");
     if (backgroundPixmap.isNull()) {
         // 创建默认背景
         backgroundPixmap = QPixmap(GAME_SCENE_WIDTH, GAME_SCENE_HEIGHT);
         backgroundPixmap.fill(QColor(20, 20, 40));
     }
+    staticLayer.setBackground(backgroundPixmap);
     
-    // 创建游戏定时器
+    // 创建游戏定时器，倒计时也按游戏帧计算
     gameTimer = new QTimer(this);
+    gameTimer->setTimerType(Qt::PreciseTimer);
     connect(gameTimer, &QTimer::timeout, this, &CarbohydrateGameScene::updateGame);
     
-    // 创建倒计时定时器
-    countdownTimer = new QTimer(this);
-    connect(countdownTimer, &QTimer::timeout, this, &CarbohydrateGameScene::updateCountdown);
-    
     // 音频管理由AudioManager统一处理
     
     // 初始化游戏
@@ -91,6 +97,8 @@ void CarbohydrateGameScene::initializeGame()
     // 设置初始状态
     currentState = GAME_READY;
     updateUI();
+    
+    initialSnapshot = saveSnapshot();
 }
 
 void CarbohydrateGameScene::createUI()
@@ -207,6 +215,21 @@ void CarbohydrateGameScene::drawMap()
             }
         }
     }
+    
+    // 墙体不会移动，归入静态图层
+    QList<QGraphicsItem*> staticItems;
+    for (QGraphicsPixmapItem* item : wallItems) {
+        staticItems.append(item);
+    }
+    staticLayer.setItems(staticItems);
+    applyRenderProfile(renderProfile);
+}
+
+void CarbohydrateGameScene::applyRenderProfile(RenderProfile profile)
+{
+    renderProfile = profile;
+    staticLayer.apply(profile);
+    invalidate(sceneRect(), QGraphicsScene::BackgroundLayer);
 }
 
 void CarbohydrateGameScene::drawFakeVegetables()
@@ -245,13 +268,22 @@ void CarbohydrateGameScene::startGame()
         // 重置游戏时间（仅在新游戏开始时）
         if (currentState == GAME_READY) {
             gameTimeRemaining = 300;
+            gameTick = 0;
+            
+            // 新一局的随机数种子：回放时取录像中的种子，否则随机生成并开始录制
+            const quint32 seed = replaying ? replayReader.getSeed() : QRandomGenerator::global()->generate();
+            if (boss) {
+                boss->setRandomSeed(seed);
+            }
+            if (!replaying) {
+                replayWriter.begin(ReplayWriter::Carbohydrate, seed);
+                // 新的一局开始，旧的自动存档作废
+                discardAutosave();
+            }
         }
         
         currentState = GAME_RUNNING;
-        gameTimer->start(16); // 约60FPS
-        
-        // 启动倒计时定时器
-        countdownTimer->start(1000); // 每秒更新一次
+        gameTimer->start(GAME_TICK_MS);
         
         if (boss) {
             boss->startMovement();
@@ -264,19 +296,32 @@ void CarbohydrateGameScene::startGame()
     }
 }
 
+void CarbohydrateGameScene::resetGame()
+{
+    gameTimer->stop();
+    
+    if (boss) {
+        boss->stopMovement();
+    }
+    cleanupFiberSwords();
+    // 中途重开时按对局结束处理录像；回放则直接结束
+    finishReplay();
+    
+    if (!restoreSnapshot(initialSnapshot)) {
+        qDebug() << "Failed to reset carbohydrate scene";
+    }
+    
+    currentState = GAME_READY;
+    updateUI();
+    emit gameStateChanged(currentState);
+}
+
 void CarbohydrateGameScene::pauseGame()
 {
     if (currentState == GAME_RUNNING) {
         currentState = GAME_PAUSED;
+        // 玩家、BOSS和纤维剑只随游戏帧推进，停掉定时器就全部停住
         gameTimer->stop();
-        countdownTimer->stop();
-        
-        if (player) {
-            player->pauseAnimation();
-        }
-        if (boss) {
-            boss->pauseMovement();
-        }
         
         updateUI();
         emit gameStateChanged(currentState);
@@ -288,14 +333,6 @@ void CarbohydrateGameScene::resumeGame()
     if (currentState == GAME_PAUSED) {
         currentState = GAME_RUNNING;
         gameTimer->start();
-        countdownTimer->start();
-        
-        if (player) {
-            player->resumeAnimation();
-        }
-        if (boss) {
-            boss->resumeMovement();
-        }
         
         updateUI();
         emit gameStateChanged(currentState);
@@ -305,17 +342,19 @@ void CarbohydrateGameScene::resumeGame()
 void CarbohydrateGameScene::endGame(bool won)
 {
     gameTimer->stop();
-    countdownTimer->stop();
     
-    if (player) {
-        player->pauseAnimation();
-    }
     if (boss) {
         boss->stopMovement();
     }
     
     // 音乐由主窗口控制
     
+    // 对局结束，存档作废（回放不影响存档）
+    if (!replaying) {
+        discardAutosave();
+    }
+    finishReplay();
+    
     // 播放胜利/失败音乐和音效
     if (won) {
         AudioManager::getInstance()->playGameMusic(AudioManager::MusicType::Victory);
@@ -334,16 +373,51 @@ void CarbohydrateGameScene::updateGame()
         return;
     }
     
-    // 更新BOSS目标位置
+    // 回放时按帧注入录像中的按键
+    if (replaying) {
+        applyReplayInput();
+        if (currentState != GAME_RUNNING) {
+            return;
+        }
+    }
+    gameTick++;
+    
+    // 所有模拟都在这里按固定顺序推进：玩家、BOSS、纤维剑、碰撞、倒计时
+    if (player) {
+        player->advanceTick();
+    }
     if (boss && player) {
         boss->setTargetPosition(player->getCurrentCell());
+        boss->advanceTick();
+    }
+    // 纤维剑命中或飞完时会从列表中移除，遍历副本；已停下的剑不再推进
+    const QList<FiberSword*> swords = fiberSwords;
+    for (FiberSword* sword : swords) {
+        sword->advanceTick();
+        if (currentState != GAME_RUNNING) {
+            return;
+        }
     }
     
     // 检查碰撞
     checkCollisions();
+    if (currentState != GAME_RUNNING) {
+        return;
+    }
+    
+    if (gameTick % TICKS_PER_SECOND == 0) {
+        updateCountdown();
+        if (currentState != GAME_RUNNING) {
+            return;
+        }
+    }
     
     // 更新假蔬菜显示
     drawFakeVegetables();
+    
+    if (!replaying && gameTick % STATE_HASH_INTERVAL == 0) {
+        replayWriter.append({ gameTick, ReplayEvent::StateHash, static_cast<qint32>(stateHash()), 0 });
+    }
 }
 
 void CarbohydrateGameScene::updateCountdown()
@@ -353,7 +427,22 @@ void CarbohydrateGameScene::updateCountdown()
     }
     
     gameTimeRemaining--;
+    updateTimeLabel();
+    
+    // 检查是否时间到达胜利条件
+    if (gameTimeRemaining <= 0) {
+        onTimeUp();
+        return;
+    }
     
+    // 定期自动存档：快照很小，在这里生成，写盘交给后台线程
+    if (!replaying && gameTimeRemaining % AUTOSAVE_INTERVAL_SECONDS == 0) {
+        autosaver.saveAsync(getAutosavePath(), saveSnapshot());
+    }
+}
+
+void CarbohydrateGameScene::updateTimeLabel()
+{
     // 更新时间显示
     if (timeLabel) {
         int minutes = gameTimeRemaining / 60;
@@ -368,11 +457,6 @@ void CarbohydrateGameScene::updateCountdown()
             timeLabel->setStyleSheet("color: orange; font-size: 14px; font-weight: bold;");
         }
     }
-    
-    // 检查是否时间到达胜利条件
-    if (gameTimeRemaining <= 0) {
-        onTimeUp();
-    }
 }
 
 void CarbohydrateGameScene::onTimeUp()
@@ -588,15 +672,16 @@ void CarbohydrateGameScene::cleanupFiberSwords()
 
 void CarbohydrateGameScene::drawBackground(QPainter *painter, const QRectF &rect)
 {
-    painter->drawPixmap(rect.toRect(), backgroundPixmap, rect.toRect());
+    staticLayer.draw(painter, rect);
 }
 
 void CarbohydrateGameScene::handleKeyPress(QKeyEvent *event)
 {
-    if (currentState != GAME_RUNNING) {
+    if (currentState != GAME_RUNNING || replaying) {
         return;
     }
     
+    replayWriter.append({ gameTick, ReplayEvent::KeyEvent, event->key(), 1 });
     if (player) {
         player->handleKeyPress(event->key());
     }
@@ -604,15 +689,249 @@ void CarbohydrateGameScene::handleKeyPress(QKeyEvent *event)
 
 void CarbohydrateGameScene::handleKeyRelease(QKeyEvent *event)
 {
-    if (currentState != GAME_RUNNING) {
+    if (currentState != GAME_RUNNING || replaying) {
         return;
     }
     
+    replayWriter.append({ gameTick, ReplayEvent::KeyEvent, event->key(), 0 });
     if (player) {
         player->handleKeyRelease(event->key());
     }
 }
 
+QString CarbohydrateGameScene::getLastReplayPath()
+{
+    return QStandardPaths::writableLocation(QStandardPaths::AppLocalDataLocation)
+           + "/replays/last_carbohydrate.cnrp";
+}
+
+bool CarbohydrateGameScene::startReplay(const QByteArray &data)
+{
+    if (currentState != GAME_READY) {
+        return false;
+    }
+    if (!replayReader.open(data) || replayReader.getMode() != ReplayWriter::Carbohydrate) {
+        replayReader.close();
+        qDebug() << "Invalid carbohydrate replay";
+        return false;
+    }
+    
+    replaying = true;
+    replayHashChecks = 0;
+    replayHashMismatches = 0;
+    startGame();
+    return true;
+}
+
+bool CarbohydrateGameScene::runReplayHeadless(const QByteArray &data)
+{
+    if (!startReplay(data)) {
+        return false;
+    }
+    
+    // 不等待定时器，连续推进到录像结束或游戏结束
+    gameTimer->stop();
+    QElapsedTimer replayTimer;
+    replayTimer.start();
+    while (replaying && currentState == GAME_RUNNING) {
+        updateGame();
+    }
+    qDebug() << "Headless replay - Ticks:" << gameTick
+             << "Total ms:" << replayTimer.elapsed()
+             << "Hashes checked:" << replayHashChecks
+             << "Mismatches:" << replayHashMismatches;
+    return replayHashMismatches == 0;
+}
+
+namespace
+{
+    const quint32 SNAPSHOT_TAG = 0x54533143; // "C1ST"
+    
+    // 场景自身的计时
+    struct SavedScene {
+        qint64 gameTick;
+        qint32 gameTimeRemaining;
+        qint32 reserved;
+    };
+}
+
+QString CarbohydrateGameScene::getAutosavePath()
+{
+    return QStandardPaths::writableLocation(QStandardPaths::AppLocalDataLocation)
+           + "/saves/carbohydrate.cnss";
+}
+
+bool CarbohydrateGameScene::hasAutosave()
+{
+    return QFile::exists(getAutosavePath());
+}
+
+QByteArray CarbohydrateGameScene::saveSnapshot() const
+{
+    SnapshotWriter writer;
+    writer.begin(SnapshotWriter::Carbohydrate, 256);
+    writer.beginSection(SNAPSHOT_TAG);
+    writer.write(SavedScene{ gameTick, gameTimeRemaining, 0 });
+    gameMap->saveState(writer);
+    writer.write(player->saveState());
+    writer.write(boss->saveState());
+    return writer.data();
+}
+
+bool CarbohydrateGameScene::restoreSnapshot(const QByteArray &data)
+{
+    if (!gameMap || !player || !boss) {
+        return false;
+    }
+    
+    SnapshotReader reader;
+    SavedScene scene = {};
+    Player::SavedState playerState = {};
+    FakeVegetableBoss::SavedState bossState = {};
+    QVector<quint64> mapWords;
+    if (!reader.open(data, SnapshotWriter::Carbohydrate)) {
+        return false;
+    }
+    reader.expectSection(SNAPSHOT_TAG);
+    reader.read(scene);
+    // 全部先读进临时变量，整份快照校验通过后才写入地图和角色，失败时场景保持原状
+    const bool mapOk = GameMap::readState(reader, mapWords);
+    reader.read(playerState);
+    reader.read(bossState);
+    if (!mapOk || !reader.isOk() || !reader.atEnd()) {
+        qDebug() << "Invalid carbohydrate snapshot";
+        return false;
+    }
+    
+    gameMap->restoreState(mapWords);
+    drawFakeVegetables();
+    player->restoreState(playerState);
+    boss->restoreState(bossState);
+    gameTimeRemaining = qMax(1, scene.gameTimeRemaining);
+    gameTick = qMax<qint64>(0, scene.gameTick);
+    updateTimeLabel();
+    return true;
+}
+
+bool CarbohydrateGameScene::continueFromSnapshot(const QByteArray &data)
+{
+    if (currentState != GAME_READY || replaying || !restoreSnapshot(data)) {
+        return false;
+    }
+    
+    // 按暂停状态进入startGame()，跳过新一局的初始化（倒计时、种子、录像）；读档后的对局不录像
+    currentState = GAME_PAUSED;
+    startGame();
+    return true;
+}
+
+bool CarbohydrateGameScene::continueFromAutosave()
+{
+    QFile file(getAutosavePath());
+    if (!file.open(QIODevice::ReadOnly)) {
+        return false;
+    }
+    return continueFromSnapshot(file.readAll());
+}
+
+bool CarbohydrateGameScene::saveAutosaveNow()
+{
+    if ((currentState != GAME_RUNNING && currentState != GAME_PAUSED) || replaying) {
+        return false;
+    }
+    // 等后台的写盘结束，避免旧快照覆盖这一份
+    autosaver.waitForPending();
+    return SnapshotWriter::saveToFile(getAutosavePath(), saveSnapshot());
+}
+
+void CarbohydrateGameScene::discardAutosave()
+{
+    autosaver.waitForPending();
+    QFile::remove(getAutosavePath());
+}
+
+void CarbohydrateGameScene::applyReplayInput()
+{
+    while (replayReader.hasEventAt(gameTick)) {
+        const ReplayEvent replayEvent = replayReader.takeEvent();
+        if (replayEvent.kind == ReplayEvent::StateHash) {
+            checkStateHash(replayEvent);
+            continue;
+        }
+        if (replayEvent.kind != ReplayEvent::KeyEvent || !player) {
+            continue;
+        }
+        if (replayEvent.b) {
+            player->handleKeyPress(replayEvent.a);
+        } else {
+            player->handleKeyRelease(replayEvent.a);
+        }
+    }
+    
+    // 录像播完后把操作交还给玩家
+    if (replayReader.isFinished() && gameTick >= replayReader.getEndTick()) {
+        qDebug() << "Replay finished at tick" << gameTick;
+        finishReplay();
+    }
+}
+
+void CarbohydrateGameScene::finishReplay()
+{
+    if (replaying) {
+        // 对局在录像结束前分出胜负时，读完同一帧记下的校验值
+        while (replayReader.hasEventAt(gameTick)) {
+            const ReplayEvent replayEvent = replayReader.takeEvent();
+            if (replayEvent.kind == ReplayEvent::StateHash) {
+                checkStateHash(replayEvent);
+            }
+        }
+        qDebug() << "Replay check - Hashes:" << replayHashChecks << "Mismatches:" << replayHashMismatches;
+        replaying = false;
+        replayReader.close();
+    } else if (replayWriter.isRecording()) {
+        replayWriter.append({ gameTick, ReplayEvent::StateHash, static_cast<qint32>(stateHash()), 0 });
+        replayWriter.finish(gameTick);
+        if (gameTick > 0 && !replayWriter.saveToFile(getLastReplayPath())) {
+            qDebug() << "Failed to save replay to" << getLastReplayPath();
+        }
+    }
+}
+
+quint32 CarbohydrateGameScene::stateHash() const
+{
+    // 快照包含地图、玩家、BOSS的格子和倒计时；再加上BOSS的插值位置和飞行中的纤维剑
+    QByteArray state = saveSnapshot();
+    auto appendPoint = [&state](const QPointF &point) {
+        const qreal values[2] = { point.x(), point.y() };
+        state.append(reinterpret_cast<const char*>(values), sizeof(values));
+    };
+    appendPoint(boss->pos());
+    for (const FiberSword* sword : fiberSwords) {
+        appendPoint(sword->pos());
+    }
+    
+    quint32 hash = 2166136261u;
+    for (const char byte : state) {
+        hash = (hash ^ static_cast<quint8>(byte)) * 16777619u;
+    }
+    return hash;
+}
+
+void CarbohydrateGameScene::checkStateHash(const ReplayEvent &event)
+{
+    ++replayHashChecks;
+    const quint32 expected = static_cast<quint32>(event.a);
+    const quint32 actual = stateHash();
+    if (actual != expected) {
+        // 只报第一次分歧，之后的状态都会跟着不同
+        if (replayHashMismatches == 0) {
+            qDebug() << "Replay diverged at tick" << gameTick
+                     << "expected" << QString::number(expected, 16) << "got" << QString::number(actual, 16);
+        }
+        ++replayHashMismatches;
+    }
+}
+
 void CarbohydrateGameScene::keyPressEvent(QKeyEvent *event)
 {
     if (currentState == GAME_READY) {
@@ -632,9 +951,9 @@ void CarbohydrateGameScene::keyReleaseEvent(QKeyEvent *event)
 
 // CarbohydrateGameView 实现
 CarbohydrateGameView::CarbohydrateGameView(CarbohydrateGameScene* scene, QWidget *parent)
-    : QGraphicsView(scene, parent), gameScene(scene)
+    : ProfiledGraphicsView(scene, parent), gameScene(scene)
 {
-    setRenderHint(QPainter::Antialiasing);
+    RenderProfiles::apply(this, RenderProfiles::current());
     setDragMode(QGraphicsView::NoDrag);
     setHorizontalScrollBarPolicy(Qt::ScrollBarAlwaysOff);
     setVerticalScrollBarPolicy(Qt::ScrollBarAlwaysOff);
@@ -12,6 +12,9 @@
 #include <QPushButton>
 #include <QGraphicsProxyWidget>
 #include "../audio_manager.h"
+#include "../replay_log.h"
+#include "../snapshot_io.h"
+#include "../render_profile.h"
 #include "carbohydrate_config.h"
 #include "game_map.h"
 #include "player.h"
@@ -31,12 +34,35 @@ public:
     void pauseGame();
     void resumeGame();
     void endGame(bool won);
+    // 回到未开始的状态，供下一局复用场景：墙体、背景和界面保留，地图、玩家和BOSS按开局快照恢复
     void resetGame();
     
     // 键盘事件处理
     void handleKeyPress(QKeyEvent *event);
     void handleKeyRelease(QKeyEvent *event);
     
+    // 回放：每局记录随机数种子和按键事件，结束时保存到本地数据目录
+    // 只能在未开始的场景上开始回放；玩家、BOSS、纤维剑和倒计时都只在updateGame()中按帧推进，
+    // 按键在同一帧注入时结果逐位一致。录制时每秒和结束时记一次状态校验值，回放时逐个比对
+    bool startReplay(const QByteArray &data);
+    // 不等待定时器连续推进到录像结束，校验值全部一致时返回true
+    bool runReplayHeadless(const QByteArray &data);
+    bool isReplaying() const { return replaying; }
+    static QString getLastReplayPath();
+    
+    // 存档：地图、玩家、BOSS和倒计时写成一份二进制快照，游戏中每隔一段时间在后台自动存档。
+    // 只能在未开始的场景上读档，读档后直接继续；飞行中的纤维剑不保存
+    QByteArray saveSnapshot() const;
+    bool continueFromSnapshot(const QByteArray &data);
+    bool continueFromAutosave();
+    bool saveAutosaveNow();
+    void discardAutosave();
+    static QString getAutosavePath();
+    static bool hasAutosave();
+    
+    // 渲染档位：墙体属于静态图层，重绘地图时按当前档位重新合成
+    void applyRenderProfile(RenderProfile profile);
+    
     // 游戏状态
     GameState getCurrentState() const { return currentState; }
     bool isGameRunning() const { return currentState == GAME_RUNNING; }
@@ -59,7 +85,6 @@ signals:
     
 private slots:
     void updateGame();
-    void updateCountdown();
     void onFiberSwordUsed(QPointF position, Direction direction);
     void onFiberSwordHit(QGraphicsItem* target);
     void onFiberSwordDestroyed();
@@ -74,12 +99,21 @@ private slots:
     
 private:
     void initializeGame();
+    void updateCountdown();
     void createUI();
     void updateUI();
     void drawMap();
     void drawFakeVegetables();
     void checkCollisions();
     void cleanupFiberSwords();
+    void applyReplayInput();
+    void finishReplay();
+    // 地图、玩家、BOSS、倒计时和飞行中纤维剑的校验值（FNV-1a）
+    quint32 stateHash() const;
+    void checkStateHash(const ReplayEvent &event);
+    void updateTimeLabel();
+    // 写入快照中的地图、玩家、BOSS和倒计时，不改变游戏状态
+    bool restoreSnapshot(const QByteArray &data);
     
     // 游戏对象
     GameMap* gameMap;
@@ -89,10 +123,23 @@ private:
     
     // 游戏状态
     GameState currentState;
-    QTimer* gameTimer;
-    QTimer* countdownTimer;
+    QTimer* gameTimer; // 每次触发推进一个游戏帧（GAME_TICK_MS）
     int gameTimeRemaining; // 剩余游戏时间（秒）
     
+    // 回放
+    ReplayWriter replayWriter;
+    ReplayReader replayReader;
+    bool replaying;
+    qint64 gameTick; // 本局已执行的游戏帧数，按键事件按它对齐
+    int replayHashChecks;
+    int replayHashMismatches;
+    static const int STATE_HASH_INTERVAL = TICKS_PER_SECOND;
+    
+    // 存档
+    SnapshotAutosaver autosaver;
+    QByteArray initialSnapshot; // 开局时的快照，resetGame()据此恢复
+    static const int AUTOSAVE_INTERVAL_SECONDS = 15;
+    
     // UI元素
     QLabel* fiberValueLabel;
     QProgressBar* bossHealthBar;
@@ -106,14 +153,16 @@ private:
     QList<QGraphicsPixmapItem*> wallItems;
     QList<QGraphicsPixmapItem*> fakeVegetableItems;
     
-    // 背景
+    // 背景图和墙体
     QPixmap backgroundPixmap;
+    StaticLayer staticLayer;
+    RenderProfile renderProfile;
     
     // 音频管理器引用（使用单例）
     // AudioManager* audioManager; // 通过AudioManager::getInstance()获取
 };
 
-class CarbohydrateGameView : public QGraphicsView
+class CarbohydrateGameView : public ProfiledGraphicsView
 {
     Q_OBJECT
     
@@ -1,5 +1,6 @@
 #include "carbohydrate_game_window.h"
 #include "../audio_manager.h"
+#include "../startup_trace.h"
 #include <QApplication>
 #include <QCloseEvent>
 #include <QFont>
@@ -18,12 +19,7 @@ CarbohydrateGameWindow::CarbohydrateGameWindow(QWidget *parent)
     
     setupUI();
     
-    // 创建营养知识答题窗口（独立窗口）
-    quizWindow = new NutritionQuizWindow(nullptr);
-    connect(quizWindow, &NutritionQuizWindow::quizCompleted, this, &CarbohydrateGameWindow::onQuizCompleted);
-    connect(quizWindow, &NutritionQuizWindow::backToMenu, this, &CarbohydrateGameWindow::onBackToMenu);
-    
-    startNewGame();
+    // 窗口由主窗口在空闲时预先创建，对局在startNewGame()/continueSavedGame()时才开始
 }
 
 CarbohydrateGameWindow::~CarbohydrateGameWindow()
@@ -76,6 +72,7 @@ void CarbohydrateGameWindow::setupGameArea()
     // 创建游戏场景和视图
     gameScene = new CarbohydrateGameScene(this);
     gameView = new CarbohydrateGameView(gameScene, this);
+    StartupTrace::markFirstPaint(gameView->viewport(), "game_first_frame");
     
     // 连接游戏信号
     connect(gameScene, &CarbohydrateGameScene::gameWon, this, &CarbohydrateGameWindow::onGameWon);
@@ -162,6 +159,10 @@ void CarbohydrateGameWindow::setupControlPanel()
 void CarbohydrateGameWindow::startNewGame()
 {
     if (gameScene) {
+        // 复用场景，上一局留下的状态就地复位
+        if (gameScene->getCurrentState() != GAME_READY) {
+            gameScene->resetGame();
+        }
         gameInProgress = true;
         updateControlPanel();
         
@@ -172,6 +173,43 @@ void CarbohydrateGameWindow::startNewGame()
     }
 }
 
+bool CarbohydrateGameWindow::continueSavedGame()
+{
+    if (!CarbohydrateGameScene::hasAutosave()) {
+        return false;
+    }
+    
+    int ret = QMessageBox::question(this, "继续游戏",
+                                    "发现上次未完成的对局，是否继续？",
+                                    QMessageBox::Yes | QMessageBox::No,
+                                    QMessageBox::Yes);
+    
+    // 读档和新开一局都从未开始的场景出发
+    if (gameScene->getCurrentState() != GAME_READY) {
+        gameScene->resetGame();
+    }
+    if (ret != QMessageBox::Yes) {
+        gameScene->discardAutosave();
+        return false;
+    }
+    startNewGame();
+    
+    if (!gameScene->continueFromAutosave()) {
+        QMessageBox::warning(this, "继续游戏", "存档无法读取，将开始新的一局。");
+        gameScene->discardAutosave();
+        return false;
+    }
+    return true;
+}
+
+void CarbohydrateGameWindow::startReplay(const QByteArray &data)
+{
+    startNewGame();
+    if (gameScene) {
+        gameScene->startReplay(data);
+    }
+}
+
 void CarbohydrateGameWindow::showGameInstructions()
 {
     QMessageBox::information(this, "游戏说明",
@@ -269,7 +307,7 @@ void CarbohydrateGameWindow::showGameResult(bool won)
         // 检查用户点击了哪个按钮
         if (msgBox.clickedButton() == handbookButton) {
             // 直接打开营养知识宝典
-            if (quizWindow) {
+            if (ensureQuizWindow()) {
                 // 先加载数据
                 if (!quizWindow->loadKnowledgeFromDatabase() || !quizWindow->loadQuestionsFromDatabase()) {
                     QMessageBox::warning(this, "错误", "无法加载营养知识数据，请检查数据库连接。");
@@ -308,6 +346,12 @@ void CarbohydrateGameWindow::keyReleaseEvent(QKeyEvent *event)
 
 void CarbohydrateGameWindow::closeEvent(QCloseEvent *event)
 {
+    // 对局进行中时同步存档并暂停，下次进入可以继续
+    if (gameScene && !gameScene->isReplaying()) {
+        gameScene->saveAutosaveNow();
+        gameScene->pauseGame();
+    }
+    
     // 停止背景音乐
     AudioManager::getInstance()->stopCurrentMusic();
     
@@ -326,7 +370,7 @@ void CarbohydrateGameWindow::onGameLost()
     gameInProgress = false;
     
     // 显示营养知识答题界面
-    if (quizWindow) {
+    if (ensureQuizWindow()) {
         quizWindow->startQuiz();
     } else {
         // 备用方案：如果答题窗口创建失败，显示原来的结果
@@ -350,17 +394,20 @@ void CarbohydrateGameWindow::onBackButtonClicked()
 
 void CarbohydrateGameWindow::onRestartButtonClicked()
 {
-    // 重新创建游戏场景
-    if (gameScene) {
-        gameLayout->removeWidget(gameView);
-        delete gameView;
-        delete gameScene;
-    }
-    
-    setupGameArea();
     startNewGame();
 }
 
+NutritionQuizWindow* CarbohydrateGameWindow::ensureQuizWindow()
+{
+    // 答题窗口会读取数据库，推迟到第一次答题或查看宝典时再创建（独立窗口）
+    if (!quizWindow) {
+        quizWindow = new NutritionQuizWindow(nullptr);
+        connect(quizWindow, &NutritionQuizWindow::quizCompleted, this, &CarbohydrateGameWindow::onQuizCompleted);
+        connect(quizWindow, &NutritionQuizWindow::backToMenu, this, &CarbohydrateGameWindow::onBackToMenu);
+    }
+    return quizWindow;
+}
+
 void CarbohydrateGameWindow::onInstructionsButtonClicked()
 {
     showGameInstructions();
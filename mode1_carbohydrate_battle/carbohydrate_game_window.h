@@ -22,6 +22,9 @@ public:
     
     // 游戏控制
     void startNewGame();
+    // 有未完成的对局时询问是否继续，继续成功返回true
+    bool continueSavedGame();
+    void startReplay(const QByteArray &data);
     void showGameInstructions();
     
 protected:
@@ -49,6 +52,7 @@ private:
     void setupControlPanel();
     void updateControlPanel();
     void showGameResult(bool won);
+    NutritionQuizWindow* ensureQuizWindow();
     
     // UI组件
     QVBoxLayout* mainLayout;
@@ -69,7 +73,7 @@ private:
     // 游戏状态
     bool gameInProgress;
     
-    // 答题界面
+    // 答题界面，第一次用到时才创建
     NutritionQuizWindow* quizWindow;
 };
 
@@ -3,38 +3,29 @@
 #include <QRandomGenerator>
 #include <QDebug>
 #include <QtMath>
+#include "../asset_cache.h"
 
 FakeVegetableBoss::FakeVegetableBoss(GameMap* gameMap, QObject *parent)
     : QObject(parent), QGraphicsPixmapItem()
     , map(gameMap)
     , health(BOSS_HEALTH), maxHealth(BOSS_HEALTH)
     , currentRow(10), currentCol(6) // BOSS起始位置
+    , aiActive(false)
+    , aiTicks(0)
     , isMoving(false)
     , currentDirection(DIR_RIGHT)
+    , moveTicks(0)
     , currentFrame(0)
+    , animationTicks(0)
     , pathIndex(0)
+    , randomSeed(0)
+    , aiStep(0)
 {
     // 加载精灵图片
     loadSprites();
     
     // 设置初始位置
     setPosition(currentRow, currentCol);
-    
-    // 创建定时器
-    aiTimer = new QTimer(this);
-    animationTimer = new QTimer(this);
-    moveAnimation = new QPropertyAnimation(this, "pos");
-    
-    connect(aiTimer, &QTimer::timeout, this, &FakeVegetableBoss::updateAI);
-    connect(animationTimer, &QTimer::timeout, this, &FakeVegetableBoss::updateAnimation);
-    connect(moveAnimation, &QPropertyAnimation::finished, this, &FakeVegetableBoss::onMovementFinished);
-    
-    // 设置动画属性
-    moveAnimation->setDuration(200); // 移动动画持续时间
-    moveAnimation->setEasingCurve(QEasingCurve::Linear);
-    
-    // 启动定时器
-    animationTimer->start(300); // 动画帧切换间隔
 }
 
 FakeVegetableBoss::~FakeVegetableBoss()
@@ -43,9 +34,9 @@ FakeVegetableBoss::~FakeVegetableBoss()
 
 void FakeVegetableBoss::loadSprites()
 {
-    // 使用项目中的敌人图片资源
-    QPixmap chimeraSprite(":/img/roles/chimera1.png");
-    QPixmap chimeraMirSprite(":/img/roles/chimera1-mir.png");
+    // 使用项目中的敌人图片资源，缩放到合适大小
+    const QPixmap chimeraSprite = AssetCache::getInstance()->scaledPixmap(":/img/roles/chimera1.png", ENEMY_SIZE);
+    const QPixmap chimeraMirSprite = AssetCache::getInstance()->scaledPixmap(":/img/roles/chimera1-mir.png", ENEMY_SIZE);
     
     if (chimeraSprite.isNull() || chimeraMirSprite.isNull()) {
         // 如果资源加载失败，创建简单的彩色方块作为替代
@@ -58,10 +49,6 @@ void FakeVegetableBoss::loadSprites()
             }
         }
     } else {
-        // 缩放图片到合适大小
-        chimeraSprite = chimeraSprite.scaled(ENEMY_SIZE, ENEMY_SIZE, Qt::KeepAspectRatio, Qt::SmoothTransformation);
-        chimeraMirSprite = chimeraMirSprite.scaled(ENEMY_SIZE, ENEMY_SIZE, Qt::KeepAspectRatio, Qt::SmoothTransformation);
-        
         // 为不同方向设置精灵
         for (int frame = 0; frame < 2; ++frame) {
             sprites[DIR_LEFT][frame] = chimeraMirSprite;
@@ -96,29 +83,35 @@ void FakeVegetableBoss::takeDamage(int damage)
 
 void FakeVegetableBoss::startMovement()
 {
-    aiTimer->start(500); // AI更新间隔
+    aiActive = true;
+    aiTicks = 0;
 }
 
 void FakeVegetableBoss::stopMovement()
 {
-    aiTimer->stop();
-    moveAnimation->stop();
+    aiActive = false;
     isMoving = false;
 }
 
-void FakeVegetableBoss::pauseMovement()
-{
-    aiTimer->stop();
-    animationTimer->stop();
-    moveAnimation->pause();
-}
-
-void FakeVegetableBoss::resumeMovement()
+void FakeVegetableBoss::advanceTick()
 {
-    if (isAlive()) {
-        aiTimer->start();
-        animationTimer->start();
-        moveAnimation->resume();
+    if (isMoving) {
+        ++moveTicks;
+        setPos(moveFrom + (moveTo - moveFrom) * (static_cast<qreal>(moveTicks) / MOVE_TICKS));
+        if (moveTicks >= MOVE_TICKS) {
+            isMoving = false;
+        }
+    }
+    
+    // 与原来的500毫秒AI定时器相同：开始移动后每隔AI_INTERVAL_TICKS帧决策一次
+    if (aiActive && ++aiTicks >= AI_INTERVAL_TICKS) {
+        aiTicks = 0;
+        updateAI();
+    }
+    
+    if (++animationTicks >= ANIMATION_TICKS) {
+        animationTicks = 0;
+        updateAnimation();
     }
 }
 
@@ -138,6 +131,28 @@ void FakeVegetableBoss::setPosition(int row, int col)
     }
 }
 
+FakeVegetableBoss::SavedState FakeVegetableBoss::saveState() const
+{
+    // 移动开始时逻辑格子已经更新，动画只影响显示位置
+    return { currentRow, currentCol, health, currentDirection, randomSeed, aiStep };
+}
+
+void FakeVegetableBoss::restoreState(const SavedState &state)
+{
+    isMoving = false;
+    moveTicks = 0;
+    pathToPlayer.clear();
+    pathIndex = 0;
+    
+    currentDirection = static_cast<Direction>(qBound<int>(DIR_LEFT, state.direction, DIR_DOWN));
+    setPosition(state.row, state.col);
+    randomSeed = state.randomSeed;
+    aiStep = state.aiStep;
+    health = qBound(0, state.health, maxHealth);
+    updatePixmap();
+    emit healthChanged(health);
+}
+
 void FakeVegetableBoss::setTargetPosition(QPoint playerCell)
 {
     targetCell = playerCell;
@@ -149,6 +164,8 @@ void FakeVegetableBoss::updateAI()
         return;
     }
     
+    randomGenerator.seed(randomSeed ^ (++aiStep * 0x9E3779B9u));
+    
     // 智能AI逻辑：根据与玩家的距离采用不同策略
     if (!targetCell.isNull()) {
         int distanceToPlayer = qAbs(targetCell.x() - currentCol) + qAbs(targetCell.y() - currentRow);
@@ -168,7 +185,7 @@ void FakeVegetableBoss::updateAI()
         }
         
         // 添加随机性，避免过于机械
-        if (QRandomGenerator::global()->bounded(100) < 15) { // 15%概率随机移动
+        if (randomGenerator.bounded(100) < 15) { // 15%概率随机移动
             QList<Direction> validDirections;
             for (Direction dir : {DIR_LEFT, DIR_UP, DIR_RIGHT, DIR_DOWN}) {
                 int testRow = currentRow + DIR_OFFSET[dir][1];
@@ -178,7 +195,7 @@ void FakeVegetableBoss::updateAI()
                 }
             }
             if (!validDirections.isEmpty()) {
-                moveDir = validDirections[QRandomGenerator::global()->bounded(validDirections.size())];
+                moveDir = validDirections[randomGenerator.bounded(validDirections.size())];
             }
         }
         
@@ -211,11 +228,6 @@ void FakeVegetableBoss::updateAnimation()
     updatePixmap();
 }
 
-void FakeVegetableBoss::onMovementFinished()
-{
-    isMoving = false;
-}
-
 bool FakeVegetableBoss::canMoveTo(int row, int col) const
 {
     return map->isValidPosition(row, col);
@@ -247,15 +259,13 @@ void FakeVegetableBoss::moveToNextCell()
     
     if (canMoveTo(newRow, newCol)) {
         isMoving = true;
+        moveTicks = 0;
         
-        QPointF currentPos = pos();
         QPointF targetPos = map->cellToPixel(newRow, newCol);
         targetPos.setX(targetPos.x() - ENEMY_SIZE/2);
         targetPos.setY(targetPos.y() - ENEMY_SIZE/2);
-        
-        moveAnimation->setStartValue(currentPos);
-        moveAnimation->setEndValue(targetPos);
-        moveAnimation->start();
+        moveFrom = pos();
+        moveTo = targetPos;
         
         // 更新逻辑位置
         currentRow = newRow;
@@ -383,7 +393,7 @@ Direction FakeVegetableBoss::getFallbackDirection(Direction blockedDir) const
     }
     
     if (!validFallbacks.isEmpty()) {
-        return validFallbacks[QRandomGenerator::global()->bounded(validFallbacks.size())];
+        return validFallbacks[randomGenerator.bounded(validFallbacks.size())];
     }
     
     return DIR_NONE;
@@ -3,18 +3,26 @@
 
 #include <QGraphicsPixmapItem>
 #include <QObject>
-#include <QTimer>
 #include <QPixmap>
-#include <QPropertyAnimation>
+#include <QRandomGenerator>
 #include "carbohydrate_config.h"
 #include "game_map.h"
 
 class FakeVegetableBoss : public QObject, public QGraphicsPixmapItem
 {
     Q_OBJECT
-    Q_PROPERTY(QPointF pos READ pos WRITE setPos)
 
 public:
+    // 快照中的BOSS状态
+    struct SavedState {
+        qint32 row;
+        qint32 col;
+        qint32 health;
+        qint32 direction;
+        quint32 randomSeed;
+        quint32 aiStep;
+    };
+    
     explicit FakeVegetableBoss(GameMap* gameMap, QObject *parent = nullptr);
     ~FakeVegetableBoss();
     
@@ -23,11 +31,10 @@ public:
     void takeDamage(int damage);
     bool isAlive() const { return health > 0; }
     
-    // 移动控制
+    // 移动控制：AI和格子间的移动都由advanceTick()按游戏帧推进，暂停时场景不调用即可
     void startMovement();
     void stopMovement();
-    void pauseMovement();
-    void resumeMovement();
+    void advanceTick();
     
     // 位置管理
     QPoint getCurrentCell() const;
@@ -40,17 +47,21 @@ public:
     // AI行为
     void setTargetPosition(QPoint playerCell);
     
+    // 随机移动使用的种子，回放时与录像一致
+    void setRandomSeed(quint32 seed) { randomSeed = seed; aiStep = 0; }
+    
+    // 快照：正在进行的移动直接落到目标格子
+    SavedState saveState() const;
+    void restoreState(const SavedState &state);
+    
 signals:
     void healthChanged(int newHealth);
     void bossDefeated();
     void playerCaught();
     
-private slots:
+private:
     void updateAI();
     void updateAnimation();
-    void onMovementFinished();
-    
-private:
     void loadSprites();
     void updatePixmap();
     void findPathToPlayer();
@@ -71,22 +82,33 @@ private:
     int currentRow, currentCol;
     QPoint targetCell;
     
-    // AI相关
-    QTimer* aiTimer;
-    QTimer* animationTimer;
-    QPropertyAnimation* moveAnimation;
+    // AI相关（按游戏帧计数）
+    bool aiActive;
+    int aiTicks;
+    static const int AI_INTERVAL_TICKS = 500 / GAME_TICK_MS;
     
-    // 移动状态
+    // 移动状态：在两个格子之间线性插值，MOVE_TICKS帧走完一格
     bool isMoving;
     Direction currentDirection;
+    QPointF moveFrom;
+    QPointF moveTo;
+    int moveTicks;
+    static const int MOVE_TICKS = 200 / GAME_TICK_MS;
     
     // 动画相关
     QPixmap sprites[4][2]; // 4个方向，每个方向2帧动画
     int currentFrame;
+    int animationTicks;
+    static const int ANIMATION_TICKS = 300 / GAME_TICK_MS;
     
     // 路径查找
     QList<QPoint> pathToPlayer;
     int pathIndex;
+    
+    // 随机移动：每个AI步由种子和步数重新派生，存档只需记录这两个数
+    mutable QRandomGenerator randomGenerator;
+    quint32 randomSeed;
+    quint32 aiStep;
 };
 
 #endif // FAKE_VEGETABLE_BOSS_H
\ No newline at end of file
@@ -1,14 +1,17 @@
 #include "fiber_sword.h"
 #include <QGraphicsScene>
 #include <QList>
+#include <QLineF>
 #include <QDebug>
 #include <QtMath>
+#include "../asset_cache.h"
 
 FiberSword::FiberSword(QPointF startPos, Direction direction, GameMap* gameMap, QObject *parent)
     : QObject(parent), QGraphicsPixmapItem()
     , map(gameMap)
     , moveDirection(direction)
     , startPosition(startPos)
+    , flying(false)
     , moveSpeed(8.0) // 移动速度
     , maxDistance(300.0) // 最大飞行距离
 {
@@ -18,16 +21,6 @@ FiberSword::FiberSword(QPointF startPos, Direction direction, GameMap* gameMap,
     // 设置初始位置
     setPos(startPosition);
     
-    // 创建移动动画
-    moveAnimation = new QPropertyAnimation(this, "pos");
-    moveAnimation->setEasingCurve(QEasingCurve::Linear);
-    
-    // 创建碰撞检测定时器
-    collisionTimer = new QTimer(this);
-    
-    connect(moveAnimation, &QPropertyAnimation::finished, this, &FiberSword::onMovementFinished);
-    connect(collisionTimer, &QTimer::timeout, this, &FiberSword::checkCollisions);
-    
     // 计算目标位置
     calculateTargetPosition();
     
@@ -42,7 +35,7 @@ FiberSword::~FiberSword()
 void FiberSword::loadSprite()
 {
     // 尝试加载项目中的道具图片
-    QPixmap itemSprite(":/img/items/itemicon0.png");
+    const QPixmap itemSprite = AssetCache::getInstance()->scaledPixmap(":/img/items/itemicon0.png", FIBER_SWORD_SIZE);
     
     if (itemSprite.isNull()) {
         // 如果资源加载失败，创建简单的图形作为替代
@@ -50,8 +43,7 @@ void FiberSword::loadSprite()
         defaultSprite.fill(Qt::green);
         swordSprite = defaultSprite;
     } else {
-        // 缩放图片到合适大小
-        swordSprite = itemSprite.scaled(FIBER_SWORD_SIZE, FIBER_SWORD_SIZE, Qt::KeepAspectRatio, Qt::SmoothTransformation);
+        swordSprite = itemSprite;
     }
     
     setPixmap(swordSprite);
@@ -91,39 +83,37 @@ void FiberSword::calculateTargetPosition()
 
 void FiberSword::startMovement()
 {
-    // 计算移动时间
-    qreal distance = QLineF(startPosition, targetPosition).length();
-    int duration = static_cast<int>(distance / moveSpeed * 16.67); // 约60FPS
-    
-    moveAnimation->setDuration(duration);
-    moveAnimation->setStartValue(startPosition);
-    moveAnimation->setEndValue(targetPosition);
-    moveAnimation->start();
-    
-    // 启动碰撞检测
-    collisionTimer->start(16); // 约60FPS检测频率
+    setPos(startPosition);
+    flying = true;
 }
 
 void FiberSword::stopMovement()
 {
-    moveAnimation->stop();
-    collisionTimer->stop();
+    if (!flying) {
+        return;
+    }
+    flying = false;
     emit swordDestroyed();
 }
 
-void FiberSword::updateMovement()
+void FiberSword::advanceTick()
 {
-    // 这个方法由动画系统自动调用
+    if (!flying) {
+        return;
+    }
+    
+    // 每帧朝目标移动moveSpeed像素，到达目标后销毁
+    const QLineF path(pos(), targetPosition);
+    if (path.length() <= moveSpeed) {
+        setPos(targetPosition);
+        checkCollisions();
+        stopMovement();
+        return;
+    }
+    setPos(path.pointAt(moveSpeed / path.length()));
     checkCollisions();
 }
 
-void FiberSword::onMovementFinished()
-{
-    // 移动完成，销毁剑
-    collisionTimer->stop();
-    emit swordDestroyed();
-}
-
 void FiberSword::checkCollisions()
 {
     if (!scene()) {
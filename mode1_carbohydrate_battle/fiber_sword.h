@@ -3,8 +3,6 @@
 
 #include <QGraphicsPixmapItem>
 #include <QObject>
-#include <QTimer>
-#include <QPropertyAnimation>
 #include <QPixmap>
 #include "carbohydrate_config.h"
 #include "game_map.h"
@@ -12,15 +10,15 @@
 class FiberSword : public QObject, public QGraphicsPixmapItem
 {
     Q_OBJECT
-    Q_PROPERTY(QPointF pos READ pos WRITE setPos)
 
 public:
     explicit FiberSword(QPointF startPos, Direction direction, GameMap* gameMap, QObject *parent = nullptr);
     ~FiberSword();
     
-    // 移动控制
+    // 移动控制：startMovement()之后由场景每个游戏帧调用一次advanceTick()，飞行和碰撞都按帧推进
     void startMovement();
     void stopMovement();
+    void advanceTick();
     
     // 属性访问
     int getDamage() const { return FIBER_SWORD_DAMAGE; }
@@ -34,12 +32,8 @@ signals:
     void swordDestroyed();
     void hitTarget(QGraphicsItem* target);
     
-private slots:
-    void updateMovement();
-    void onMovementFinished();
-    void checkCollisions();
-    
 private:
+    void checkCollisions();
     void loadSprite();
     void calculateTargetPosition();
     bool isValidPosition(QPointF pos) const;
@@ -50,11 +44,10 @@ private:
     Direction moveDirection;
     QPointF startPosition;
     QPointF targetPosition;
-    QPropertyAnimation* moveAnimation;
-    QTimer* collisionTimer;
+    bool flying;
     
     // 移动参数
-    qreal moveSpeed;
+    qreal moveSpeed; // 每个游戏帧移动的像素
     qreal maxDistance;
     
     // 视觉效果
@@ -1,7 +1,15 @@
 #include "game_map.h"
+#include "../snapshot_io.h"
 #include <QPointF>
 #include <QPoint>
 
+namespace
+{
+    const quint32 SNAPSHOT_TAG = 0x3150414d; // "MAP1"
+    const int CELL_COUNT = MAP_ROWS * MAP_COLS;
+    const int WORD_COUNT = (CELL_COUNT + 63) / 64;
+}
+
 // 地图布局模板（1=墙，0=通道，2=假蔬菜）
 const int GameMap::mapTemplate[MAP_ROWS][MAP_COLS] = {
     {1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1},
@@ -94,4 +102,40 @@ QPoint GameMap::pixelToCell(const QPointF& pixel) const
 bool GameMap::isValidPosition(int row, int col) const
 {
     return !isWall(row, col);
-}
\ No newline at end of file
+}
+
+void GameMap::saveState(SnapshotWriter &writer) const
+{
+    quint64 words[WORD_COUNT] = {};
+    for (int row = 0; row < MAP_ROWS; ++row) {
+        for (int col = 0; col < MAP_COLS; ++col) {
+            if (fakeVegetableData[row][col]) {
+                const int index = row * MAP_COLS + col;
+                words[index / 64] |= quint64(1) << (index % 64);
+            }
+        }
+    }
+    writer.beginSection(SNAPSHOT_TAG);
+    writer.writeArray(words, WORD_COUNT);
+}
+
+bool GameMap::readState(SnapshotReader &reader, QVector<quint64> &words)
+{
+    return reader.expectSection(SNAPSHOT_TAG) && reader.readArray(words, WORD_COUNT)
+        && words.size() == WORD_COUNT;
+}
+
+void GameMap::restoreState(const QVector<quint64> &words)
+{
+    remainingFakeVegetables = 0;
+    for (int row = 0; row < MAP_ROWS; ++row) {
+        for (int col = 0; col < MAP_COLS; ++col) {
+            const int index = row * MAP_COLS + col;
+            // 墙上不会有假蔬菜
+            fakeVegetableData[row][col] = !wallData[row][col] && ((words[index / 64] >> (index % 64)) & 1);
+            if (fakeVegetableData[row][col]) {
+                remainingFakeVegetables++;
+            }
+        }
+    }
+}
@@ -3,6 +3,10 @@
 
 #include "carbohydrate_config.h"
 #include <QObject>
+#include <QVector>
+
+class SnapshotWriter;
+class SnapshotReader;
 
 class GameMap : public QObject
 {
@@ -31,6 +35,12 @@ public:
     // 检查位置是否有效（不是墙）
     bool isValidPosition(int row, int col) const;
     
+    // 快照：墙由模板决定，只保存假蔬菜的分布（按位压缩）
+    // 读档分两步：readState()只读进调用方的临时数组，整份快照校验通过后再用restoreState()写入地图
+    void saveState(SnapshotWriter &writer) const;
+    static bool readState(SnapshotReader &reader, QVector<quint64> &words);
+    void restoreState(const QVector<quint64> &words);
+    
 private:
     void initializeMap();
     
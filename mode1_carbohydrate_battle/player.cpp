@@ -2,6 +2,7 @@
 #include <QGraphicsScene>
 #include <QKeyEvent>
 #include <QDebug>
+#include "../asset_cache.h"
 
 Player::Player(GameMap* gameMap, QObject *parent)
     : QObject(parent), QGraphicsPixmapItem()
@@ -11,6 +12,7 @@ Player::Player(GameMap* gameMap, QObject *parent)
     , currentRow(10), currentCol(12) // 起始位置在地图中央
     , fiberValue(INITIAL_FIBER_VALUE)
     , currentFrame(0)
+    , animationTicks(0)
 {
     // 初始化按键状态
     for (int i = 0; i < 4; ++i) {
@@ -23,17 +25,6 @@ Player::Player(GameMap* gameMap, QObject *parent)
     // 设置初始位置
     setPosition(currentRow, currentCol);
     
-    // 创建定时器
-    movementTimer = new QTimer(this);
-    animationTimer = new QTimer(this);
-    
-    connect(movementTimer, &QTimer::timeout, this, &Player::updateMovement);
-    connect(animationTimer, &QTimer::timeout, this, &Player::updateAnimationFrame);
-    
-    // 启动定时器
-    movementTimer->start(1000 / 60); // 60 FPS
-    animationTimer->start(150); // 动画帧切换间隔
-    
     // 设置碰撞检测
     setFlag(QGraphicsItem::ItemIsFocusable, true);
     setFocus();
@@ -45,9 +36,9 @@ Player::~Player()
 
 void Player::loadSprites()
 {
-    // 使用项目中的角色图片资源
-    QPixmap usagiSprite(":/img/roles/usagi1.png");
-    QPixmap usagiMirSprite(":/img/roles/usagi1-mir.png");
+    // 使用项目中的角色图片资源，缩放到合适大小
+    const QPixmap usagiSprite = AssetCache::getInstance()->scaledPixmap(":/img/roles/usagi1.png", PLAYER_SIZE);
+    const QPixmap usagiMirSprite = AssetCache::getInstance()->scaledPixmap(":/img/roles/usagi1-mir.png", PLAYER_SIZE);
     
     if (usagiSprite.isNull() || usagiMirSprite.isNull()) {
         // 如果资源加载失败，创建简单的彩色方块作为替代
@@ -60,10 +51,6 @@ void Player::loadSprites()
             }
         }
     } else {
-        // 缩放图片到合适大小
-        usagiSprite = usagiSprite.scaled(PLAYER_SIZE, PLAYER_SIZE, Qt::KeepAspectRatio, Qt::SmoothTransformation);
-        usagiMirSprite = usagiMirSprite.scaled(PLAYER_SIZE, PLAYER_SIZE, Qt::KeepAspectRatio, Qt::SmoothTransformation);
-        
         // 为不同方向设置精灵
         for (int frame = 0; frame < 3; ++frame) {
             sprites[DIR_LEFT][frame] = usagiSprite;
@@ -229,9 +216,31 @@ void Player::handleKeyRelease(int key)
     }
 }
 
-void Player::updateMovement()
+Player::SavedState Player::saveState() const
+{
+    return { currentRow, currentCol, currentDirection, fiberValue };
+}
+
+void Player::restoreState(const SavedState &state)
+{
+    currentDirection = static_cast<Direction>(qBound<int>(DIR_LEFT, state.direction, DIR_DOWN));
+    nextDirection = DIR_NONE;
+    for (int i = 0; i < 4; ++i) {
+        keyPressed[i] = false;
+    }
+    setPosition(state.row, state.col);
+    fiberValue = qMax(0, state.fiberValue);
+    emit fiberValueChanged(fiberValue);
+    updatePixmap();
+}
+
+void Player::advanceTick()
 {
     move();
+    if (++animationTicks >= ANIMATION_TICKS) {
+        animationTicks = 0;
+        updateAnimationFrame();
+    }
 }
 
 void Player::updateAnimationFrame()
@@ -246,15 +255,3 @@ void Player::updateAnimation()
 {
     updatePixmap();
 }
-
-void Player::pauseAnimation()
-{
-    movementTimer->stop();
-    animationTimer->stop();
-}
-
-void Player::resumeAnimation()
-{
-    movementTimer->start();
-    animationTimer->start();
-}
\ No newline at end of file
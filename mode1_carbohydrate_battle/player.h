@@ -3,7 +3,6 @@
 
 #include <QGraphicsPixmapItem>
 #include <QObject>
-#include <QTimer>
 #include <QKeyEvent>
 #include <QPixmap>
 #include "carbohydrate_config.h"
@@ -14,6 +13,14 @@ class Player : public QObject, public QGraphicsPixmapItem
     Q_OBJECT
 
 public:
+    // 快照中的玩家状态
+    struct SavedState {
+        qint32 row;
+        qint32 col;
+        qint32 direction;
+        qint32 fiberValue;
+    };
+    
     explicit Player(GameMap* gameMap, QObject *parent = nullptr);
     ~Player();
     
@@ -34,14 +41,17 @@ public:
     QPoint getCurrentCell() const;
     void setPosition(int row, int col);
     
+    // 快照：按键状态不保存，恢复后从松开所有按键开始
+    SavedState saveState() const;
+    void restoreState(const SavedState &state);
+    
     // 碰撞检测
     enum { Type = TYPE_PLAYER };
     int type() const override { return Type; }
     
-    // 动画控制
+    // 由场景每个游戏帧调用一次：按当前方向移动一格并推进动画
+    void advanceTick();
     void updateAnimation();
-    void pauseAnimation();
-    void resumeAnimation();
     
 signals:
     void fiberSwordUsed(QPointF position, Direction direction);
@@ -53,11 +63,8 @@ public slots:
     void handleKeyPress(int key);
     void handleKeyRelease(int key);
     
-private slots:
-    void updateMovement();
-    void updateAnimationFrame();
-    
 private:
+    void updateAnimationFrame();
     void loadSprites();
     void updatePixmap();
     bool canMoveTo(int row, int col) const;
@@ -67,8 +74,6 @@ private:
     // 移动相关
     Direction currentDirection;
     Direction nextDirection;
-    QTimer* movementTimer;
-    QTimer* animationTimer;
     
     // 位置信息
     QPointF targetPosition;
@@ -80,6 +85,8 @@ private:
     // 动画相关
     QPixmap sprites[4][3]; // 4个方向，每个方向3帧动画
     int currentFrame;
+    int animationTicks; // 距上次切换动画帧经过的游戏帧数
+    static const int ANIMATION_TICKS = 150 / GAME_TICK_MS;
     
     // 输入状态
     bool keyPressed[4]; // 对应四个方向键
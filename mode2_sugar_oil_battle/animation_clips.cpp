@@ -0,0 +1,77 @@
+#include "animation_clips.h"
+#include "../asset_cache.h"
+
+AnimationClips* AnimationClips::getInstance()
+{
+    static AnimationClips clips;
+    return &clips;
+}
+
+AnimationClips::AnimationClips()
+{
+}
+
+ClipId AnimationClips::registerClip(const QString &name, const QStringList &paths, qreal frameMs,
+                                    const QPixmap &fallback)
+{
+    const auto it = mNames.constFind(name);
+    if (it != mNames.constEnd()) {
+        return it.value();
+    }
+
+    Clip clip;
+    clip.firstFrame = mFrames.size();
+    clip.frameCount = qMax(1, static_cast<int>(paths.size()));
+    clip.frameMs = frameMs;
+
+    AssetCache* cache = AssetCache::getInstance();
+    for (const QString &path : paths) {
+        const QPixmap pixmap = cache->pixmap(path);
+        mFrames.append(pixmap.isNull() ? fallback : pixmap);
+    }
+    if (paths.isEmpty()) {
+        mFrames.append(fallback);
+    }
+
+    const ClipId id = mClips.size();
+    mClips.append(clip);
+    mNames.insert(name, id);
+    return id;
+}
+
+const QPixmap& AnimationClips::getFrame(ClipId clip, int frame) const
+{
+    if (clip < 0 || clip >= mClips.size()) {
+        return mEmptyFrame;
+    }
+    const Clip &entry = mClips[clip];
+    return mFrames[entry.firstFrame + qBound(0, frame, entry.frameCount - 1)];
+}
+
+int AnimationClips::getFrameCount(ClipId clip) const
+{
+    return (clip < 0 || clip >= mClips.size()) ? 0 : mClips[clip].frameCount;
+}
+
+bool AnimationClips::advance(AnimationState &state, qreal dtMs) const
+{
+    if (state.clip < 0 || state.clip >= mClips.size() || dtMs <= 0.0) {
+        return false;
+    }
+    const Clip &clip = mClips[state.clip];
+    if (clip.frameCount <= 1 || clip.frameMs <= 0.0) {
+        return false;
+    }
+
+    state.phaseMs += dtMs;
+    if (state.phaseMs < clip.frameMs) {
+        return false;
+    }
+    // 时间缩放很大或掉帧时一次可能跨过多帧
+    const int steps = static_cast<int>(state.phaseMs / clip.frameMs);
+    state.phaseMs -= steps * clip.frameMs;
+    const int frame = (state.frame + steps) % clip.frameCount;
+    const bool changed = frame != state.frame;
+    state.frame = frame;
+    return changed;
+}
@@ -0,0 +1,62 @@
+#ifndef ANIMATION_CLIPS_H
+#define ANIMATION_CLIPS_H
+
+#include <QHash>
+#include <QPixmap>
+#include <QString>
+#include <QStringList>
+#include <QVector>
+
+typedef qint32 ClipId;
+
+// 实体上的播放进度：片段编号、当前帧和当前帧已播放的时间（毫秒，游戏时间）
+struct AnimationState {
+    ClipId clip;
+    qint32 frame;
+    qreal phaseMs;
+};
+
+// 动画片段表
+// 同一原型（玩家、每种敌人、每种道具）的所有实例共享一份帧表：片段在第一次用到时按名字注册，
+// 帧图从AssetCache取出后连续存放，之后只用整数编号访问。
+// 实体只保存AnimationState，由场景每帧按所属阵营缩放后的时间统一推进，帧变化时才换图。
+// 只在主线程使用
+class AnimationClips
+{
+public:
+    static constexpr ClipId INVALID_CLIP = -1;
+
+    static AnimationClips* getInstance();
+
+    // 注册片段并返回编号，同名片段只注册一次（再次注册直接返回原编号）。
+    // frameMs为每帧时长，<=0或只有一帧时不推进；取不到的帧用fallback代替
+    ClipId registerClip(const QString &name, const QStringList &paths, qreal frameMs,
+                        const QPixmap &fallback = QPixmap());
+    // 按名字查找，只应在初始化时使用；不存在时返回INVALID_CLIP
+    ClipId findClip(const QString &name) const { return mNames.value(name, INVALID_CLIP); }
+
+    const QPixmap& getFrame(ClipId clip, int frame) const;
+    int getFrameCount(ClipId clip) const;
+
+    // 推进dtMs毫秒，循环播放；当前帧变化时返回true
+    bool advance(AnimationState &state, qreal dtMs) const;
+
+    int getClipCount() const { return mClips.size(); }
+    int getFrameTotal() const { return mFrames.size(); }
+
+private:
+    AnimationClips();
+
+    struct Clip {
+        int firstFrame; // 在mFrames中的起始下标
+        int frameCount;
+        qreal frameMs;
+    };
+
+    QVector<Clip> mClips;
+    QVector<QPixmap> mFrames;
+    QHash<QString, ClipId> mNames;
+    QPixmap mEmptyFrame;
+};
+
+#endif // ANIMATION_CLIPS_H
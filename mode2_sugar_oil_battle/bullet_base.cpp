@@ -1,6 +1,7 @@
 #include "bullet_base.h"
 #include <QPixmap>
 #include <QtMath>
+#include "../asset_cache.h"
 
 // 静态成员变量定义
 QList<BulletBase*> BulletBase::sPlayerBulletPool;
@@ -14,13 +15,8 @@ BulletBase::BulletBase(QObject *parent)
     , mMoveDirection(1.0, 0.0)
     , mDamage(10)
     , mIsDestroyed(false)
-    , mMoveTimer(nullptr)
+    , mMoving(false)
 {
-    // 初始化移动定时器
-    mMoveTimer = new QTimer(this);
-    mMoveTimer->setInterval(MOVE_INTERVAL);
-    connect(mMoveTimer, &QTimer::timeout, this, &BulletBase::onMoveTimeout);
-    
     // 设置默认图像
     updateBulletPixmap();
     setScale(0.15);
@@ -35,13 +31,8 @@ BulletBase::BulletBase(GameObjectBase* owner, BulletType type, QObject *parent)
     , mMoveDirection(1.0, 0.0)
     , mDamage(10)
     , mIsDestroyed(false)
-    , mMoveTimer(nullptr)
+    , mMoving(false)
 {
-    // 初始化移动定时器
-    mMoveTimer = new QTimer(this);
-    mMoveTimer->setInterval(MOVE_INTERVAL);
-    connect(mMoveTimer, &QTimer::timeout, this, &BulletBase::onMoveTimeout);
-    
     // 设置图像
     updateBulletPixmap();
     setScale(0.5);
@@ -50,9 +41,6 @@ BulletBase::BulletBase(GameObjectBase* owner, BulletType type, QObject *parent)
 
 BulletBase::~BulletBase()
 {
-    if (mMoveTimer) {
-        mMoveTimer->stop();
-    }
 }
 
 void BulletBase::setMoveDirection(const QPointF &direction)
@@ -100,41 +88,14 @@ void BulletBase::setMoveDirection(BulletDirection direction)
     }
 }
 
-void BulletBase::moveBullet()
-{
-    qreal dx = mSpeed * mMoveDirection.x();
-    qreal dy = mSpeed * mMoveDirection.y();
-    moveBy(dx, dy);
-}
-
-bool BulletBase::isOutOfBounds(const QRectF &sceneBounds) const
-{
-    QPointF currentPos = pos();
-    QRectF bulletRect = boundingRect();
-    
-    return (currentPos.x() + bulletRect.width() < sceneBounds.left() ||
-            currentPos.x() > sceneBounds.right() ||
-            currentPos.y() + bulletRect.height() < sceneBounds.top() ||
-            currentPos.y() > sceneBounds.bottom());
-}
-
-void BulletBase::startMoving()
-{
-    if (mMoveTimer && !mMoveTimer->isActive()) {
-        mMoveTimer->start();
-    }
-}
-
-void BulletBase::stopMoving()
+void BulletBase::moveBullet(qreal dtMs)
 {
-    if (mMoveTimer) {
-        mMoveTimer->stop();
+    if (!mMoving || dtMs <= 0.0) {
+        return;
     }
-}
-
-void BulletBase::onMoveTimeout()
-{
-    moveBullet();
+    
+    const qreal distance = mSpeed * dtMs / MOVE_INTERVAL;
+    moveBy(distance * mMoveDirection.x(), distance * mMoveDirection.y());
     
     // 检查是否超出边界（需要场景边界信息）
     // 这里使用一个大概的边界检查
@@ -144,6 +105,18 @@ void BulletBase::onMoveTimeout()
     }
 }
 
+bool BulletBase::isOutOfBounds(const QRectF &sceneBounds) const
+{
+    QPointF currentPos = pos();
+    // 绘制尺寸 = 设备无关尺寸 × 缩放
+    const QSizeF bulletSize = boundingRect().size() * scale();
+    
+    return (currentPos.x() + bulletSize.width() < sceneBounds.left() ||
+            currentPos.x() > sceneBounds.right() ||
+            currentPos.y() + bulletSize.height() < sceneBounds.top() ||
+            currentPos.y() > sceneBounds.bottom());
+}
+
 void BulletBase::updateBulletPixmap()
 {
     // 使用静态变量缓存预加载的图像，避免重复加载导致卡顿
@@ -153,8 +126,8 @@ void BulletBase::updateBulletPixmap()
     
     // 首次加载时初始化图像缓存
     if (!pixmapsLoaded) {
-        playerBulletPixmap = QPixmap(":/img/bulletsample.png");
-        enemyBulletPixmap = QPixmap(":/img/enemybulletsample.png");
+        playerBulletPixmap = AssetCache::getInstance()->pixmap(":/img/bulletsample.png");
+        enemyBulletPixmap = AssetCache::getInstance()->pixmap(":/img/enemybulletsample.png");
         
         // 如果加载失败，创建默认图像
         if (playerBulletPixmap.isNull()) {
@@ -270,8 +243,6 @@ void BulletBase::resetBullet(GameObjectBase* owner, BulletType type)
     updateBulletPixmap();
     setVisible(true);
     
-    // 重置定时器
-    if (mMoveTimer) {
-        mMoveTimer->stop();
-    }
+    // 等待场景重新启动移动
+    mMoving = false;
 }
\ No newline at end of file
@@ -3,7 +3,6 @@
 
 #include "game_object_base.h"
 #include <QPointF>
-#include <QTimer>
 
 class BulletBase : public GameObjectBase
 {
@@ -50,15 +49,20 @@ public:
     bool isDestroyed() const { return mIsDestroyed; }
     void markForDestruction() { mIsDestroyed = true; }
     
-    // 移动
-    virtual void moveBullet();
+    // 移动：由场景每帧驱动，dtMs为所属阵营缩放后的经过时间
+    virtual void moveBullet(qreal dtMs);
+    
+    // 连续碰撞：记录上次碰撞检测时的中心位置，与当前中心构成扫掠线段
+    QPointF getSweepStart() const { return mSweepStart; }
+    void resetSweep() { mSweepStart = getCenterPos(); }
     
     // 检查是否超出边界
     bool isOutOfBounds(const QRectF &sceneBounds) const;
     
     // 启动/停止移动
-    void startMoving();
-    void stopMoving();
+    void startMoving() { mMoving = true; }
+    void stopMoving() { mMoving = false; }
+    bool isMoving() const { return mMoving; }
     
     // 对象池功能 - 性能优化
     static BulletBase* getBulletFromPool(GameObjectBase* owner, BulletType type);
@@ -69,9 +73,6 @@ signals:
     void bulletOutOfBounds(BulletBase* bullet);
     void bulletHit(BulletBase* bullet, GameObjectBase* target);
 
-public slots:
-    void onMoveTimeout();
-
 protected:
     virtual void updateBulletPixmap();
     
@@ -82,15 +83,15 @@ private:
     QPointF mMoveDirection;
     int mDamage;
     bool mIsDestroyed; // 添加销毁状态标记
-    
-    QTimer* mMoveTimer;
+    QPointF mSweepStart; // 上次碰撞检测时的中心位置
+    bool mMoving;
     
     // 对象池相关
     static QList<BulletBase*> sPlayerBulletPool;
     static QList<BulletBase*> sEnemyBulletPool;
     static const int MAX_POOL_SIZE = 50; // 最大池大小
     
-    static const int MOVE_INTERVAL = 25; // ~40 FPS，降低子弹更新频率
+    static const int MOVE_INTERVAL = 25; // 速度单位：每25毫秒移动的像素数
 };
 
 #endif // BULLET_BASE_H
\ No newline at end of file
@@ -0,0 +1,54 @@
+#include "bullet_patterns.h"
+#include "bullet_store.h"
+#include <cmath>
+
+namespace
+{
+    // 与BulletBase的速度单位一致
+    const float SPEED_INTERVAL_MS = 25.0f;
+    const float DEG_TO_RAD = 3.14159265358979f / 180.0f;
+
+    // 按BulletPatternId的值下标
+    const BulletPattern PATTERN_TABLE[static_cast<int>(BulletPatternId::Count)] = {
+        // 数量, 分布角, 速度, 旋转步长, 瞄准
+        {  1,   0.0f, 6.0f,  0.0f, true  }, // 单发瞄准
+        {  5,  60.0f, 5.0f,  0.0f, true  }, // 扇形
+        { 16, 360.0f, 4.0f,  0.0f, false }, // 环形
+        {  4, 360.0f, 4.5f, 15.0f, false }  // 四臂螺旋
+    };
+}
+
+const BulletPattern &BulletPatterns::getPattern(BulletPatternId id)
+{
+    return PATTERN_TABLE[static_cast<int>(id)];
+}
+
+int BulletPatterns::fire(BulletStore &store, BulletPatternId id, const QPointF &origin, float baseAngleDeg, int damage)
+{
+    const BulletPattern &pattern = getPattern(id);
+    const float speed = pattern.speed / SPEED_INTERVAL_MS;
+    const float x = static_cast<float>(origin.x());
+    const float y = static_cast<float>(origin.y());
+
+    // 整圈分布时首尾不重合；扇形两端各有一颗
+    float startDeg = baseAngleDeg;
+    float stepDeg = 0.0f;
+    if (pattern.count > 1) {
+        if (pattern.spreadDeg >= 360.0f) {
+            stepDeg = 360.0f / pattern.count;
+        } else {
+            stepDeg = pattern.spreadDeg / (pattern.count - 1);
+            startDeg = baseAngleDeg - pattern.spreadDeg * 0.5f;
+        }
+    }
+
+    int spawned = 0;
+    for (int i = 0; i < pattern.count; ++i) {
+        const float angle = (startDeg + stepDeg * i) * DEG_TO_RAD;
+        if (!store.spawn(x, y, std::cos(angle) * speed, std::sin(angle) * speed, damage)) {
+            break; // 已达容量上限
+        }
+        ++spawned;
+    }
+    return spawned;
+}
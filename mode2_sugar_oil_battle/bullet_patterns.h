@@ -0,0 +1,37 @@
+#ifndef BULLET_PATTERNS_H
+#define BULLET_PATTERNS_H
+
+#include <QtGlobal>
+#include <QPointF>
+
+class BulletStore;
+
+// 弹幕图案
+enum class BulletPatternId {
+    Aimed = 0,     // 单发瞄准
+    Fan,           // 瞄准方向的扇形
+    Ring,          // 全方位一圈
+    Spiral,        // 多臂螺旋，每次发射旋转一个角度
+    Count
+};
+
+// 图案参数
+struct BulletPattern {
+    int count;            // 每次发射的子弹数
+    float spreadDeg;      // 子弹分布的总角度（环形为360）
+    float speed;          // 速度，单位与BulletBase一致：每25毫秒移动的像素数
+    float rotationStep;   // 每次发射后起始角度的旋转量（螺旋）
+    bool aimed;           // 是否以玩家方向为中心
+};
+
+// 弹幕图案引擎
+// 一次发射按图案参数批量写入BulletStore，不为单颗子弹创建对象或发信号
+namespace BulletPatterns
+{
+    const BulletPattern &getPattern(BulletPatternId id);
+
+    // 以baseAngleDeg为中心（瞄准图案）或起始角（环形/螺旋）发射一批子弹，返回实际生成的数量
+    int fire(BulletStore &store, BulletPatternId id, const QPointF &origin, float baseAngleDeg, int damage);
+}
+
+#endif // BULLET_PATTERNS_H
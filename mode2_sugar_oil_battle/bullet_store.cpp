@@ -0,0 +1,175 @@
+#include "bullet_store.h"
+#include "swept_collision.h"
+#include "job_system.h"
+#include "../snapshot_io.h"
+
+namespace
+{
+    const quint32 SNAPSHOT_TAG = 0x544c4245; // "EBLT"
+}
+
+BulletStore::BulletStore(int capacity)
+    : mCapacity(capacity)
+{
+    // 一次性预留到上限，游戏过程中不再扩容
+    mX.reserve(capacity);
+    mY.reserve(capacity);
+    mPrevX.reserve(capacity);
+    mPrevY.reserve(capacity);
+    mVX.reserve(capacity);
+    mVY.reserve(capacity);
+    mDamage.reserve(capacity);
+}
+
+bool BulletStore::spawn(float x, float y, float vx, float vy, int damage)
+{
+    if (mX.size() >= mCapacity) {
+        return false;
+    }
+    mX.append(x);
+    mY.append(y);
+    mPrevX.append(x);
+    mPrevY.append(y);
+    mVX.append(vx);
+    mVY.append(vy);
+    mDamage.append(damage);
+    return true;
+}
+
+void BulletStore::integrate(float dtMs, JobSystem* jobs)
+{
+    const int count = mX.size();
+    if (count == 0) {
+        return;
+    }
+
+    float* x = mX.data();
+    float* y = mY.data();
+    float* prevX = mPrevX.data();
+    float* prevY = mPrevY.data();
+    const float* vx = mVX.constData();
+    const float* vy = mVY.constData();
+
+    auto integrateRange = [=](int begin, int end) {
+        // 冻结/减速时dt可能为0，路径长度也随之为0，不会误判碰撞
+        for (int i = begin; i < end; ++i) {
+            prevX[i] = x[i];
+            prevY[i] = y[i];
+        }
+        // 无分支的乘加循环，编译器可直接向量化
+        for (int i = begin; i < end; ++i) {
+            x[i] += vx[i] * dtMs;
+            y[i] += vy[i] * dtMs;
+        }
+    };
+
+    if (jobs) {
+        jobs->parallelFor(count, INTEGRATE_GRAIN, integrateRange);
+    } else {
+        integrateRange(0, count);
+    }
+}
+
+int BulletStore::removeOutside(const QRectF &bounds)
+{
+    const float minX = static_cast<float>(bounds.left());
+    const float minY = static_cast<float>(bounds.top());
+    const float maxX = static_cast<float>(bounds.right());
+    const float maxY = static_cast<float>(bounds.bottom());
+    int removed = 0;
+    // 倒序遍历，swap-and-pop换过来的元素已经检查过
+    for (int i = mX.size() - 1; i >= 0; --i) {
+        if (mX[i] < minX || mX[i] > maxX || mY[i] < minY || mY[i] > maxY) {
+            removeAt(i);
+            ++removed;
+        }
+    }
+    return removed;
+}
+
+int BulletStore::removeInside(const QRectF &rect)
+{
+    const float minX = static_cast<float>(rect.left());
+    const float minY = static_cast<float>(rect.top());
+    const float maxX = static_cast<float>(rect.right());
+    const float maxY = static_cast<float>(rect.bottom());
+    int removed = 0;
+    for (int i = mX.size() - 1; i >= 0; --i) {
+        if (mX[i] >= minX && mX[i] <= maxX && mY[i] >= minY && mY[i] <= maxY) {
+            removeAt(i);
+            ++removed;
+        }
+    }
+    return removed;
+}
+
+void BulletStore::clear()
+{
+    // clear()保留预留的容量
+    mX.clear();
+    mY.clear();
+    mPrevX.clear();
+    mPrevY.clear();
+    mVX.clear();
+    mVY.clear();
+    mDamage.clear();
+}
+
+void BulletStore::saveState(SnapshotWriter &writer) const
+{
+    writer.beginSection(SNAPSHOT_TAG);
+    writer.writeArray(mX);
+    writer.writeArray(mY);
+    writer.writeArray(mPrevX);
+    writer.writeArray(mPrevY);
+    writer.writeArray(mVX);
+    writer.writeArray(mVY);
+    writer.writeArray(mDamage);
+}
+
+bool BulletStore::restoreState(SnapshotReader &reader)
+{
+    reader.expectSection(SNAPSHOT_TAG);
+    reader.readArray(mX, mCapacity);
+    reader.readArray(mY, mCapacity);
+    reader.readArray(mPrevX, mCapacity);
+    reader.readArray(mPrevY, mCapacity);
+    reader.readArray(mVX, mCapacity);
+    reader.readArray(mVY, mCapacity);
+    reader.readArray(mDamage, mCapacity);
+
+    // 各列长度必须一致，否则整个存储作废
+    const int count = mX.size();
+    if (!reader.isOk() || mY.size() != count || mPrevX.size() != count || mPrevY.size() != count
+        || mVX.size() != count || mVY.size() != count || mDamage.size() != count) {
+        clear();
+        return false;
+    }
+    return true;
+}
+
+bool BulletStore::segmentHitsRect(int i, const QRectF &rect) const
+{
+    return SweptCollision::sweepSegmentRect(QPointF(mPrevX[i], mPrevY[i]), QPointF(mX[i], mY[i]), rect, nullptr);
+}
+
+void BulletStore::removeAt(int i)
+{
+    const int last = mX.size() - 1;
+    if (i != last) {
+        mX[i] = mX[last];
+        mY[i] = mY[last];
+        mPrevX[i] = mPrevX[last];
+        mPrevY[i] = mPrevY[last];
+        mVX[i] = mVX[last];
+        mVY[i] = mVY[last];
+        mDamage[i] = mDamage[last];
+    }
+    mX.removeLast();
+    mY.removeLast();
+    mPrevX.removeLast();
+    mPrevY.removeLast();
+    mVX.removeLast();
+    mVY.removeLast();
+    mDamage.removeLast();
+}
@@ -0,0 +1,90 @@
+#ifndef BULLET_STORE_H
+#define BULLET_STORE_H
+
+#include <QtGlobal>
+#include <QVector>
+#include <QPointF>
+#include <QRectF>
+
+class SnapshotWriter;
+class JobSystem;
+class SnapshotReader;
+
+// 敌人子弹存储（SoA布局）
+// 敌人子弹不再是逐个的QGraphicsItem，而是连续数组中的一行：
+// 生成只是追加，移动是对整列坐标的一次积分，删除用swap-and-pop；
+// 上一帧的位置一并保存，用于与玩家的扫掠碰撞。绘制由BulletStoreItem一次完成
+class BulletStore
+{
+public:
+    explicit BulletStore(int capacity);
+
+    int size() const { return mX.size(); }
+    int getCapacity() const { return mCapacity; }
+
+    // 追加一颗子弹，速度单位为像素/毫秒；达到容量上限时丢弃并返回false
+    bool spawn(float x, float y, float vx, float vy, int damage);
+
+    // 一次遍历积分所有子弹的位置；传入jobs时按块并行，每颗子弹独立计算，结果与单线程相同
+    void integrate(float dtMs, JobSystem* jobs = nullptr);
+
+    // 移除中心点在bounds之外的子弹，返回移除数量
+    int removeOutside(const QRectF &bounds);
+
+    // 移除中心点在rect之内的子弹（炸弹清屏），返回移除数量
+    int removeInside(const QRectF &rect);
+
+    // 本帧路径（上一位置→当前位置）与rect相交的子弹被移除，并对每颗调用onHit(damage)
+    template<typename Fn>
+    int collideRect(const QRectF &rect, Fn onHit)
+    {
+        const float minX = static_cast<float>(rect.left());
+        const float minY = static_cast<float>(rect.top());
+        const float maxX = static_cast<float>(rect.right());
+        const float maxY = static_cast<float>(rect.bottom());
+        int hits = 0;
+        for (int i = mX.size() - 1; i >= 0; --i) {
+            // 先用路径包围盒粗筛，绝大多数子弹在这里就被排除
+            if (qMax(mX[i], mPrevX[i]) < minX || qMin(mX[i], mPrevX[i]) > maxX
+                || qMax(mY[i], mPrevY[i]) < minY || qMin(mY[i], mPrevY[i]) > maxY) {
+                continue;
+            }
+            if (!segmentHitsRect(i, rect)) {
+                continue;
+            }
+            onHit(mDamage[i]);
+            removeAt(i);
+            ++hits;
+        }
+        return hits;
+    }
+
+    void clear();
+
+    // 快照：各列整段写入和读出，上万颗子弹也只是几次memcpy
+    void saveState(SnapshotWriter &writer) const;
+    bool restoreState(SnapshotReader &reader);
+
+    // 供绘制使用的只读坐标（本帧和上一帧）
+    const float* xData() const { return mX.constData(); }
+    const float* yData() const { return mY.constData(); }
+    const float* prevXData() const { return mPrevX.constData(); }
+    const float* prevYData() const { return mPrevY.constData(); }
+
+private:
+    bool segmentHitsRect(int i, const QRectF &rect) const;
+    void removeAt(int i);
+
+    QVector<float> mX;
+    QVector<float> mY;
+    QVector<float> mPrevX;
+    QVector<float> mPrevY;
+    QVector<float> mVX;
+    QVector<float> mVY;
+    QVector<int> mDamage;
+    int mCapacity;
+
+    static const int INTEGRATE_GRAIN = 4096; // 并行积分时每块的子弹数
+};
+
+#endif // BULLET_STORE_H
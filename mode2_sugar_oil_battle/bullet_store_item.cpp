@@ -0,0 +1,75 @@
+#include "bullet_store_item.h"
+#include "bullet_store.h"
+#include <cstring>
+#include "../asset_cache.h"
+
+namespace
+{
+    void copyColumn(QVector<float> &out, const float* data, int count)
+    {
+        out.resize(count);
+        if (count > 0) {
+            std::memcpy(out.data(), data, sizeof(float) * count);
+        }
+    }
+}
+
+BulletStoreItem::BulletStoreItem(const QRectF &bounds, QGraphicsItem *parent)
+    : QGraphicsItem(parent)
+    , mBounds(bounds)
+    , mAlpha(1.0f)
+{
+    mPixmap = AssetCache::getInstance()->pixmap(":/img/enemybulletsample.png");
+    if (mPixmap.isNull()) {
+        mPixmap = QPixmap(10, 10);
+        mPixmap.fill(Qt::red);
+    }
+    setZValue(5);
+}
+
+QSizeF BulletStoreItem::getBulletSize() const
+{
+    return mPixmap.deviceIndependentSize() * BULLET_SCALE;
+}
+
+void BulletStoreItem::publish(const BulletStore &store)
+{
+    // resize只在子弹数超过历史最大值时分配
+    BulletRenderSnapshot &snapshot = mSnapshot;
+    const int count = store.size();
+    copyColumn(snapshot.fromX, store.prevXData(), count);
+    copyColumn(snapshot.fromY, store.prevYData(), count);
+    copyColumn(snapshot.toX, store.xData(), count);
+    copyColumn(snapshot.toY, store.yData(), count);
+}
+
+void BulletStoreItem::setInterpolation(qreal alpha)
+{
+    mAlpha = static_cast<float>(qBound(0.0, alpha, 1.0));
+}
+
+void BulletStoreItem::paint(QPainter *painter, const QStyleOptionGraphicsItem *option, QWidget *widget)
+{
+    Q_UNUSED(option)
+    Q_UNUSED(widget)
+
+    const BulletRenderSnapshot &snapshot = mSnapshot;
+    const int count = snapshot.toX.size();
+    if (count == 0) {
+        return;
+    }
+
+    const float* fromX = snapshot.fromX.constData();
+    const float* fromY = snapshot.fromY.constData();
+    const float* toX = snapshot.toX.constData();
+    const float* toY = snapshot.toY.constData();
+    const float alpha = mAlpha;
+    const QRectF source(0, 0, mPixmap.width(), mPixmap.height());
+    mFragments.resize(count);
+    for (int i = 0; i < count; ++i) {
+        // 片段以中心定位
+        const QPointF center(fromX[i] + (toX[i] - fromX[i]) * alpha, fromY[i] + (toY[i] - fromY[i]) * alpha);
+        mFragments[i] = QPainter::PixmapFragment::create(center, source, BULLET_SCALE, BULLET_SCALE);
+    }
+    painter->drawPixmapFragments(mFragments.constData(), count, mPixmap);
+}
@@ -0,0 +1,50 @@
+#ifndef BULLET_STORE_ITEM_H
+#define BULLET_STORE_ITEM_H
+
+#include <QGraphicsItem>
+#include <QPainter>
+#include <QPixmap>
+#include <QVector>
+
+class BulletStore;
+
+// 敌人子弹的绘制快照：每颗子弹在上一个和当前逻辑帧的位置
+struct BulletRenderSnapshot {
+    QVector<float> fromX;
+    QVector<float> fromY;
+    QVector<float> toX;
+    QVector<float> toY;
+};
+
+// 敌人子弹的绘制层
+// 整个BulletStore作为一个图元，paint()中用drawPixmapFragments一次画出所有子弹，
+// 场景索引中只有这一个图元，不随子弹数量增长。
+// 绘制不直接读取BulletStore：场景补完一个显示帧的逻辑帧后拷贝一份位置快照，
+// 绘制时在最近两个逻辑帧之间插值，显示帧率高于逻辑帧率时子弹移动依然平滑
+class BulletStoreItem : public QGraphicsItem
+{
+public:
+    BulletStoreItem(const QRectF &bounds, QGraphicsItem *parent = nullptr);
+
+    QRectF boundingRect() const override { return mBounds; }
+    void paint(QPainter *painter, const QStyleOptionGraphicsItem *option, QWidget *widget = nullptr) override;
+
+    // 拷贝当前子弹位置作为新的绘制快照
+    void publish(const BulletStore &store);
+    // 插值系数，0为上一个逻辑帧，1为当前逻辑帧
+    void setInterpolation(qreal alpha);
+
+    // 单颗子弹在场景中的尺寸（用于碰撞外扩）
+    QSizeF getBulletSize() const;
+
+private:
+    QRectF mBounds;
+    QPixmap mPixmap;
+    QVector<QPainter::PixmapFragment> mFragments; // 跨帧复用
+    BulletRenderSnapshot mSnapshot; // 跨帧复用
+    float mAlpha;
+
+    static constexpr qreal BULLET_SCALE = 0.5; // 与BulletBase敌人子弹的缩放一致
+};
+
+#endif // BULLET_STORE_ITEM_H
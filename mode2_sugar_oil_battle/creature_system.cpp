@@ -10,25 +10,18 @@
 GameCreature::GameCreature(CreatureType type, QObject *parent)
     : GameObjectBase(parent)
     , mCreatureType(type)
+    , mLifeState(LifeState::Ready)
     , mAnimationFrame(0)
+    , mAnimationAccumulator(0)
+    , mBobPhase(0)
+    , mLifeRemaining(LIFETIME)
+    , mActivationCooldown(0)
     , mSpeed(1.5)
     , mIsFollowingPlayer(true)
+    , mFireCooldown(FIRE_INTERVAL)
     // 音频现在由AudioManager统一管理
 {
-    // 初始化动画定时器
-    mAnimationTimer = new QTimer(this);
-    mAnimationTimer->setInterval(ANIMATION_INTERVAL);
-    connect(mAnimationTimer, &QTimer::timeout, this, &GameCreature::onAnimationTimeout);
-    mAnimationTimer->start();
-    
-    // 初始化移动定时器
-    mMoveTimer = new QTimer(this);
-    mMoveTimer->setInterval(MOVE_INTERVAL);
-    connect(mMoveTimer, &QTimer::timeout, this, &GameCreature::onMoveTimeout);
-    mMoveTimer->start();
-    
-    // 音频现在由AudioManager统一管理
-    
+    // 动画、冷却和寿命都由场景按游戏时钟推进，不再使用QTimer
     setupEffect();
     updatePixmap();
     setScale(0.25);
@@ -37,16 +30,28 @@ GameCreature::GameCreature(CreatureType type, QObject *parent)
 
 GameCreature::~GameCreature()
 {
-    if (mAnimationTimer) {
-        mAnimationTimer->stop();
-    }
-    if (mMoveTimer) {
-        mMoveTimer->stop();
-    }
+}
+
+void GameCreature::resetCreature(CreatureType type)
+{
+    mCreatureType = type;
+    mLifeState = LifeState::Ready;
+    mAnimationFrame = 0;
+    mAnimationAccumulator = 0;
+    mBobPhase = 0;
+    mLifeRemaining = LIFETIME;
+    mActivationCooldown = 0;
+    mIsFollowingPlayer = true;
+    mFireCooldown = FIRE_INTERVAL;
+    setPendingRemoval(false);
+    setupEffect();
+    updatePixmap();
+    setVisible(true);
 }
 
 void GameCreature::setupEffect()
 {
+    mEffect = CreatureEffect();
     switch (mCreatureType) {
     case CREATURE_HELPER: // 健身教练 - 提供攻击力加成
         mEffect.attackBonus = 0.3f; // 30%攻击力加成
@@ -77,51 +82,50 @@ void GameCreature::setupEffect()
 
 void GameCreature::updatePixmap()
 {
-    QString imagePath;
-    
-    // 根据生物类型选择对应的角色图片
-    switch (mCreatureType) {
-    case CREATURE_HELPER:
-        imagePath = ":/images/roles/usagi1.png"; // 使用兔子1作为健身教练
-        break;
-    case CREATURE_GUARDIAN:
-        imagePath = ":/images/roles/usagi2.png"; // 使用兔子2作为营养师
-        break;
-    case CREATURE_HEALER:
-        imagePath = ":/images/roles/usagi3.png"; // 使用兔子3作为私人教练
-        break;
-    case CREATURE_SPEEDSTER:
-        imagePath = ":/images/roles/chimera1.png"; // 使用奇美拉1作为励志大师
-        break;
-    case CREATURE_WARRIOR:
-        imagePath = ":/images/roles/chimera2.png"; // 使用奇美拉2作为健康专家
-        break;
-    }
-    
-    QPixmap pixmap(imagePath);
-    
-    if (pixmap.isNull()) {
-        // 如果没有对应的图片，创建一个简单的彩色圆形
-        pixmap = QPixmap(48, 48);
-        pixmap.fill(Qt::transparent);
-        
-        QPainter painter(&pixmap);
-        painter.setRenderHint(QPainter::Antialiasing);
+    playClip(getClip(mCreatureType));
+}
+
+ClipId GameCreature::getClip(CreatureType type)
+{
+    // 第一次用到时注册；生成和复用生物时只按编号换图，不再解码或绘制
+    static const QVector<ClipId> clips = []() {
+        // 与CreatureType的顺序一致
+        const char* const images[] = {
+            "usagi1",   // 健身教练
+            "usagi2",   // 营养师
+            "usagi3",   // 私人教练
+            "chimera1", // 励志大师
+            "chimera2"  // 健康专家
+        };
+        const QColor colors[] = { Qt::green, Qt::blue, Qt::yellow, Qt::cyan, Qt::magenta };
         
-        QColor colors[] = {Qt::green, Qt::blue, Qt::yellow, Qt::cyan, Qt::magenta};
-        painter.setBrush(colors[static_cast<int>(mCreatureType) % 5]);
-        painter.setPen(Qt::black);
-        painter.drawEllipse(4, 4, 40, 40);
-    }
-    
-    setPixmap(pixmap);
+        AnimationClips* registry = AnimationClips::getInstance();
+        QVector<ClipId> ids;
+        for (int i = 0; i < CREATURE_COUNT; ++i) {
+            // 找不到图片时用彩色圆形代替
+            QPixmap fallback(48, 48);
+            fallback.fill(Qt::transparent);
+            QPainter painter(&fallback);
+            painter.setRenderHint(QPainter::Antialiasing);
+            painter.setBrush(colors[i]);
+            painter.setPen(Qt::black);
+            painter.drawEllipse(4, 4, 40, 40);
+            painter.end();
+            
+            const QString name = QString::fromLatin1(images[i]);
+            ids.append(registry->registerClip("creature/" + name, { ":/img/roles/" + name + ".png" }, 0, fallback));
+        }
+        return ids;
+    }();
+    return clips[qBound(0, static_cast<int>(type), CREATURE_COUNT - 1)];
 }
 
-void GameCreature::activateEffect(SugarOilPlayer* player)
+bool GameCreature::tryActivate(SugarOilPlayer* player)
 {
-    if (!player) return;
+    if (!player || mLifeState != LifeState::Ready) {
+        return false;
+    }
     
-    // 播放激活音效
     // 播放激活音效
     AudioManager::getInstance()->playSound(AudioManager::SoundType::ItemPickup);
     
@@ -129,33 +133,64 @@ void GameCreature::activateEffect(SugarOilPlayer* player)
     
     qDebug() << "Activated creature effect:" << CreatureManager::getCreatureName(mCreatureType);
     
-    // 这里需要在玩家类中实现具体的效果应用逻辑
-    // 目前只是标记效果为激活状态
+    // 持续效果交给玩家的效果调度器
+    player->applyCreatureEffect(mEffect, static_cast<int>(mCreatureType));
+    
+    if (isCombatCreature()) {
+        // 战斗型生物留在场上继续射击，效果结束后才能再次激活
+        mLifeState = LifeState::Cooldown;
+        mActivationCooldown = mEffect.duration;
+    } else {
+        // 普通生物是一次性的
+        mLifeState = LifeState::Expired;
+    }
+    return true;
 }
 
-void GameCreature::updateCreature()
+void GameCreature::updateCreature(qreal dtMs)
 {
-    // 简单的浮动动画
-    static qreal offset = 0;
-    offset += 0.05;
+    if (dtMs <= 0.0 || mLifeState == LifeState::Expired) {
+        return;
+    }
     
-    QPointF currentPos = pos();
-    setPos(currentPos.x(), currentPos.y() + qSin(offset) * 1.5);
+    // 简单的浮动动画，相位每个生物独立
+    const qreal steps = dtMs / ANIMATION_STEP;
+    mBobPhase += 0.05 * steps;
+    setPos(pos().x(), pos().y() + qSin(mBobPhase) * 1.5 * steps);
+    
+    mAnimationAccumulator += dtMs;
+    while (mAnimationAccumulator >= ANIMATION_INTERVAL) {
+        mAnimationAccumulator -= ANIMATION_INTERVAL;
+        mAnimationFrame = (mAnimationFrame + 1) % 4; // 4帧动画循环
+    }
+    
+    if (mLifeState == LifeState::Cooldown) {
+        mActivationCooldown -= dtMs;
+        if (mActivationCooldown <= 0.0) {
+            mEffect.isActive = false;
+            mLifeState = LifeState::Ready;
+        }
+    }
+    
+    mLifeRemaining -= dtMs;
+    if (mLifeRemaining <= 0.0) {
+        mLifeState = LifeState::Expired;
+    }
 }
 
-void GameCreature::moveTowardsPlayer(const QPointF& playerPos)
+bool GameCreature::isCombatCreature() const
 {
-    if (!mIsFollowingPlayer) return;
-    
-    QPointF currentPos = pos();
-    QPointF direction = playerPos - currentPos;
-    qreal distance = qSqrt(direction.x() * direction.x() + direction.y() * direction.y());
-    
-    if (distance > 5.0) { // 如果距离玩家较远，则移动
-        direction /= distance; // 标准化方向向量
-        QPointF newPos = currentPos + direction * mSpeed;
-        setPos(newPos);
+    return mCreatureType == CREATURE_HELPER || mCreatureType == CREATURE_WARRIOR;
+}
+
+bool GameCreature::advanceFireCooldown(qreal dtMs)
+{
+    mFireCooldown -= dtMs;
+    if (mFireCooldown > 0.0) {
+        return false;
     }
+    mFireCooldown += FIRE_INTERVAL;
+    return true;
 }
 
 bool GameCreature::isNearPlayer(const QPointF& playerPos, qreal distance) const
@@ -166,15 +201,38 @@ bool GameCreature::isNearPlayer(const QPointF& playerPos, qreal distance) const
     return actualDistance <= distance;
 }
 
-void GameCreature::onAnimationTimeout()
+GameCreature::SavedState GameCreature::saveState() const
 {
-    updateCreature();
-    mAnimationFrame = (mAnimationFrame + 1) % 4; // 4帧动画循环
+    SavedState state;
+    state.x = pos().x();
+    state.y = pos().y();
+    state.animationAccumulator = mAnimationAccumulator;
+    state.bobPhase = mBobPhase;
+    state.lifeRemaining = mLifeRemaining;
+    state.activationCooldown = mActivationCooldown;
+    state.fireCooldown = mFireCooldown;
+    state.type = static_cast<qint32>(mCreatureType);
+    state.lifeState = static_cast<qint32>(mLifeState);
+    state.animationFrame = mAnimationFrame;
+    state.followingPlayer = mIsFollowingPlayer;
+    state.effectActive = mEffect.isActive;
+    state.reserved[0] = 0;
+    state.reserved[1] = 0;
+    return state;
 }
 
-void GameCreature::onMoveTimeout()
+void GameCreature::restoreState(const SavedState &state)
 {
-    // 移动逻辑在游戏场景中调用 moveTowardsPlayer
+    setPos(state.x, state.y);
+    mAnimationAccumulator = state.animationAccumulator;
+    mBobPhase = state.bobPhase;
+    mLifeRemaining = state.lifeRemaining;
+    mActivationCooldown = state.activationCooldown;
+    mFireCooldown = state.fireCooldown;
+    mLifeState = static_cast<LifeState>(qBound(0, state.lifeState, static_cast<int>(LifeState::Expired)));
+    mAnimationFrame = state.animationFrame;
+    mIsFollowingPlayer = state.followingPlayer;
+    mEffect.isActive = state.effectActive;
 }
 
 // CreatureManager 实现
@@ -186,20 +244,45 @@ CreatureManager::CreatureManager(QObject *parent)
 
 CreatureManager::~CreatureManager()
 {
+    // 池中的生物没有父对象，需要手动释放
+    qDeleteAll(mPool);
+    mPool.clear();
 }
 
 GameCreature* CreatureManager::spawnRandomCreature(const QPointF& position)
 {
     // 随机选择一个生物类型
     int creatureTypeIndex = mRandomGenerator->bounded(5); // 0-4
-    CreatureType type = static_cast<CreatureType>(creatureTypeIndex);
-    
-    GameCreature* creature = new GameCreature(type);
+    return createCreature(static_cast<CreatureType>(creatureTypeIndex), position);
+}
+
+GameCreature* CreatureManager::createCreature(CreatureType type, const QPointF& position)
+{
+    GameCreature* creature = nullptr;
+    if (!mPool.isEmpty()) {
+        creature = mPool.takeLast();
+        creature->resetCreature(type);
+    } else {
+        creature = new GameCreature(type);
+    }
     creature->setPos(position);
     
     return creature;
 }
 
+void CreatureManager::releaseCreature(GameCreature* creature)
+{
+    if (!creature) return;
+    
+    creature->setVisible(false);
+    if (mPool.size() < MAX_POOL_SIZE) {
+        mPool.append(creature);
+    } else {
+        // 池已满，延迟删除
+        creature->deleteLater();
+    }
+}
+
 QString CreatureManager::getCreatureDescription(CreatureType type)
 {
     switch (type) {
@@ -218,20 +301,6 @@ QString CreatureManager::getCreatureDescription(CreatureType type)
     }
 }
 
-void GameCreature::pauseMovement()
-{
-    if (mMoveTimer && mMoveTimer->isActive()) {
-        mMoveTimer->stop();
-    }
-}
-
-void GameCreature::resumeMovement()
-{
-    if (mMoveTimer && !mMoveTimer->isActive()) {
-        mMoveTimer->start(MOVE_INTERVAL);
-    }
-}
-
 QString CreatureManager::getCreatureName(CreatureType type)
 {
     switch (type) {
@@ -3,7 +3,7 @@
 
 #include "sugar_oil_config.h"
 #include "game_object_base.h"
-#include <QTimer>
+#include <QList>
 // 音频现在由AudioManager统一管理
 #include "../audio_manager.h"
 #include <QRandomGenerator>
@@ -30,49 +30,89 @@ class GameCreature : public GameObjectBase
     Q_OBJECT
     
 public:
+    // 生命周期状态
+    enum class LifeState {
+        Ready,      // 可以激活
+        Cooldown,   // 已激活，等待冷却结束（战斗型生物）
+        Expired     // 寿命结束或一次性效果已用掉，等待场景回收
+    };
+    
+    // 快照中的一个生物
+    struct SavedState {
+        qreal x;
+        qreal y;
+        qreal animationAccumulator;
+        qreal bobPhase;
+        qreal lifeRemaining;
+        qreal activationCooldown;
+        qreal fireCooldown;
+        qint32 type;
+        qint32 lifeState;
+        qint32 animationFrame;
+        quint8 followingPlayer;
+        quint8 effectActive;
+        quint8 reserved[2];
+    };
+    
     explicit GameCreature(CreatureType type, QObject *parent = nullptr);
     virtual ~GameCreature();
     
+    // 从对象池取出时重新初始化
+    void resetCreature(CreatureType type);
+    
     CreatureType getCreatureType() const { return mCreatureType; }
     CreatureEffect getEffect() const { return mEffect; }
+    LifeState getLifeState() const { return mLifeState; }
+    bool isExpired() const { return mLifeState == LifeState::Expired; }
     
-    // 激活生物效果
-    void activateEffect(SugarOilPlayer* player);
+    // 尝试激活生物效果，只有Ready状态才会生效，返回是否激活
+    // 普通生物一次性生效后消失，战斗型生物进入冷却后可再次激活
+    bool tryActivate(SugarOilPlayer* player);
     
-    // 更新生物动画和AI
-    void updateCreature();
+    // 按游戏时间推进动画、冷却和寿命
+    void updateCreature(qreal dtMs);
     
-    // 生物移动
-    void moveTowardsPlayer(const QPointF& playerPos);
+    // 生物移动 - 由场景的批量转向系统统一计算
+    bool isFollowingPlayer() const { return mIsFollowingPlayer; }
+    qreal getMoveSpeed() const { return mSpeed; }
+    
+    // 战斗型生物（健身教练、健康专家）会自动向最近的敌人射击
+    bool isCombatCreature() const;
+    // 推进射击冷却（游戏时间），冷却结束时返回true并重新计时
+    bool advanceFireCooldown(qreal dtMs);
     
     // 检查是否靠近玩家
     bool isNearPlayer(const QPointF& playerPos, qreal distance = 50.0) const;
     
-    // 移动控制
-    void pauseMovement();
-    void resumeMovement();
+    // 快照：类型在创建时确定，这里恢复位置、寿命和各项冷却
+    SavedState saveState() const;
+    void restoreState(const SavedState &state);
     
 protected:
     void updatePixmap();
+    // 每种生物一个片段，所有实例共用，图片来自预载好的AssetCache
+    static ClipId getClip(CreatureType type);
     void setupEffect();
     
-private slots:
-    void onAnimationTimeout();
-    void onMoveTimeout();
-    
 private:
     CreatureType mCreatureType;
     CreatureEffect mEffect;
-    QTimer* mAnimationTimer;
-    QTimer* mMoveTimer;
+    LifeState mLifeState;
     int mAnimationFrame;
+    qreal mAnimationAccumulator; // 距上次切换动画帧经过的时间（毫秒）
+    qreal mBobPhase;             // 浮动动画相位，每个生物独立
+    qreal mLifeRemaining;        // 剩余寿命（毫秒）
+    qreal mActivationCooldown;   // 激活冷却剩余时间（毫秒）
     qreal mSpeed;
     bool mIsFollowingPlayer;
+    qreal mFireCooldown; // 距下次射击的剩余时间（毫秒）
     
     // 音效现在由AudioManager统一管理
     
     static const int ANIMATION_INTERVAL = 400; // 动画帧间隔
-    static const int MOVE_INTERVAL = 30;       // 移动更新间隔，优化性能
+    static const int ANIMATION_STEP = 16;      // 浮动动画按16ms一步计算相位
+    static const int LIFETIME = 45000;         // 生物存在45秒后消失
+    static const int FIRE_INTERVAL = 800;      // 战斗型生物的射击间隔
 };
 
 // 生物管理器
@@ -84,9 +124,18 @@ public:
     explicit CreatureManager(QObject *parent = nullptr);
     virtual ~CreatureManager();
     
-    // 生成随机生物
+    // 生成随机生物，优先复用对象池中的实例
     GameCreature* spawnRandomCreature(const QPointF& position);
     
+    // 生成指定类型的生物（读档时使用），同样优先复用对象池
+    GameCreature* createCreature(CreatureType type, const QPointF& position);
+    
+    // 使用场景的随机数生成器（可按种子复现）
+    void setRandomGenerator(QRandomGenerator* generator) { mRandomGenerator = generator; }
+    
+    // 回收生物到对象池（调用方需先从场景中移除）
+    void releaseCreature(GameCreature* creature);
+    
     // 获取生物效果描述
     static QString getCreatureDescription(CreatureType type);
     
@@ -95,6 +144,9 @@ public:
     
 private:
     QRandomGenerator* mRandomGenerator;
+    QList<GameCreature*> mPool;
+    
+    static const int MAX_POOL_SIZE = 8;
 };
 
 #endif // CREATURE_SYSTEM_H
\ No newline at end of file
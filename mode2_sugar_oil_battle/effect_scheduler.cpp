@@ -0,0 +1,224 @@
+#include "effect_scheduler.h"
+#include "../snapshot_io.h"
+#include <algorithm>
+
+namespace
+{
+    const quint32 SNAPSHOT_TAG = 0x54434645; // "EFCT"
+    const int MAX_SAVED_EFFECTS = 4096;
+}
+
+EffectScheduler::EffectScheduler()
+    : mNow(0)
+    , mActiveCount(0)
+{
+    recomputeCache();
+}
+
+void EffectScheduler::apply(EffectStat stat, double value, qint64 durationMs, EffectStackRule rule, int sourceKey)
+{
+    if (durationMs <= 0) {
+        return;
+    }
+
+    const int existing = (rule == EffectStackRule::Additive) ? -1 : findEffect(stat, sourceKey);
+    if (existing >= 0) {
+        Effect &effect = mEffects[existing];
+        if (rule == EffectStackRule::Refresh) {
+            effect.value = value;
+            effect.expiresAt = mNow + durationMs;
+        } else {
+            effect.expiresAt += durationMs;
+        }
+        ++effect.generation;
+        schedule(existing);
+    } else {
+        const int slot = allocateSlot();
+        Effect &effect = mEffects[slot];
+        effect.stat = stat;
+        effect.sourceKey = sourceKey;
+        effect.value = value;
+        effect.expiresAt = mNow + durationMs;
+        ++effect.generation;
+        effect.active = true;
+        ++mActiveCount;
+        schedule(slot);
+    }
+
+    recomputeCache();
+}
+
+void EffectScheduler::advanceTo(qint64 nowMs)
+{
+    mNow = nowMs;
+
+    bool changed = false;
+    while (!mHeap.isEmpty() && mHeap.first().expiresAt <= mNow) {
+        std::pop_heap(mHeap.begin(), mHeap.end(), &EffectScheduler::laterExpiry);
+        const HeapEntry entry = mHeap.takeLast();
+
+        Effect &effect = mEffects[entry.slot];
+        // 刷新或延长过的效果，旧的堆条目直接丢弃
+        if (!effect.active || effect.generation != entry.generation) {
+            continue;
+        }
+        effect.active = false;
+        --mActiveCount;
+        mFreeSlots.append(entry.slot);
+        changed = true;
+    }
+
+    if (changed) {
+        recomputeCache();
+    }
+}
+
+void EffectScheduler::clear()
+{
+    mEffects.clear();
+    mFreeSlots.clear();
+    mHeap.clear();
+    mNow = 0;
+    mActiveCount = 0;
+    recomputeCache();
+}
+
+qint64 EffectScheduler::getRemaining(EffectStat stat) const
+{
+    qint64 remaining = 0;
+    for (const Effect &effect : mEffects) {
+        if (effect.active && effect.stat == stat) {
+            remaining = qMax(remaining, effect.expiresAt - mNow);
+        }
+    }
+    return remaining;
+}
+
+void EffectScheduler::saveState(SnapshotWriter &writer) const
+{
+    // 与writeArray格式相同（元素数 + 连续记录），逐条写入，自动存档时不建临时数组
+    qint32 activeCount = 0;
+    for (const Effect &effect : mEffects) {
+        activeCount += effect.active ? 1 : 0;
+    }
+
+    writer.beginSection(SNAPSHOT_TAG);
+    writer.write(mNow);
+    writer.write(activeCount);
+    for (const Effect &effect : mEffects) {
+        if (effect.active) {
+            writer.write(SavedEffect{ static_cast<qint32>(effect.stat), effect.sourceKey, effect.value, effect.expiresAt });
+        }
+    }
+}
+
+bool EffectScheduler::restoreState(SnapshotReader &reader)
+{
+    clear();
+    QVector<SavedEffect> saved;
+    if (!reader.expectSection(SNAPSHOT_TAG) || !reader.read(mNow) || !reader.readArray(saved, MAX_SAVED_EFFECTS)) {
+        return false;
+    }
+
+    for (const SavedEffect &entry : saved) {
+        if (entry.stat < 0 || entry.stat >= static_cast<int>(EffectStat::Count)) {
+            continue;
+        }
+        const int slot = allocateSlot();
+        Effect &effect = mEffects[slot];
+        effect.stat = static_cast<EffectStat>(entry.stat);
+        effect.sourceKey = entry.sourceKey;
+        effect.value = entry.value;
+        effect.expiresAt = entry.expiresAt;
+        ++effect.generation;
+        effect.active = true;
+        ++mActiveCount;
+        schedule(slot);
+    }
+    recomputeCache();
+    return true;
+}
+
+int EffectScheduler::findEffect(EffectStat stat, int sourceKey) const
+{
+    for (int i = 0; i < mEffects.size(); ++i) {
+        const Effect &effect = mEffects[i];
+        if (effect.active && effect.stat == stat && effect.sourceKey == sourceKey) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+int EffectScheduler::allocateSlot()
+{
+    if (!mFreeSlots.isEmpty()) {
+        return mFreeSlots.takeLast();
+    }
+    Effect effect;
+    effect.stat = EffectStat::Speed;
+    effect.sourceKey = 0;
+    effect.value = 1.0;
+    effect.expiresAt = 0;
+    effect.generation = 0;
+    effect.active = false;
+    mEffects.append(effect);
+    return mEffects.size() - 1;
+}
+
+void EffectScheduler::schedule(int slot)
+{
+    const Effect &effect = mEffects[slot];
+    mHeap.append({ effect.expiresAt, slot, effect.generation });
+    std::push_heap(mHeap.begin(), mHeap.end(), &EffectScheduler::laterExpiry);
+
+    // 同一效果被频繁刷新时旧条目会堆积，超过有效数量太多就重建一次
+    if (mHeap.size() > 4 * mActiveCount + 16) {
+        compactHeap();
+    }
+}
+
+bool EffectScheduler::laterExpiry(const HeapEntry &a, const HeapEntry &b)
+{
+    // 最小堆比较：到期越早越靠前
+    return a.expiresAt > b.expiresAt;
+}
+
+void EffectScheduler::compactHeap()
+{
+    // 原地保留有效条目再重新建堆；resize缩小时保留容量，不产生堆分配
+    int live = 0;
+    for (int i = 0; i < mHeap.size(); ++i) {
+        const HeapEntry entry = mHeap[i];
+        const Effect &effect = mEffects[entry.slot];
+        if (effect.active && effect.generation == entry.generation) {
+            mHeap[live++] = entry;
+        }
+    }
+    mHeap.resize(live);
+    std::make_heap(mHeap.begin(), mHeap.end(), &EffectScheduler::laterExpiry);
+}
+
+void EffectScheduler::recomputeCache()
+{
+    const int statCount = static_cast<int>(EffectStat::Count);
+    for (int i = 0; i < statCount; ++i) {
+        mCachedValues[i] = 1.0;
+        mActiveCounts[i] = 0;
+    }
+    mCachedValues[static_cast<int>(EffectStat::HealthRegen)] = 0.0;
+
+    for (const Effect &effect : mEffects) {
+        if (!effect.active) {
+            continue;
+        }
+        const int stat = static_cast<int>(effect.stat);
+        ++mActiveCounts[stat];
+        if (effect.stat == EffectStat::HealthRegen) {
+            mCachedValues[stat] += effect.value;
+        } else {
+            // 不同来源的加成相加而不是相乘，避免叠加后数值爆炸
+            mCachedValues[stat] += effect.value - 1.0;
+        }
+    }
+}
@@ -0,0 +1,104 @@
+#ifndef EFFECT_SCHEDULER_H
+#define EFFECT_SCHEDULER_H
+
+#include <QtGlobal>
+#include <QVector>
+
+class SnapshotWriter;
+class SnapshotReader;
+
+// 效果作用的属性
+enum class EffectStat {
+    Speed = 0,        // 速度倍数
+    Attack,           // 攻击力倍数
+    Defense,          // 防御力倍数
+    Experience,       // 经验倍数
+    HealthRegen,      // 每秒生命恢复（数值相加）
+    FastShooting,     // 快速射击（开关）
+    Magnetism,        // 磁力吸引（开关）
+    Invincible,       // 无敌（开关）
+    Count
+};
+
+// 同一来源重复施加时的叠加规则
+enum class EffectStackRule {
+    Refresh,   // 替换数值并重置持续时间
+    Extend,    // 保留数值，在剩余时间上追加持续时间
+    Additive   // 作为新的独立实例叠加
+};
+
+// 限时效果调度器
+// 所有效果按游戏时钟上的到期时刻放进最小堆，每帧advanceTo()只弹出已到期的效果，
+// 不需要为每个效果单独开QTimer；游戏暂停时时钟不前进，效果自然随之暂停。
+// 各属性的合计倍数在效果变化时重新计算并缓存，查询是O(1)
+class EffectScheduler
+{
+public:
+    EffectScheduler();
+
+    // 施加效果，sourceKey标识效果来源（如道具类型），用于判断叠加规则
+    // 倍数类属性value为倍数（1.5表示+50%），开关类属性value被忽略
+    void apply(EffectStat stat, double value, qint64 durationMs, EffectStackRule rule, int sourceKey);
+
+    // 推进到游戏时间nowMs，移除所有已到期的效果
+    void advanceTo(qint64 nowMs);
+
+    // 清除所有效果并把时间归零（新一局游戏）
+    void clear();
+
+    // 缓存的合计值：倍数类属性为 1 + Σ(倍数 - 1)，HealthRegen为数值之和
+    double getValue(EffectStat stat) const { return mCachedValues[static_cast<int>(stat)]; }
+    bool isActive(EffectStat stat) const { return mActiveCounts[static_cast<int>(stat)] > 0; }
+
+    // 剩余时间（毫秒），多个实例时取最长
+    qint64 getRemaining(EffectStat stat) const;
+
+    qint64 getNow() const { return mNow; }
+    int getActiveCount() const { return mActiveCount; }
+
+    // 快照：当前时间和所有生效中的效果（按到期时刻重新入堆）
+    void saveState(SnapshotWriter &writer) const;
+    bool restoreState(SnapshotReader &reader);
+
+private:
+    struct Effect {
+        EffectStat stat;
+        int sourceKey;
+        double value;
+        qint64 expiresAt;
+        quint32 generation; // 每次刷新/延长递增，使堆中的旧条目失效
+        bool active;
+    };
+
+    struct HeapEntry {
+        qint64 expiresAt;
+        int slot;
+        quint32 generation;
+    };
+
+    // 快照中的一条效果
+    struct SavedEffect {
+        qint32 stat;
+        qint32 sourceKey;
+        double value;
+        qint64 expiresAt;
+    };
+
+    int findEffect(EffectStat stat, int sourceKey) const;
+    int allocateSlot();
+    void schedule(int slot);
+    void compactHeap();
+    static bool laterExpiry(const HeapEntry &a, const HeapEntry &b);
+    void recomputeCache();
+
+    QVector<Effect> mEffects;
+    QVector<int> mFreeSlots;
+    QVector<HeapEntry> mHeap;
+    qint64 mNow;
+    int mActiveCount;
+
+    double mCachedValues[static_cast<int>(EffectStat::Count)];
+    int mActiveCounts[static_cast<int>(EffectStat::Count)];
+};
+
+#endif // EFFECT_SCHEDULER_H
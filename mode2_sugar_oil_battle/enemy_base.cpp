@@ -16,20 +16,15 @@ EnemyBase::EnemyBase(QObject *parent)
     , mMoveRight(true)
     , mFaceRight(true)
     , mPlayer(nullptr)
-    , mAITimer(nullptr)
-    , mSkillTimer(nullptr)
+    , mSkillScheduler(nullptr)
+    , mSkillHandle(SkillScheduler::INVALID_HANDLE)
     , mAICounter(0)
+    , mAIActive(false)
+    , mAIAccumulator(0.0)
+    , mAILevel(AILevel::Full)
+    , mSpawnId(0)
+    , mPatternPhase(0.0f)
 {
-    // 初始化AI定时器
-    mAITimer = new QTimer(this);
-    mAITimer->setInterval(AI_UPDATE_INTERVAL);
-    connect(mAITimer, &QTimer::timeout, this, &EnemyBase::onAITimeout);
-    
-    // 初始化技能定时器
-    mSkillTimer = new QTimer(this);
-    mSkillTimer->setSingleShot(true);
-    connect(mSkillTimer, &QTimer::timeout, this, &EnemyBase::onSkillTimeout);
-    
     // 音效播放现在由AudioManager统一管理
 }
 
@@ -44,20 +39,15 @@ EnemyBase::EnemyBase(SugarOilPlayer* player, int hp, int attackPoint, qreal spee
     , mMoveRight(true)
     , mFaceRight(true)
     , mPlayer(player)
-    , mAITimer(nullptr)
-    , mSkillTimer(nullptr)
+    , mSkillScheduler(nullptr)
+    , mSkillHandle(SkillScheduler::INVALID_HANDLE)
     , mAICounter(0)
+    , mAIActive(false)
+    , mAIAccumulator(0.0)
+    , mAILevel(AILevel::Full)
+    , mSpawnId(0)
+    , mPatternPhase(0.0f)
 {
-    // 初始化AI定时器
-    mAITimer = new QTimer(this);
-    mAITimer->setInterval(AI_UPDATE_INTERVAL);
-    connect(mAITimer, &QTimer::timeout, this, &EnemyBase::onAITimeout);
-    
-    // 初始化技能定时器
-    mSkillTimer = new QTimer(this);
-    mSkillTimer->setSingleShot(true);
-    connect(mSkillTimer, &QTimer::timeout, this, &EnemyBase::onSkillTimeout);
-    
     // 初始化音效 (Qt5兼容)
     // 音效播放现在由AudioManager统一管理
     
@@ -66,14 +56,46 @@ EnemyBase::EnemyBase(SugarOilPlayer* player, int hp, int attackPoint, qreal spee
     setZValue(3);
 }
 
+const CrowdSteeringParams* EnemyBase::getCrowdParamsTable()
+{
+    // 分离半径/权重, 聚合半径/权重
+    // 体型大的敌人分得更开；奶茶、小蛋糕聚合更强，成群出现
+    static const CrowdSteeringParams table[ENEMY_TYPE_COUNT] = {
+        { 24.0f, 1.2f, 48.0f, 0.15f }, // 炸鸡
+        { 26.0f, 1.2f, 48.0f, 0.10f }, // 烧烤
+        { 20.0f, 1.0f, 64.0f, 0.30f }, // 奶茶
+        { 28.0f, 1.5f, 40.0f, 0.05f }, // 螺蛳粉
+        { 20.0f, 1.0f, 64.0f, 0.25f }  // 小蛋糕
+    };
+    return table;
+}
+
 EnemyBase::~EnemyBase()
 {
-    if (mAITimer) {
-        mAITimer->stop();
-    }
-    if (mSkillTimer) {
-        mSkillTimer->stop();
-    }
+    // 技能脚本在stopAI()中取消；场景销毁时调度器可能已先于敌人析构，这里不再访问
+}
+
+void EnemyBase::resetEnemy(int hp, int attackPoint, qreal speed, int expValue, EnemyType type)
+{
+    mHP = hp;
+    mMaxHP = hp;
+    mAttackPoint = attackPoint;
+    mSpeed = speed;
+    mExpValue = expValue;
+    mEnemyType = type;
+    mMoveRight = true;
+    mFaceRight = true;
+    mSkillHandle = SkillScheduler::INVALID_HANDLE;
+    mAICounter = 0;
+    mAIActive = false;
+    mAIAccumulator = 0.0;
+    mAILevel = AILevel::Full;
+    mSpawnId = 0;
+    mPatternPhase = 0.0f;
+    setPendingRemoval(false);
+    updatePixmap();
+    setAnimationFrame(0);
+    setVisible(true);
 }
 
 
@@ -100,35 +122,42 @@ void EnemyBase::takeDamage(int damage)
 
 void EnemyBase::attack()
 {
-    if (!mPlayer) {
+    firePattern(BulletPatternId::Aimed);
+}
+
+void EnemyBase::firePattern(BulletPatternId pattern)
+{
+    // 屏幕外的敌人不开火
+    if (!mPlayer || mAILevel != AILevel::Full) {
         return;
     }
     
-    // 计算攻击方向（朝向玩家）
-    QPointF direction = getDirectionToPlayer();
+    const BulletPattern &params = BulletPatterns::getPattern(pattern);
+    float baseAngle;
+    if (params.aimed) {
+        // 计算攻击方向（朝向玩家）
+        const QPointF direction = getDirectionToPlayer();
+        baseAngle = static_cast<float>(qRadiansToDegrees(qAtan2(direction.y(), direction.x())));
+    } else {
+        baseAngle = mPatternPhase;
+        mPatternPhase = std::fmod(mPatternPhase + params.rotationStep, 360.0f);
+    }
     
     // 发射攻击信号
-    emit enemyAttack(this, getCenterPos(), direction, mAttackPoint);
+    emit enemyFirePattern(this, static_cast<int>(pattern), getCenterPos(), baseAngle, mAttackPoint);
 }
 
-void EnemyBase::moveEnemy()
+void EnemyBase::applySteering(const QPointF &newCenter)
 {
-    if (!mPlayer) {
-        return;
-    }
-    
-    // 简单的追踪AI：朝玩家方向移动
-    QPointF direction = getDirectionToPlayer();
+    QPointF oldCenter = getCenterPos();
+    qreal dx = newCenter.x() - oldCenter.x();
     
-    qreal dx = direction.x() * mSpeed;
-    qreal dy = direction.y() * mSpeed;
+    setPos(pos() + (newCenter - oldCenter));
     
-    moveBy(dx, dy);
-    
-    // 更新面朝方向
-    if (dx > 0) {
+    // 更新面朝方向，只在方向改变时刷新图像
+    if (dx > 0 && !mFaceRight) {
         setFaceDirection(true);
-    } else if (dx < 0) {
+    } else if (dx < 0 && mFaceRight) {
         setFaceDirection(false);
     }
 }
@@ -137,8 +166,7 @@ void EnemyBase::updateAI()
 {
     mAICounter++;
     
-    // 移动
-    moveEnemy();
+    // 移动由场景每帧的批量转向统一处理
     
     // 根据糖油混合物敌人类型执行不同的AI行为
     switch (mEnemyType) {
@@ -185,117 +213,221 @@ void EnemyBase::updateAI()
     }
 }
 
+const SkillScript* EnemyBase::getSkillScript() const
+{
+    // 基础技能：间隔200ms连续瞄准攻击3次
+    static const SkillOp burstOps[] = {
+        { SkillOp::Fire, 0 },
+        { SkillOp::Wait, 200 },
+        { SkillOp::Fire, 0 },
+        { SkillOp::Wait, 200 },
+        { SkillOp::Fire, 0 }
+    };
+    // 奶茶：两轮扇形后接一圈环形
+    static const SkillOp milkTeaOps[] = {
+        { SkillOp::Pattern, static_cast<int>(BulletPatternId::Fan) },
+        { SkillOp::Wait, 300 },
+        { SkillOp::Pattern, static_cast<int>(BulletPatternId::Fan) },
+        { SkillOp::Wait, 300 },
+        { SkillOp::Pattern, static_cast<int>(BulletPatternId::Ring) }
+    };
+    // 螺蛳粉：连续旋转的四臂螺旋
+    static const SkillOp spiralOps[] = {
+        { SkillOp::Pattern, static_cast<int>(BulletPatternId::Spiral) },
+        { SkillOp::Wait, 100 },
+        { SkillOp::Pattern, static_cast<int>(BulletPatternId::Spiral) },
+        { SkillOp::Wait, 100 },
+        { SkillOp::Pattern, static_cast<int>(BulletPatternId::Spiral) },
+        { SkillOp::Wait, 100 },
+        { SkillOp::Pattern, static_cast<int>(BulletPatternId::Spiral) },
+        { SkillOp::Wait, 100 },
+        { SkillOp::Pattern, static_cast<int>(BulletPatternId::Spiral) },
+        { SkillOp::Wait, 100 },
+        { SkillOp::Pattern, static_cast<int>(BulletPatternId::Spiral) }
+    };
+    static const SkillScript burst = { burstOps, int(sizeof(burstOps) / sizeof(burstOps[0])) };
+    static const SkillScript milkTea = { milkTeaOps, int(sizeof(milkTeaOps) / sizeof(milkTeaOps[0])) };
+    static const SkillScript spiral = { spiralOps, int(sizeof(spiralOps) / sizeof(spiralOps[0])) };
+    
+    switch (mEnemyType) {
+    case EnemyType::MilkTea:
+        return &milkTea;
+    case EnemyType::SpiralShellNoodles:
+        return &spiral;
+    default:
+        return &burst;
+    }
+}
+
 void EnemyBase::startSkill()
 {
-    // 基础技能：连续攻击
-    for (int i = 0; i < 3; i++) {
-        QTimer::singleShot(i * 200, this, [this]() {
-            attack();
-        });
+    if (!mSkillScheduler) {
+        attack();
+        return;
     }
     
-    // 设置技能冷却
-    mSkillTimer->start(SKILL_COOLDOWN);
+    // 上一次技能还没放完时不叠加
+    if (mSkillScheduler->isRunning(mSkillHandle)) {
+        return;
+    }
+    mSkillHandle = mSkillScheduler->start(this, getSkillScript());
 }
 
-void EnemyBase::startAI()
+void EnemyBase::advanceAI(qreal dtMs)
 {
-    if (mAITimer && !mAITimer->isActive()) {
-        mAITimer->start();
+    if (!mAIActive || mHP <= 0 || dtMs <= 0.0) {
+        return;
+    }
+    
+    // 按固定的AI间隔执行决策，时间缩放只影响累计速度
+    mAIAccumulator += dtMs;
+    while (mAIActive && mAIAccumulator >= AI_UPDATE_INTERVAL) {
+        mAIAccumulator -= AI_UPDATE_INTERVAL;
+        updateAI();
     }
 }
 
-void EnemyBase::stopAI()
+void EnemyBase::updateAILevel(const QPointF &playerCenter, const QRectF &screenRect)
 {
-    if (mAITimer) {
-        mAITimer->stop();
-    }
-    if (mSkillTimer) {
-        mSkillTimer->stop();
+    mAILevel = chooseAILevel(mAILevel, getCenterPos(), playerCenter, screenRect);
+}
+
+EnemyBase::AILevel EnemyBase::chooseAILevel(AILevel current, const QPointF &center,
+                                            const QPointF &playerCenter, const QRectF &screenRect)
+{
+    // 已在屏幕内的敌人要离开屏幕一段距离才算屏幕外
+    const qreal margin = (current == AILevel::Full) ? LOD_SCREEN_MARGIN : 0;
+    const bool onScreen = screenRect.adjusted(-margin, -margin, margin, margin).contains(center);
+    if (onScreen) {
+        return AILevel::Full;
     }
+    
+    const QPointF diff = center - playerCenter;
+    const qreal distanceSq = diff.x() * diff.x() + diff.y() * diff.y();
+    const qreal farThreshold = (current == AILevel::Coarse) ? LOD_FAR_EXIT : LOD_FAR_ENTER;
+    return (distanceSq > farThreshold * farThreshold) ? AILevel::Coarse : AILevel::Reduced;
 }
 
-void EnemyBase::stopAllTimers()
+int EnemyBase::getSteeringStride() const
 {
-    // 停止AI定时器
-    if (mAITimer) {
-        mAITimer->stop();
+    switch (mAILevel) {
+    case AILevel::Reduced:
+        return REDUCED_STEERING_STRIDE;
+    case AILevel::Coarse:
+        return COARSE_STEERING_STRIDE;
+    default:
+        return 1;
     }
-    // 停止技能定时器
-    if (mSkillTimer) {
-        mSkillTimer->stop();
+}
+
+EnemyBase::SavedState EnemyBase::saveState() const
+{
+    SavedState state;
+    state.x = pos().x();
+    state.y = pos().y();
+    state.speed = mSpeed;
+    state.aiAccumulator = mAIAccumulator;
+    state.skillWakeAt = 0.0;
+    state.type = static_cast<qint32>(mEnemyType);
+    state.hp = mHP;
+    state.maxHp = mMaxHP;
+    state.attackPoint = mAttackPoint;
+    state.expValue = mExpValue;
+    state.aiCounter = mAICounter;
+    state.aiLevel = static_cast<qint32>(mAILevel);
+    state.skillPc = 0;
+    state.spawnId = mSpawnId;
+    state.patternPhase = mPatternPhase;
+    state.moveRight = mMoveRight;
+    state.faceRight = mFaceRight;
+    state.aiActive = mAIActive;
+    state.reserved = 0;
+    
+    int pc = 0;
+    qreal wakeAt = 0.0;
+    if (mSkillScheduler && mSkillScheduler->getTaskState(mSkillHandle, pc, wakeAt)) {
+        state.skillPc = pc;
+        state.skillWakeAt = wakeAt;
     }
+    return state;
 }
 
-void EnemyBase::resumeAllTimers()
+void EnemyBase::restoreState(const SavedState &state)
 {
-    // 只有在游戏运行且敌人存活时才恢复定时器
-    if (mHP > 0) {
-        if (mAITimer && !mAITimer->isActive()) {
-            mAITimer->start();
-        }
-        // 技能定时器根据需要恢复（通常是单次触发，不需要自动恢复）
+    // 类型在生成时已确定（决定图像），这里只恢复可变状态
+    setPos(state.x, state.y);
+    mSpeed = state.speed;
+    mAIAccumulator = state.aiAccumulator;
+    mHP = state.hp;
+    mMaxHP = state.maxHp;
+    mAttackPoint = state.attackPoint;
+    mExpValue = state.expValue;
+    mAICounter = state.aiCounter;
+    mAILevel = static_cast<AILevel>(qBound(0, state.aiLevel, AI_LEVEL_COUNT - 1));
+    mSpawnId = state.spawnId;
+    mPatternPhase = state.patternPhase;
+    mMoveRight = state.moveRight;
+    mAIActive = state.aiActive;
+    
+    if (mFaceRight != static_cast<bool>(state.faceRight)) {
+        setFaceDirection(state.faceRight);
+    }
+    
+    mSkillHandle = SkillScheduler::INVALID_HANDLE;
+    if (mSkillScheduler && mAIActive && state.skillPc > 0) {
+        mSkillHandle = mSkillScheduler->resume(this, getSkillScript(), state.skillPc, state.skillWakeAt);
     }
 }
 
-void EnemyBase::onAITimeout()
+void EnemyBase::startAI()
 {
-    updateAI();
+    mAIActive = true;
 }
 
-void EnemyBase::onSkillTimeout()
+void EnemyBase::stopAI()
 {
-    // 技能冷却结束，可以再次使用技能
+    mAIActive = false;
+    // 取消正在执行的技能脚本，死亡或移除后不会再开火
+    if (mSkillScheduler) {
+        mSkillScheduler->cancel(mSkillHandle);
+    }
+    mSkillHandle = SkillScheduler::INVALID_HANDLE;
 }
 
 void EnemyBase::updatePixmap()
 {
-    QString imagePath;
-    
-    // 根据糖油混合物敌人类型选择图像
-    switch (mEnemyType) {
-    case EnemyType::FriedChicken:
-        imagePath = mFaceRight ? ":/img/roles/chimera1.png" : ":/img/roles/chimera1-mir.png";
-        break;
-    case EnemyType::Barbecue:
-        imagePath = mFaceRight ? ":/img/roles/chimera2.png" : ":/img/roles/chimera2-mir.png";
-        break;
-    case EnemyType::MilkTea:
-        imagePath = mFaceRight ? ":/img/roles/chimera3.png" : ":/img/roles/chimera3-mir.png";
-        break;
-    case EnemyType::SpiralShellNoodles:
-        imagePath = mFaceRight ? ":/img/roles/chimera4.png" : ":/img/roles/chimera4-mir.png";
-        break;
-    case EnemyType::SmallCake:
-        imagePath = mFaceRight ? ":/img/roles/chimera5.png" : ":/img/roles/chimera5-mir.png";
-        break;
-    }
-    
-    QPixmap pixmap(imagePath);
-    if (!pixmap.isNull()) {
-        setPixmap(pixmap);
-    } else {
-        // 如果找不到图像，创建一个简单的彩色矩形
-        QPixmap defaultPixmap(40, 40);
-        switch (mEnemyType) {
-        case EnemyType::FriedChicken:
-            defaultPixmap.fill(QColor(255, 165, 0)); // 橙色 - 炸鸡
-            break;
-        case EnemyType::Barbecue:
-            defaultPixmap.fill(QColor(139, 69, 19)); // 棕色 - 烧烤
-            break;
-        case EnemyType::MilkTea:
-            defaultPixmap.fill(QColor(210, 180, 140)); // 奶茶色
-            break;
-        case EnemyType::SpiralShellNoodles:
-            defaultPixmap.fill(QColor(255, 0, 0)); // 红色 - 螺蛳粉
-            break;
-        case EnemyType::SmallCake:
-            defaultPixmap.fill(QColor(255, 192, 203)); // 粉色 - 小蛋糕
-            break;
+    playClip(getClip(mEnemyType, mFaceRight));
+}
+
+ClipId EnemyBase::getClip(EnemyType type, bool faceRight)
+{
+    // 每种糖油混合物敌人朝左、朝右各一个片段，所有实例共用，第一次用到时注册
+    static const QVector<ClipId> clips = []() {
+        struct Archetype {
+            const char* image;
+            QColor color; // 找不到图像时用的彩色方块
+        };
+        const Archetype archetypes[] = {
+            { "chimera1", QColor(255, 165, 0) },   // 橙色 - 炸鸡
+            { "chimera2", QColor(139, 69, 19) },   // 棕色 - 烧烤
+            { "chimera3", QColor(210, 180, 140) }, // 奶茶色
+            { "chimera4", QColor(255, 0, 0) },     // 红色 - 螺蛳粉
+            { "chimera5", QColor(255, 192, 203) }  // 粉色 - 小蛋糕
+        };
+        
+        AnimationClips* registry = AnimationClips::getInstance();
+        QVector<ClipId> ids;
+        for (const Archetype &archetype : archetypes) {
+            QPixmap fallback(40, 40);
+            fallback.fill(archetype.color);
+            const QString name = QString::fromLatin1(archetype.image);
+            const QString path = ":/img/roles/" + name;
+            ids.append(registry->registerClip(name + "/left", { path + "-mir.png" }, 0, fallback));
+            ids.append(registry->registerClip(name + "/right", { path + ".png" }, 0, fallback));
         }
-        setPixmap(defaultPixmap);
-    }
+        return ids;
+    }();
+    return clips[static_cast<int>(type) * 2 + (faceRight ? 1 : 0)];
 }
 
 void EnemyBase::playHurtSound()
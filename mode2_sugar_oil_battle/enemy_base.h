@@ -2,7 +2,9 @@
 #define ENEMY_BASE_H
 
 #include "game_object_base.h"
-#include <QTimer>
+#include "steering_system.h"
+#include "skill_scheduler.h"
+#include "bullet_patterns.h"
 #include "../audio_manager.h"
 #include <QRandomGenerator>
 
@@ -13,6 +15,14 @@ class EnemyBase : public GameObjectBase
     Q_OBJECT
 
 public:
+    // AI细节等级：屏幕内完整AI；屏幕外降低转向频率且不开火；远离玩家时只做粗略的批量移动
+    enum class AILevel {
+        Full = 0,
+        Reduced = 1,
+        Coarse = 2
+    };
+    static const int AI_LEVEL_COUNT = 3;
+
     enum class EnemyType {
         FriedChicken = 0,    // 炸鸡
         Barbecue = 1,        // 烧烤
@@ -20,10 +30,36 @@ public:
         SpiralShellNoodles = 3, // 螺蛳粉
         SmallCake = 4        // 小蛋糕
     };
+    
+    // 快照中的一个敌人（定长记录，整个敌人列表一次写入）
+    struct SavedState {
+        qreal x;
+        qreal y;
+        qreal speed;
+        qreal aiAccumulator;
+        qreal skillWakeAt;
+        qint32 type;
+        qint32 hp;
+        qint32 maxHp;
+        qint32 attackPoint;
+        qint32 expValue;
+        qint32 aiCounter;
+        qint32 aiLevel;
+        qint32 skillPc;      // 技能脚本的下一条指令，0表示没有正在执行的技能
+        quint32 spawnId;
+        float patternPhase;
+        quint8 moveRight;
+        quint8 faceRight;
+        quint8 aiActive;
+        quint8 reserved;
+    };
 
     explicit EnemyBase(QObject *parent = nullptr);
     EnemyBase(SugarOilPlayer* player, int hp, int attackPoint, qreal speed, int expValue, EnemyType type, QObject *parent = nullptr);
     virtual ~EnemyBase();
+    
+    // 对象池复用：恢复到刚构造时的状态并显示，信号连接和技能调度器保持不变
+    void resetEnemy(int hp, int attackPoint, qreal speed, int expValue, EnemyType type);
 
     // 基础属性
     int getHP() const { return mHP; }
@@ -44,36 +80,64 @@ public:
     // 战斗相关
     virtual void takeDamage(int damage);
     virtual void attack();
+    // 发射一次弹幕图案：瞄准类图案以玩家方向为中心，环形/螺旋从自身的旋转相位开始
+    void firePattern(BulletPatternId pattern);
+    
+    // 移动 - 由场景的批量转向系统统一计算，这里只负责写回结果
+    void applySteering(const QPointF &newCenter);
+    qreal getSpeedPerTick(int tickInterval) const { return mSpeed * tickInterval / AI_UPDATE_INTERVAL; }
     
-    // 移动
-    virtual void moveEnemy();
+    // 群体转向参数表，按EnemyType的值下标
+    static const CrowdSteeringParams* getCrowdParamsTable();
+    static const int ENEMY_TYPE_COUNT = 5;
     
     // AI行为
     virtual void updateAI();
     virtual void startSkill();
     
+    // 技能脚本由场景的调度器统一按游戏时间执行
+    void setSkillScheduler(SkillScheduler* scheduler) { mSkillScheduler = scheduler; }
+    virtual const SkillScript* getSkillScript() const;
+    
+    // 由场景每帧驱动，dtMs为敌人阵营缩放后的经过时间（冻结时为0）
+    void advanceAI(qreal dtMs);
+    
+    // 根据与玩家的距离和是否在屏幕内更新AI细节等级
+    // 进入和退出使用不同阈值（滞后），避免在边界附近来回切换
+    void updateAILevel(const QPointF &playerCenter, const QRectF &screenRect);
+    // 不访问图元的纯计算版本，可在工作线程中批量调用；结果由场景在主线程用setAILevel写回
+    static AILevel chooseAILevel(AILevel current, const QPointF &center,
+                                 const QPointF &playerCenter, const QRectF &screenRect);
+    void setAILevel(AILevel level) { mAILevel = level; }
+    AILevel getAILevel() const { return mAILevel; }
+    // 当前等级下转向每隔几帧更新一次
+    int getSteeringStride() const;
+    // 生成时由场景分配的编号，不随列表下标变化，降频更新按它错开帧
+    void setSpawnId(quint32 id) { mSpawnId = id; }
+    quint32 getSpawnId() const { return mSpawnId; }
+    
     // 获取玩家引用
     SugarOilPlayer* getPlayer() const { return mPlayer; }
     
+    // 快照：读档前需先设置技能调度器，正在执行的技能脚本会挂回调度器
+    SavedState saveState() const;
+    void restoreState(const SavedState &state);
+    
     // 启动/停止AI
+    bool isAIActive() const { return mAIActive; }
     void startAI();
     void stopAI();
     
-    // 暂停/恢复所有定时器（用于游戏暂停）
-    void stopAllTimers();
-    void resumeAllTimers();
-    
 signals:
     void enemyDied(EnemyBase* enemy);
-    void enemyAttack(EnemyBase* enemy, QPointF position, QPointF direction, int damage);
+    // 一次发射只发一个信号，由场景按图案批量生成子弹
+    void enemyFirePattern(EnemyBase* enemy, int patternId, QPointF origin, float baseAngleDeg, int damage);
     void enemyHurt(EnemyBase* enemy);
 
-public slots:
-    void onAITimeout();
-    void onSkillTimeout();
-
 protected:
+    // 按类型和朝向选择片段
     virtual void updatePixmap();
+    static ClipId getClip(EnemyType type, bool faceRight);
     virtual void playHurtSound();
     virtual void playDeathSound();
     
@@ -97,17 +161,28 @@ private:
     // 玩家引用
     SugarOilPlayer* mPlayer;
     
-    // 定时器
-    QTimer* mAITimer;
-    QTimer* mSkillTimer;
+    // 技能
+    SkillScheduler* mSkillScheduler;
+    SkillScheduler::Handle mSkillHandle; // 正在执行的技能脚本
     
     // 音效现在由AudioManager统一管理
     
-    // AI相关
+    // AI相关（按游戏时间累计，不再使用独立的QTimer）
     int mAICounter;
+    bool mAIActive;
+    qreal mAIAccumulator;
+    AILevel mAILevel;
+    quint32 mSpawnId;
+    float mPatternPhase; // 螺旋图案的当前角度
     
     static const int AI_UPDATE_INTERVAL = 100; // AI更新间隔
-    static const int SKILL_COOLDOWN = 3000; // 技能冷却时间
+    
+    // AI细节等级阈值
+    static const int LOD_SCREEN_MARGIN = 32; // 离开屏幕超过该距离才降级
+    static const int LOD_FAR_ENTER = 700; // 与玩家距离超过该值进入粗略等级
+    static const int LOD_FAR_EXIT = 600; // 与玩家距离小于该值退出粗略等级
+    static const int REDUCED_STEERING_STRIDE = 2;
+    static const int COARSE_STEERING_STRIDE = 4;
 };
 
 #endif // ENEMY_BASE_H
\ No newline at end of file
@@ -0,0 +1,97 @@
+#ifndef ENTITY_LIST_H
+#define ENTITY_LIST_H
+
+#include <QVector>
+
+// 场景实体列表
+// 每个实体在GameObjectBase中记录自己的槽位，删除时把末尾元素换到该槽位再弹出（swap-and-pop），
+// 复杂度O(1)，代价是不保证顺序。
+// 帧内不直接删除，而是先放入销毁队列，统一在帧末flushRemovals()处理，
+// 这样遍历过程中和信号处理函数里都可以安全地"删除"实体
+template<typename T>
+class EntityList
+{
+public:
+    typedef typename QVector<T*>::const_iterator const_iterator;
+
+    int size() const { return mItems.size(); }
+    bool isEmpty() const { return mItems.isEmpty(); }
+    T* operator[](int index) const { return mItems[index]; }
+    const_iterator begin() const { return mItems.constBegin(); }
+    const_iterator end() const { return mItems.constEnd(); }
+
+    void reserve(int size) { mItems.reserve(size); }
+
+    void append(T* item)
+    {
+        item->setEntitySlot(mItems.size());
+        item->setPendingRemoval(false);
+        mItems.append(item);
+    }
+
+    bool contains(const T* item) const
+    {
+        const int slot = item ? item->getEntitySlot() : -1;
+        return slot >= 0 && slot < mItems.size() && mItems[slot] == item;
+    }
+
+    // 立即删除（O(1)），只能在不遍历本列表时调用
+    bool remove(T* item)
+    {
+        if (!contains(item)) {
+            return false;
+        }
+        const int slot = item->getEntitySlot();
+        T* last = mItems.last();
+        mItems[slot] = last;
+        last->setEntitySlot(slot);
+        mItems.removeLast();
+        item->setEntitySlot(-1);
+        item->setPendingRemoval(false);
+        return true;
+    }
+
+    // 加入销毁队列，同一帧内重复加入会被忽略
+    void queueRemoval(T* item)
+    {
+        if (!item || item->isPendingRemoval() || !contains(item)) {
+            return;
+        }
+        item->setPendingRemoval(true);
+        mRemovalQueue.append(item);
+    }
+
+    int pendingRemovalCount() const { return mRemovalQueue.size(); }
+
+    // 帧末同步点：从列表中移除所有排队的实体，并交给dispose处理（归还对象池或延迟删除）
+    template<typename Fn>
+    void flushRemovals(Fn dispose)
+    {
+        for (T* item : mRemovalQueue) {
+            if (remove(item)) {
+                dispose(item);
+            }
+        }
+        // clear()会保留容量，稳定状态下不再分配
+        mRemovalQueue.clear();
+    }
+
+    // 清空列表和队列（不负责释放实体）
+    void clear()
+    {
+        for (T* item : mItems) {
+            if (item) {
+                item->setEntitySlot(-1);
+                item->setPendingRemoval(false);
+            }
+        }
+        mItems.clear();
+        mRemovalQueue.clear();
+    }
+
+private:
+    QVector<T*> mItems;
+    QVector<T*> mRemovalQueue;
+};
+
+#endif // ENTITY_LIST_H
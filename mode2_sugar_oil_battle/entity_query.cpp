@@ -0,0 +1,108 @@
+#include "entity_query.h"
+
+EntityQueryIndex::EntityQueryIndex(float originX, float originY, float width, float height, float cellSize)
+{
+    const SpatialGrid emptyGrid(originX, originY, width, height, cellSize);
+    mLayers.reserve(LAYER_COUNT);
+    for (int i = 0; i < LAYER_COUNT; ++i) {
+        mLayers.append(Layer(emptyGrid));
+    }
+}
+
+int EntityQueryIndex::layerOf(EntityQueryFaction faction)
+{
+    // 单个类别的掩码只有一位，位序号即层号
+    int layer = 0;
+    while ((1 << layer) != faction) {
+        ++layer;
+    }
+    return layer;
+}
+
+void EntityQueryIndex::clearLayer(EntityQueryFaction faction)
+{
+    Layer &layer = mLayers[layerOf(faction)];
+    // clear()会保留容量，跨帧复用不会重新分配
+    layer.xs.clear();
+    layer.ys.clear();
+    layer.objects.clear();
+}
+
+void EntityQueryIndex::add(EntityQueryFaction faction, GameObjectBase* object, const QPointF &center)
+{
+    Layer &layer = mLayers[layerOf(faction)];
+    layer.xs.append(static_cast<float>(center.x()));
+    layer.ys.append(static_cast<float>(center.y()));
+    layer.objects.append(object);
+}
+
+void EntityQueryIndex::buildLayer(EntityQueryFaction faction)
+{
+    Layer &layer = mLayers[layerOf(faction)];
+    layer.grid.build(layer.xs.constData(), layer.ys.constData(), layer.objects.size());
+}
+
+void EntityQueryIndex::clear()
+{
+    for (int layer = 0; layer < LAYER_COUNT; ++layer) {
+        const EntityQueryFaction faction = static_cast<EntityQueryFaction>(1 << layer);
+        clearLayer(faction);
+        buildLayer(faction);
+    }
+}
+
+int EntityQueryIndex::findNearest(const QPointF &center, qreal maxRadius, EntityQueryFaction faction,
+                                  GameObjectBase** out, int k) const
+{
+    const Layer &layer = mLayers[layerOf(faction)];
+    k = qMin(k, MAX_NEAREST);
+    if (k <= 0 || layer.objects.isEmpty()) {
+        return 0;
+    }
+
+    const float cx = static_cast<float>(center.x());
+    const float cy = static_cast<float>(center.y());
+    const float maxDist2 = static_cast<float>(maxRadius * maxRadius);
+    const float cellSize = layer.grid.getCellSize();
+
+    // 按距离升序的候选表，k很小，插入排序即可
+    float bestDist2[MAX_NEAREST];
+    int bestIndex[MAX_NEAREST];
+    int found = 0;
+
+    for (int ring = 0; ; ++ring) {
+        const bool inside = layer.grid.forEachInRing(cx, cy, ring, [&](int i) {
+            const float dx = layer.xs[i] - cx;
+            const float dy = layer.ys[i] - cy;
+            const float d2 = dx * dx + dy * dy;
+            if (d2 > maxDist2 || (found == k && d2 >= bestDist2[k - 1])) {
+                return;
+            }
+            int pos = (found < k) ? found++ : k - 1;
+            while (pos > 0 && bestDist2[pos - 1] > d2) {
+                bestDist2[pos] = bestDist2[pos - 1];
+                bestIndex[pos] = bestIndex[pos - 1];
+                --pos;
+            }
+            bestDist2[pos] = d2;
+            bestIndex[pos] = i;
+        });
+        if (!inside) {
+            break;
+        }
+
+        // 下一圈中的点离center至少ring个格子宽
+        const float nextRingDist = ring * cellSize;
+        if (nextRingDist * nextRingDist > maxDist2) {
+            break;
+        }
+        if (found == k && bestDist2[k - 1] <= nextRingDist * nextRingDist) {
+            break;
+        }
+    }
+
+    for (int i = 0; i < found; ++i) {
+        out[i] = layer.objects[bestIndex[i]];
+    }
+    return found;
+}
@@ -0,0 +1,121 @@
+#ifndef ENTITY_QUERY_H
+#define ENTITY_QUERY_H
+
+#include <QtGlobal>
+#include <QVector>
+#include <QPointF>
+#include <QRectF>
+#include "spatial_grid.h"
+
+class GameObjectBase;
+
+// 可查询的实体类别，按位组合成查询掩码
+enum EntityQueryFaction {
+    QUERY_ENEMIES = 0x01,         // 敌人
+    QUERY_ITEMS = 0x02,           // 道具
+    QUERY_CREATURES = 0x04,       // 奇异生物
+    QUERY_PLAYER_BULLETS = 0x08,  // 玩家子弹（敌人子弹在BulletStore中，不进索引）
+    QUERY_ALL = 0x0f
+};
+
+// 场景实体空间索引
+// 每类实体各有一张均匀网格，每帧移动结束后重建一次；
+// 查询只遍历覆盖到的格子，并在打包好的坐标上做精确判断，不触碰QGraphicsItem。
+// 本帧重建之后新生成的实体要到下一帧才能被查询到
+class EntityQueryIndex
+{
+public:
+    static const int LAYER_COUNT = 4;
+
+    EntityQueryIndex(float originX, float originY, float width, float height, float cellSize);
+
+    // 重建一类实体：clearLayer → 逐个add → buildLayer
+    void clearLayer(EntityQueryFaction faction);
+    void add(EntityQueryFaction faction, GameObjectBase* object, const QPointF &center);
+    void buildLayer(EntityQueryFaction faction);
+    void clear();
+
+    int getCount(EntityQueryFaction faction) const { return mLayers[layerOf(faction)].objects.size(); }
+
+    // 遍历中心点与center距离不超过radius的实体
+    // fn(GameObjectBase* object, EntityQueryFaction faction)返回false时提前结束
+    template<typename Fn>
+    void queryRadius(const QPointF &center, qreal radius, int factionMask, Fn fn) const
+    {
+        const float cx = static_cast<float>(center.x());
+        const float cy = static_cast<float>(center.y());
+        const float r = static_cast<float>(radius);
+        const float r2 = r * r;
+        for (int layer = 0; layer < LAYER_COUNT; ++layer) {
+            const int faction = 1 << layer;
+            const Layer &l = mLayers[layer];
+            if (!(factionMask & faction) || l.objects.isEmpty()) {
+                continue;
+            }
+            bool keepGoing = true;
+            l.grid.forEachCandidate(cx, cy, r, [&](int i) {
+                const float dx = l.xs[i] - cx;
+                const float dy = l.ys[i] - cy;
+                if (dx * dx + dy * dy > r2) {
+                    return true;
+                }
+                keepGoing = fn(l.objects[i], static_cast<EntityQueryFaction>(faction));
+                return keepGoing;
+            });
+            if (!keepGoing) {
+                return;
+            }
+        }
+    }
+
+    // 遍历中心点落在rect内的实体，回调约定同queryRadius
+    template<typename Fn>
+    void queryRect(const QRectF &rect, int factionMask, Fn fn) const
+    {
+        const float minX = static_cast<float>(rect.left());
+        const float minY = static_cast<float>(rect.top());
+        const float maxX = static_cast<float>(rect.right());
+        const float maxY = static_cast<float>(rect.bottom());
+        for (int layer = 0; layer < LAYER_COUNT; ++layer) {
+            const int faction = 1 << layer;
+            const Layer &l = mLayers[layer];
+            if (!(factionMask & faction) || l.objects.isEmpty()) {
+                continue;
+            }
+            bool keepGoing = true;
+            l.grid.forEachCandidateInRect(minX, minY, maxX, maxY, [&](int i) {
+                if (l.xs[i] < minX || l.xs[i] > maxX || l.ys[i] < minY || l.ys[i] > maxY) {
+                    return true;
+                }
+                keepGoing = fn(l.objects[i], static_cast<EntityQueryFaction>(faction));
+                return keepGoing;
+            });
+            if (!keepGoing) {
+                return;
+            }
+        }
+    }
+
+    // 找出一类实体中离center最近、且不超过maxRadius的至多k个实体，按距离升序写入out，返回个数
+    // 从center所在格子逐圈向外搜索，第k近的距离不超过下一圈的最近可能距离时即停止
+    int findNearest(const QPointF &center, qreal maxRadius, EntityQueryFaction faction,
+                    GameObjectBase** out, int k) const;
+
+    static const int MAX_NEAREST = 16;
+
+private:
+    struct Layer {
+        explicit Layer(const SpatialGrid &emptyGrid) : grid(emptyGrid) {}
+
+        SpatialGrid grid;
+        QVector<float> xs;
+        QVector<float> ys;
+        QVector<GameObjectBase*> objects;
+    };
+
+    static int layerOf(EntityQueryFaction faction);
+
+    QVector<Layer> mLayers;
+};
+
+#endif // ENTITY_QUERY_H
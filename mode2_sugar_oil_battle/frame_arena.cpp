@@ -0,0 +1,203 @@
+#include "frame_arena.h"
+#include <atomic>
+#include <cerrno>
+#include <cstdlib>
+#include <new>
+
+FrameArena::FrameArena(size_t capacity)
+    : mBuffer(static_cast<char*>(::operator new(capacity)))
+    , mCapacity(capacity)
+    , mUsed(0)
+    , mOverflowBytes(0)
+    , mOverflow(nullptr)
+{
+}
+
+FrameArena::~FrameArena()
+{
+    reset();
+    ::operator delete(mBuffer);
+}
+
+void* FrameArena::allocate(size_t bytes, size_t alignment)
+{
+    const size_t aligned = (mUsed + alignment - 1) & ~(alignment - 1);
+    if (aligned + bytes <= mCapacity) {
+        mUsed = aligned + bytes;
+        return mBuffer + aligned;
+    }
+
+    // 容量不足：申请溢出块并挂到链表上，reset()时释放
+    // 统一走operator new，溢出会计入AllocTracker
+    mOverflowBytes += bytes + alignment;
+    const size_t header = (sizeof(OverflowBlock) + alignment - 1) & ~(alignment - 1);
+    char* raw = static_cast<char*>(::operator new(header + bytes));
+    OverflowBlock* block = reinterpret_cast<OverflowBlock*>(raw);
+    block->next = mOverflow;
+    mOverflow = block;
+    return raw + header;
+}
+
+void FrameArena::reset()
+{
+    while (mOverflow) {
+        OverflowBlock* next = mOverflow->next;
+        ::operator delete(mOverflow);
+        mOverflow = next;
+    }
+
+    // 本帧溢出过，按总需求扩容，之后的帧不再溢出
+    if (mOverflowBytes > 0) {
+        const size_t grown = qMax(mUsed + mOverflowBytes, mCapacity * 2);
+        ::operator delete(mBuffer);
+        mBuffer = static_cast<char*>(::operator new(grown));
+        mCapacity = grown;
+    }
+
+    mUsed = 0;
+    mOverflowBytes = 0;
+}
+
+#ifdef SUGAR_OIL_ALLOC_TRACKING
+
+namespace {
+std::atomic<quint64> sAllocationCount(0);
+// 平凡类型的thread_local，访问时不会反过来调用malloc
+thread_local bool sThreadTracked = false;
+
+inline void countAllocation()
+{
+    if (sThreadTracked) {
+        sAllocationCount.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+}
+
+#if defined(__GLIBC__)
+
+// 可执行文件中定义的malloc会覆盖libc的版本，Qt库里的分配也走这里；
+// 真正的分配交给glibc导出的__libc_*实现。operator new内部调用malloc，不需要单独接管
+extern "C" {
+void* __libc_malloc(size_t size);
+void* __libc_calloc(size_t count, size_t size);
+void* __libc_realloc(void* p, size_t size);
+void* __libc_memalign(size_t alignment, size_t size);
+void __libc_free(void* p);
+
+void* malloc(size_t size)
+{
+    countAllocation();
+    return __libc_malloc(size);
+}
+
+void* calloc(size_t count, size_t size)
+{
+    countAllocation();
+    return __libc_calloc(count, size);
+}
+
+void* realloc(void* p, size_t size)
+{
+    countAllocation();
+    return __libc_realloc(p, size);
+}
+
+void* memalign(size_t alignment, size_t size)
+{
+    countAllocation();
+    return __libc_memalign(alignment, size);
+}
+
+void* aligned_alloc(size_t alignment, size_t size)
+{
+    countAllocation();
+    return __libc_memalign(alignment, size);
+}
+
+int posix_memalign(void** out, size_t alignment, size_t size)
+{
+    countAllocation();
+    void* p = __libc_memalign(alignment, size);
+    if (!p) {
+        return ENOMEM;
+    }
+    *out = p;
+    return 0;
+}
+
+void free(void* p)
+{
+    __libc_free(p);
+}
+}
+
+#else
+
+void* operator new(std::size_t size)
+{
+    countAllocation();
+    if (void* p = std::malloc(size ? size : 1)) {
+        return p;
+    }
+    throw std::bad_alloc();
+}
+
+void* operator new[](std::size_t size)
+{
+    return operator new(size);
+}
+
+void operator delete(void* p) noexcept
+{
+    std::free(p);
+}
+
+void operator delete[](void* p) noexcept
+{
+    std::free(p);
+}
+
+void operator delete(void* p, std::size_t) noexcept
+{
+    std::free(p);
+}
+
+void operator delete[](void* p, std::size_t) noexcept
+{
+    std::free(p);
+}
+
+#endif
+
+bool AllocTracker::isEnabled()
+{
+    return true;
+}
+
+quint64 AllocTracker::allocationCount()
+{
+    return sAllocationCount.load(std::memory_order_relaxed);
+}
+
+void AllocTracker::trackCurrentThread()
+{
+    sThreadTracked = true;
+}
+
+#else
+
+bool AllocTracker::isEnabled()
+{
+    return false;
+}
+
+quint64 AllocTracker::allocationCount()
+{
+    return 0;
+}
+
+void AllocTracker::trackCurrentThread()
+{
+}
+
+#endif
@@ -0,0 +1,138 @@
+#ifndef FRAME_ARENA_H
+#define FRAME_ARENA_H
+
+#include <QtGlobal>
+#include <cstddef>
+#include <cstring>
+#include <new>
+#include <type_traits>
+
+// 帧内存池（bump-pointer）
+// 每帧的临时缓冲区都从这里分配，分配只是移动指针，释放是空操作，
+// updateGame()结束时reset()一次性回收。
+// 本帧用量超出容量时临时向堆申请溢出块，下一次reset()会按峰值扩容，
+// 因此稳定状态下帧循环不会再产生堆分配
+class FrameArena
+{
+public:
+    explicit FrameArena(size_t capacity = 64 * 1024);
+    ~FrameArena();
+
+    void* allocate(size_t bytes, size_t alignment = alignof(std::max_align_t));
+    void reset();
+
+    size_t getCapacity() const { return mCapacity; }
+    size_t getUsed() const { return mUsed; }
+
+private:
+    Q_DISABLE_COPY(FrameArena)
+
+    struct OverflowBlock {
+        OverflowBlock* next;
+    };
+
+    char* mBuffer;
+    size_t mCapacity;
+    size_t mUsed;
+    size_t mOverflowBytes; // 本帧溢出块的总大小
+    OverflowBlock* mOverflow;
+};
+
+// STL兼容的分配器，可用于std::vector等容器
+template<typename T>
+class ArenaAllocator
+{
+public:
+    typedef T value_type;
+
+    explicit ArenaAllocator(FrameArena &arena) : mArena(&arena) {}
+    template<typename U>
+    ArenaAllocator(const ArenaAllocator<U> &other) : mArena(other.arena()) {}
+
+    T* allocate(size_t n) { return static_cast<T*>(mArena->allocate(n * sizeof(T), alignof(T))); }
+    void deallocate(T*, size_t) {} // 随帧统一回收
+
+    FrameArena* arena() const { return mArena; }
+
+    template<typename U>
+    bool operator==(const ArenaAllocator<U> &other) const { return mArena == other.arena(); }
+    template<typename U>
+    bool operator!=(const ArenaAllocator<U> &other) const { return mArena != other.arena(); }
+
+private:
+    FrameArena* mArena;
+};
+
+// 帧内临时数组，接口参照QVarLengthArray
+// 前Prealloc个元素放在栈上，超出后从帧内存池扩容；仅用于指针、坐标等平凡类型
+template<typename T, int Prealloc = 64>
+class FrameArray
+{
+    static_assert(std::is_trivially_copyable<T>::value && std::is_trivially_destructible<T>::value,
+                  "FrameArray only holds trivial types");
+
+public:
+    explicit FrameArray(FrameArena &arena)
+        : mArena(arena), mData(reinterpret_cast<T*>(mInline)), mSize(0), mCapacity(Prealloc) {}
+
+    int size() const { return mSize; }
+    bool isEmpty() const { return mSize == 0; }
+    T &operator[](int i) { return mData[i]; }
+    const T &operator[](int i) const { return mData[i]; }
+    T* data() { return mData; }
+    const T* constData() const { return mData; }
+    T* begin() { return mData; }
+    T* end() { return mData + mSize; }
+    const T* begin() const { return mData; }
+    const T* end() const { return mData + mSize; }
+
+    void clear() { mSize = 0; }
+
+    void reserve(int capacity)
+    {
+        if (capacity <= mCapacity) {
+            return;
+        }
+        T* grown = static_cast<T*>(mArena.allocate(sizeof(T) * capacity, alignof(T)));
+        std::memcpy(static_cast<void*>(grown), mData, sizeof(T) * mSize);
+        mData = grown; // 旧块留在池中，随帧回收
+        mCapacity = capacity;
+    }
+
+    void resize(int size)
+    {
+        reserve(size);
+        mSize = size;
+    }
+
+    void append(const T &value)
+    {
+        if (mSize == mCapacity) {
+            reserve(mCapacity * 2);
+        }
+        mData[mSize++] = value;
+    }
+
+private:
+    Q_DISABLE_COPY(FrameArray)
+
+    FrameArena &mArena;
+    alignas(T) char mInline[sizeof(T) * Prealloc];
+    T* mData;
+    int mSize;
+    int mCapacity;
+};
+
+// 堆分配计数（需以CONFIG+=alloc_tracking构建，否则恒为0）
+// 用于验证稳定状态下帧循环没有堆分配。glibc下接管malloc系列函数，
+// Qt容器、信号连接和operator new都会计入；其他平台只能接管operator new。
+// 只统计调用过trackCurrentThread()的线程（主线程和作业系统的工作线程），
+// 音频、自动存档写盘等后台线程的分配不计入
+namespace AllocTracker
+{
+    bool isEnabled();
+    quint64 allocationCount();
+    void trackCurrentThread();
+}
+
+#endif // FRAME_ARENA_H
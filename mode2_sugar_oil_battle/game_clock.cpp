@@ -0,0 +1,98 @@
+#include "game_clock.h"
+#include "../snapshot_io.h"
+
+namespace
+{
+    const quint32 SNAPSHOT_TAG = 0x4b4c4347; // "GCLK"
+    const int MAX_TIMED_SCALES = 1024;
+}
+
+GameClock::GameClock()
+    : mNow(0)
+    , mLastDelta(0)
+{
+    for (int i = 0; i < FactionCount; ++i) {
+        mBaseScales[i] = 1.0;
+        mScales[i] = 1.0;
+    }
+}
+
+void GameClock::advance(qint64 dtMs)
+{
+    mNow += dtMs;
+    mLastDelta = dtMs;
+
+    // 限时缩放数量很少（同时生效的道具效果），线性扫描即可
+    bool changed = false;
+    for (int i = mTimedScales.size() - 1; i >= 0; --i) {
+        if (mTimedScales[i].expiresAt <= mNow) {
+            mTimedScales[i] = mTimedScales.last();
+            mTimedScales.removeLast();
+            changed = true;
+        }
+    }
+    if (changed) {
+        recomputeScales();
+    }
+}
+
+void GameClock::reset()
+{
+    mNow = 0;
+    mLastDelta = 0;
+    mTimedScales.clear();
+    for (int i = 0; i < FactionCount; ++i) {
+        mBaseScales[i] = 1.0;
+    }
+    recomputeScales();
+}
+
+void GameClock::setBaseScale(Faction faction, qreal scale)
+{
+    mBaseScales[faction] = qMax<qreal>(0.0, scale);
+    recomputeScales();
+}
+
+void GameClock::applyTimedScale(Faction faction, qreal scale, qint64 durationMs)
+{
+    if (durationMs <= 0) {
+        return;
+    }
+    mTimedScales.append({ faction, qMax<qreal>(0.0, scale), mNow + durationMs });
+    recomputeScales();
+}
+
+void GameClock::recomputeScales()
+{
+    for (int i = 0; i < FactionCount; ++i) {
+        mScales[i] = mBaseScales[i];
+    }
+    for (const TimedScale &timed : mTimedScales) {
+        mScales[timed.faction] = qMin(mScales[timed.faction], mBaseScales[timed.faction] * timed.scale);
+    }
+}
+
+void GameClock::saveState(SnapshotWriter &writer) const
+{
+    writer.beginSection(SNAPSHOT_TAG);
+    writer.write(mNow);
+    writer.write(mLastDelta);
+    writer.write(mBaseScales);
+    writer.writeArray(mTimedScales);
+}
+
+bool GameClock::restoreState(SnapshotReader &reader)
+{
+    if (!reader.expectSection(SNAPSHOT_TAG)) {
+        return false;
+    }
+    reader.read(mNow);
+    reader.read(mLastDelta);
+    reader.read(mBaseScales);
+    reader.readArray(mTimedScales, MAX_TIMED_SCALES);
+    for (TimedScale &timed : mTimedScales) {
+        timed.faction = qBound(0, timed.faction, FactionCount - 1);
+    }
+    recomputeScales();
+    return reader.isOk();
+}
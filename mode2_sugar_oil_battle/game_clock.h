@@ -0,0 +1,63 @@
+#ifndef GAME_CLOCK_H
+#define GAME_CLOCK_H
+
+#include <QtGlobal>
+#include <QVector>
+
+class SnapshotWriter;
+class SnapshotReader;
+
+// 游戏模拟时钟
+// 只在游戏运行时由场景每帧推进，暂停时自然停止。
+// 每个阵营有独立的时间缩放，各系统用 getDelta(阵营) 代替固定帧长，
+// 减速或冻结成千上万个敌人只需要改一个数值，而不用逐个修改它们的定时器
+class GameClock
+{
+public:
+    enum Faction {
+        Player = 0,     // 玩家及玩家子弹
+        Enemies,        // 敌人移动与AI
+        EnemyBullets,   // 敌人子弹
+        Items,          // 道具
+        FactionCount
+    };
+
+    GameClock();
+
+    // 推进一帧，并移除已到期的时间缩放
+    void advance(qint64 dtMs);
+    void reset();
+
+    qint64 getNow() const { return mNow; }
+
+    // 本帧该阵营经过的时间（毫秒）= 帧长 × 缩放
+    qreal getDelta(Faction faction) const { return mLastDelta * mScales[faction]; }
+    qreal getScale(Faction faction) const { return mScales[faction]; }
+
+    // 基础缩放（长期生效）
+    void setBaseScale(Faction faction, qreal scale);
+
+    // 限时缩放：持续durationMs毫秒（游戏时间），同一阵营多个缩放同时生效时取最小值
+    void applyTimedScale(Faction faction, qreal scale, qint64 durationMs);
+
+    // 快照：当前时间、基础缩放和所有未到期的限时缩放
+    void saveState(SnapshotWriter &writer) const;
+    bool restoreState(SnapshotReader &reader);
+
+private:
+    struct TimedScale {
+        int faction;
+        qreal scale;
+        qint64 expiresAt;
+    };
+
+    void recomputeScales();
+
+    qint64 mNow;
+    qint64 mLastDelta;
+    qreal mBaseScales[FactionCount];
+    qreal mScales[FactionCount];
+    QVector<TimedScale> mTimedScales;
+};
+
+#endif // GAME_CLOCK_H
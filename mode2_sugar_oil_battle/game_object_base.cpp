@@ -13,6 +13,35 @@ GameObjectBase::~GameObjectBase()
 
 QPointF GameObjectBase::getCenterPos() const
 {
-    return QPointF(pos().x() + (pixmap().width() * scale() / 2),
-                   pos().y() + (pixmap().height() * scale() / 2));
+    // boundingRect()按设备无关尺寸计算；图集中的精灵像素比很高，不能直接用pixmap()的像素宽高
+    return pos() + boundingRect().center() * scale();
+}
+
+void GameObjectBase::playClip(ClipId clip)
+{
+    if (clip == mAnimation.clip) {
+        return;
+    }
+    mAnimation = { clip, 0, 0.0 };
+    setPixmap(AnimationClips::getInstance()->getFrame(clip, 0));
+}
+
+void GameObjectBase::advanceAnimation(qreal dtMs)
+{
+    const AnimationClips* clips = AnimationClips::getInstance();
+    if (clips->advance(mAnimation, dtMs)) {
+        setPixmap(clips->getFrame(mAnimation.clip, mAnimation.frame));
+    }
+}
+
+void GameObjectBase::setAnimationFrame(int frame)
+{
+    const AnimationClips* clips = AnimationClips::getInstance();
+    const int frameCount = clips->getFrameCount(mAnimation.clip);
+    if (frameCount <= 0) {
+        return;
+    }
+    mAnimation.frame = qBound(0, frame, frameCount - 1);
+    mAnimation.phaseMs = 0.0;
+    setPixmap(clips->getFrame(mAnimation.clip, mAnimation.frame));
 }
\ No newline at end of file
@@ -5,6 +5,7 @@
 #include <QObject>
 #include <QDebug>
 #include <QPointF>
+#include "animation_clips.h"
 
 class GameObjectBase : public QObject, public QGraphicsPixmapItem
 {
@@ -34,9 +35,30 @@ public:
     // 获取边界矩形
     QRectF getBoundingRect() const { return boundingRect(); }
     
+    // 实体列表槽位（由EntityList维护，用于O(1)删除）
+    int getEntitySlot() const { return mEntitySlot; }
+    void setEntitySlot(int slot) { mEntitySlot = slot; }
+    
+    // 是否已进入本帧的销毁队列
+    bool isPendingRemoval() const { return mPendingRemoval; }
+    void setPendingRemoval(bool pending) { mPendingRemoval = pending; }
+    
+    // 帧动画：帧表由AnimationClips按原型共享，实体只保存播放进度
+    // 切换到clip并从第一帧开始；已经在播放同一片段时保持进度
+    void playClip(ClipId clip);
+    // 由场景每帧统一推进，dtMs为所属阵营缩放后的经过时间；帧变化时才换图
+    void advanceAnimation(qreal dtMs);
+    const AnimationState& getAnimation() const { return mAnimation; }
+    void setAnimationFrame(int frame);
+    
 protected:
     // 子类可以重写的更新方法
     virtual void updateObject() {}
+    
+private:
+    int mEntitySlot = -1;
+    bool mPendingRemoval = false;
+    AnimationState mAnimation = { AnimationClips::INVALID_CLIP, 0, 0.0 };
 };
 
 #endif // GAME_OBJECT_BASE_H
\ No newline at end of file
@@ -1,24 +1,18 @@
 #include "item_system.h"
 #include "sugar_oil_player.h"
+#include <QGraphicsScene>
 #include <QPixmap>
 #include <QUrl>
 #include <QDebug>
+#include <QtMath>
 
 // GameItem 实现
 GameItem::GameItem(ItemType type, QObject *parent)
     : GameObjectBase(parent)
     , mItemType(type)
-    , mAnimationFrame(0)
-
-
+    , mBobPhase(0.0)
 {
-    // 初始化动画定时器
-    mAnimationTimer = new QTimer(this);
-    mAnimationTimer->setInterval(ANIMATION_INTERVAL);
-    connect(mAnimationTimer, &QTimer::timeout, this, &GameItem::onAnimationTimeout);
-    mAnimationTimer->start();
-    
-    // 音效播放现在由AudioManager统一管理
+    // 动画由场景每帧驱动，音效播放由AudioManager统一管理
     
     setupEffect();
     updatePixmap();
@@ -28,9 +22,18 @@ GameItem::GameItem(ItemType type, QObject *parent)
 
 GameItem::~GameItem()
 {
-    if (mAnimationTimer) {
-        mAnimationTimer->stop();
-    }
+}
+
+void GameItem::resetItem(ItemType type)
+{
+    mItemType = type;
+    mEffect = ItemEffect();
+    mBobPhase = 0.0;
+    setPendingRemoval(false);
+    setupEffect();
+    updatePixmap();
+    setAnimationFrame(0);
+    setVisible(true);
 }
 
 void GameItem::setupEffect()
@@ -80,7 +83,7 @@ void GameItem::setupEffect()
         mEffect.duration = 10000; // 10秒
         break;
     case ITEM_BOMB:
-        // 炸弹效果需要在游戏场景中实现
+        // 炸弹效果由游戏场景通过空间查询实现
         break;
     case ITEM_RAPID_FIRE:
         mEffect.rapidFire = true;
@@ -143,17 +146,26 @@ void GameItem::setupEffect()
 
 void GameItem::updatePixmap()
 {
-    QString imagePath = QString(":/images/items/itemicon%1.png").arg(static_cast<int>(mItemType));
-    QPixmap pixmap(imagePath);
-    
-    if (pixmap.isNull()) {
-        // 如果没有对应的图片，创建一个简单的彩色方块
-        pixmap = QPixmap(32, 32);
-        QColor colors[] = {Qt::red, Qt::green, Qt::blue, Qt::yellow, Qt::cyan, Qt::magenta};
-        pixmap.fill(colors[static_cast<int>(mItemType) % 6]);
-    }
-    
-    setPixmap(pixmap);
+    playClip(getClip(mItemType));
+}
+
+ClipId GameItem::getClip(ItemType type)
+{
+    // 每种道具一个片段，所有实例共用，第一次用到时注册
+    static const QVector<ClipId> clips = []() {
+        AnimationClips* registry = AnimationClips::getInstance();
+        const QColor colors[] = {Qt::red, Qt::green, Qt::blue, Qt::yellow, Qt::cyan, Qt::magenta};
+        QVector<ClipId> ids;
+        for (int i = 0; i < ITEM_COUNT; ++i) {
+            // 如果没有对应的图片，用一个简单的彩色方块代替
+            QPixmap fallback(32, 32);
+            fallback.fill(colors[i % 6]);
+            ids.append(registry->registerClip(QString("item/%1").arg(i),
+                                              { QString(":/img/items/itemicon%1.png").arg(i) }, 0, fallback));
+        }
+        return ids;
+    }();
+    return clips[qBound(0, static_cast<int>(type), ITEM_COUNT - 1)];
 }
 
 void GameItem::applyEffect(SugarOilPlayer* player)
@@ -173,22 +185,36 @@ void GameItem::applyEffect(SugarOilPlayer* player)
         player->gainScore(mEffect.scoreBonus);
     }
     
-    // 持续效果需要在玩家类中实现
-    // 这里只是触发效果的应用
+    // 持续效果交给玩家的效果调度器
+    if (mEffect.duration > 0) {
+        player->applyItemEffect(mEffect, static_cast<int>(mItemType));
+    }
+    
     qDebug() << "Applied item effect:" << ItemManager::getItemName(mItemType);
 }
 
-void GameItem::updateAnimation()
+void GameItem::updateAnimation(qreal dtMs)
+{
+    if (dtMs <= 0.0) {
+        return;
+    }
+    
+    // 简单的上下浮动动画，速度随道具阵营的时间缩放变化
+    const qreal steps = dtMs / ANIMATION_STEP;
+    mBobPhase += 0.1 * steps;
+    setPos(pos().x(), pos().y() + qSin(mBobPhase) * 2 * steps);
+}
+
+GameItem::SavedState GameItem::saveState() const
 {
-    // 简单的上下浮动动画
-    static qreal offset = 0;
-    offset += 0.1;
-    setPos(pos().x(), pos().y() + qSin(offset) * 2);
+    return { pos().x(), pos().y(), mBobPhase, static_cast<qint32>(mItemType), getAnimation().frame };
 }
 
-void GameItem::onAnimationTimeout()
+void GameItem::restoreState(const SavedState &state)
 {
-    updateAnimation();
+    setPos(state.x, state.y);
+    mBobPhase = state.bobPhase;
+    setAnimationFrame(state.animationFrame);
 }
 
 // ItemManager 实现
@@ -200,20 +226,57 @@ ItemManager::ItemManager(QObject *parent)
 
 ItemManager::~ItemManager()
 {
+    clearPool();
 }
 
 GameItem* ItemManager::spawnRandomItem(const QPointF& position)
 {
     // 随机选择一个道具类型
     int itemTypeIndex = mRandomGenerator->bounded(24); // 0-23
-    ItemType type = static_cast<ItemType>(itemTypeIndex);
-    
-    GameItem* item = new GameItem(type);
+    return createItem(static_cast<ItemType>(itemTypeIndex), position);
+}
+
+GameItem* ItemManager::createItem(ItemType type, const QPointF& position)
+{
+    GameItem* item = nullptr;
+    if (!mPool.isEmpty()) {
+        item = mPool.takeLast();
+        item->resetItem(type);
+    } else {
+        // 池用完时才新建，由调用方加入场景
+        item = new GameItem(type);
+    }
     item->setPos(position);
     
     return item;
 }
 
+void ItemManager::reservePool(QGraphicsScene* scene, int count)
+{
+    mPool.reserve(mPool.size() + count);
+    for (int i = 0; i < count; ++i) {
+        GameItem* item = new GameItem(ITEM_SPEED_BOOST);
+        item->setVisible(false);
+        scene->addItem(item);
+        mPool.append(item);
+    }
+}
+
+void ItemManager::releaseItem(GameItem* item)
+{
+    if (!item) return;
+    
+    // 池不设上限：道具数量受生成间隔限制，回收的道具都留着复用
+    item->setVisible(false);
+    mPool.append(item);
+}
+
+void ItemManager::clearPool()
+{
+    qDeleteAll(mPool);
+    mPool.clear();
+}
+
 QString ItemManager::getItemDescription(ItemType type)
 {
     switch (type) {
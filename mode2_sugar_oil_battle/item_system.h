@@ -8,6 +8,7 @@
 #include <QRandomGenerator>
 
 class SugarOilPlayer;
+class QGraphicsScene;
 
 // 道具效果结构体
 struct ItemEffect {
@@ -32,34 +33,47 @@ class GameItem : public GameObjectBase
     Q_OBJECT
     
 public:
+    // 快照中的一个道具
+    struct SavedState {
+        qreal x;
+        qreal y;
+        qreal bobPhase;
+        qint32 type;
+        qint32 animationFrame;
+    };
+    
     explicit GameItem(ItemType type, QObject *parent = nullptr);
     virtual ~GameItem();
     
+    // 对象池复用：换成新类型并从头开始浮动动画
+    void resetItem(ItemType type);
+    
     ItemType getItemType() const { return mItemType; }
     ItemEffect getEffect() const { return mEffect; }
     
     // 道具收集效果
     void applyEffect(SugarOilPlayer* player);
     
-    // 更新道具动画
-    void updateAnimation();
+    // 更新道具动画，由场景每帧驱动，dtMs为道具阵营缩放后的经过时间
+    void updateAnimation(qreal dtMs);
+    
+    // 快照：类型在创建或复用时确定，这里只恢复位置和动画相位
+    SavedState saveState() const;
+    void restoreState(const SavedState &state);
     
 protected:
     void updatePixmap();
+    static ClipId getClip(ItemType type);
     void setupEffect();
     
-private slots:
-    void onAnimationTimeout();
-    
 private:
     ItemType mItemType;
     ItemEffect mEffect;
-    QTimer* mAnimationTimer;
-    int mAnimationFrame;
+    qreal mBobPhase; // 上下浮动的相位，每个道具独立
     
     // 音效现在由AudioManager统一管理
     
-    static const int ANIMATION_INTERVAL = 300; // 动画帧间隔
+    static const int ANIMATION_STEP = 16; // 浮动动画的基准帧长（毫秒）
 };
 
 // 道具管理器
@@ -71,9 +85,24 @@ public:
     explicit ItemManager(QObject *parent = nullptr);
     virtual ~ItemManager();
     
-    // 生成随机道具
+    // 生成随机道具，优先复用对象池中的实例
     GameItem* spawnRandomItem(const QPointF& position);
     
+    // 生成指定类型的道具（读档时使用），同样优先复用对象池
+    GameItem* createItem(ItemType type, const QPointF& position);
+    
+    // 预先创建count个隐藏的道具加入场景，之后生成道具不再分配，也不再反复加入/移出场景
+    void reservePool(QGraphicsScene* scene, int count);
+    
+    // 回收道具到对象池，道具只隐藏、仍留在场景中
+    void releaseItem(GameItem* item);
+    
+    // 删除池中的道具，场景析构前调用（池中的道具属于场景，不能等场景自己删除后再删一次）
+    void clearPool();
+    
+    // 使用场景的随机数生成器（可按种子复现）
+    void setRandomGenerator(QRandomGenerator* generator) { mRandomGenerator = generator; }
+    
     // 获取道具效果描述
     static QString getItemDescription(ItemType type);
     
@@ -82,6 +111,7 @@ public:
     
 private:
     QRandomGenerator* mRandomGenerator;
+    QList<GameItem*> mPool;
 };
 
 #endif // ITEM_SYSTEM_H
\ No newline at end of file
@@ -0,0 +1,175 @@
+#include "job_system.h"
+#include "frame_arena.h"
+
+namespace
+{
+    quint64 packRange(quint64 head, quint64 tail)
+    {
+        return (tail << 32) | head;
+    }
+}
+
+JobSystem::JobSystem(int threadCount)
+{
+    setThreadCount(threadCount);
+}
+
+JobSystem::~JobSystem()
+{
+    stopWorkers();
+}
+
+int JobSystem::idealThreadCount()
+{
+    const int cores = static_cast<int>(std::thread::hardware_concurrency());
+    return qBound(1, cores, MAX_THREADS);
+}
+
+void JobSystem::setThreadCount(int threadCount)
+{
+    stopWorkers();
+
+    const int threads = threadCount <= 0 ? idealThreadCount() : qBound(1, threadCount, MAX_THREADS);
+    mRanges.reset(new ChunkRange[threads]);
+    mStopping = false;
+    for (int i = 1; i < threads; ++i) {
+        mWorkers.emplace_back(&JobSystem::workerLoop, this, i);
+    }
+}
+
+void JobSystem::stopWorkers()
+{
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        mStopping = true;
+    }
+    mWake.notify_all();
+    for (std::thread &worker : mWorkers) {
+        worker.join();
+    }
+    mWorkers.clear();
+}
+
+void JobSystem::run(int count, int grain, ChunkFn fn, void* context)
+{
+    const int threads = getThreadCount();
+    const int chunkCount = (count + grain - 1) / grain;
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        // 上一个作业的线程可能还在检查空区间，等它们全部离开后才能重置区间；
+        // 持锁期间不会有新线程加入
+        while (mBusyWorkers.load(std::memory_order_acquire) > 0) {
+            std::this_thread::yield();
+        }
+
+        mFn = fn;
+        mContext = context;
+        mCount = count;
+        mGrain = grain;
+        // 块按线程平均分成连续的几段，各线程先处理相邻的数据
+        for (int t = 0; t < threads; ++t) {
+            const quint64 head = static_cast<quint64>(chunkCount) * t / threads;
+            const quint64 tail = static_cast<quint64>(chunkCount) * (t + 1) / threads;
+            mRanges[t].packed.store(packRange(head, tail), std::memory_order_relaxed);
+        }
+        mPendingChunks.store(chunkCount, std::memory_order_relaxed);
+        ++mGeneration;
+    }
+    mWake.notify_all();
+
+    executeChunks(0, fn, context, count, grain);
+
+    // 每个块执行完才计数，计数归零时所有输出都已写完
+    while (mPendingChunks.load(std::memory_order_acquire) > 0) {
+        std::this_thread::yield();
+    }
+}
+
+void JobSystem::workerLoop(int index)
+{
+    // 工作线程执行的是帧内任务，分配计数要算上它们
+    AllocTracker::trackCurrentThread();
+
+    quint64 seen = 0;
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        seen = mGeneration;
+    }
+
+    for (;;) {
+        ChunkFn fn = nullptr;
+        void* context = nullptr;
+        int count = 0;
+        int grain = 1;
+        {
+            std::unique_lock<std::mutex> lock(mMutex);
+            mWake.wait(lock, [&]() { return mStopping || mGeneration != seen; });
+            if (mStopping) {
+                return;
+            }
+            seen = mGeneration;
+            fn = mFn;
+            context = mContext;
+            count = mCount;
+            grain = mGrain;
+            mBusyWorkers.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        executeChunks(index, fn, context, count, grain);
+        mBusyWorkers.fetch_sub(1, std::memory_order_release);
+    }
+}
+
+void JobSystem::executeChunks(int self, ChunkFn fn, void* context, int count, int grain)
+{
+    const int threads = getThreadCount();
+    int chunk = 0;
+    for (;;) {
+        // 先做自己的块，做完后依次从其他线程的末端偷
+        bool found = popFront(self, chunk);
+        for (int i = 1; !found && i < threads; ++i) {
+            found = stealBack((self + i) % threads, chunk);
+        }
+        if (!found) {
+            return;
+        }
+
+        const int begin = chunk * grain;
+        fn(context, begin, qMin(count, begin + grain));
+        mPendingChunks.fetch_sub(1, std::memory_order_acq_rel);
+    }
+}
+
+bool JobSystem::popFront(int self, int &chunk)
+{
+    std::atomic<quint64> &packed = mRanges[self].packed;
+    quint64 value = packed.load(std::memory_order_acquire);
+    for (;;) {
+        const quint64 head = value & 0xffffffffu;
+        const quint64 tail = value >> 32;
+        if (head >= tail) {
+            return false;
+        }
+        if (packed.compare_exchange_weak(value, packRange(head + 1, tail), std::memory_order_acq_rel)) {
+            chunk = static_cast<int>(head);
+            return true;
+        }
+    }
+}
+
+bool JobSystem::stealBack(int victim, int &chunk)
+{
+    std::atomic<quint64> &packed = mRanges[victim].packed;
+    quint64 value = packed.load(std::memory_order_acquire);
+    for (;;) {
+        const quint64 head = value & 0xffffffffu;
+        const quint64 tail = value >> 32;
+        if (head >= tail) {
+            return false;
+        }
+        if (packed.compare_exchange_weak(value, packRange(head, tail - 1), std::memory_order_acq_rel)) {
+            chunk = static_cast<int>(tail - 1);
+            return true;
+        }
+    }
+}
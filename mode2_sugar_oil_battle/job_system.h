@@ -0,0 +1,85 @@
+#ifndef JOB_SYSTEM_H
+#define JOB_SYSTEM_H
+
+#include <QtGlobal>
+#include <atomic>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// 作业系统：固定数量的工作线程 + 按块的work-stealing并行for
+// parallelFor把[0, count)切成grain大小的块，按线程平均分成连续的几段，
+// 每个线程从自己那段的前端取块，做完后从其他线程那段的末端偷块。
+// 调用线程也参与执行，函数返回时所有块都已完成。
+// 块的划分只取决于count和grain，与线程数无关；只要每个块只写自己下标范围内的输出，
+// 结果就与单线程完全一致，不影响回放的确定性
+class JobSystem
+{
+public:
+    // threadCount为参与执行的线程总数（含调用线程），<=0时按CPU核数选择
+    explicit JobSystem(int threadCount = 0);
+    ~JobSystem();
+
+    // 重新创建工作线程，不能在parallelFor执行期间调用
+    void setThreadCount(int threadCount);
+    int getThreadCount() const { return static_cast<int>(mWorkers.size()) + 1; }
+
+    // fn(int begin, int end)处理一个块；块数不超过1时直接在调用线程执行
+    template<typename Fn>
+    void parallelFor(int count, int grain, Fn fn)
+    {
+        if (count <= 0) {
+            return;
+        }
+        grain = qMax(1, grain);
+        if (mWorkers.empty() || count <= grain) {
+            fn(0, count);
+            return;
+        }
+        run(count, grain, [](void* context, int begin, int end) {
+            (*static_cast<Fn*>(context))(begin, end);
+        }, &fn);
+    }
+
+    static int idealThreadCount();
+
+    static constexpr int MAX_THREADS = 8;
+
+private:
+    Q_DISABLE_COPY(JobSystem)
+
+    typedef void (*ChunkFn)(void* context, int begin, int end);
+
+    // 每个线程待处理的块区间[head, tail)，打包在一个64位原子量里：
+    // 所有者从head取、窃取者从tail取，都用CAS修改，不需要锁
+    struct alignas(64) ChunkRange {
+        std::atomic<quint64> packed{ 0 };
+    };
+
+    void run(int count, int grain, ChunkFn fn, void* context);
+    void workerLoop(int index);
+    void executeChunks(int self, ChunkFn fn, void* context, int count, int grain);
+    bool popFront(int self, int &chunk);
+    bool stealBack(int victim, int &chunk);
+    void stopWorkers();
+
+    std::vector<std::thread> mWorkers;
+    std::unique_ptr<ChunkRange[]> mRanges;
+
+    // 当前作业，只在mMutex保护下发布
+    std::mutex mMutex;
+    std::condition_variable mWake;
+    quint64 mGeneration = 0;
+    bool mStopping = false;
+    ChunkFn mFn = nullptr;
+    void* mContext = nullptr;
+    int mCount = 0;
+    int mGrain = 1;
+
+    std::atomic<int> mPendingChunks{ 0 };
+    std::atomic<int> mBusyWorkers{ 0 };
+};
+
+#endif // JOB_SYSTEM_H
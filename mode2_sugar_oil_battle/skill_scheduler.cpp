@@ -0,0 +1,190 @@
+#include "skill_scheduler.h"
+#include "enemy_base.h"
+#include "../snapshot_io.h"
+#include <algorithm>
+
+namespace
+{
+    const quint32 SNAPSHOT_TAG = 0x4c494b53; // "SKIL"
+}
+
+SkillScheduler::SkillScheduler()
+    : mNow(0)
+    , mRunningCount(0)
+{
+}
+
+SkillScheduler::Handle SkillScheduler::makeHandle(int slot, quint32 generation)
+{
+    return (static_cast<Handle>(generation) << 32) | static_cast<quint32>(slot);
+}
+
+SkillScheduler::Handle SkillScheduler::start(EnemyBase* caster, const SkillScript* script)
+{
+    if (!caster || !script || script->count <= 0) {
+        return INVALID_HANDLE;
+    }
+
+    const int slot = allocateSlot();
+    Task &task = mTasks[slot];
+    task.caster = caster;
+    task.script = script;
+    task.pc = 0;
+    task.wakeAt = mNow;
+    ++task.generation;
+    task.active = true;
+    ++mRunningCount;
+
+    const Handle handle = makeHandle(slot, task.generation);
+    run(slot);
+    return handle;
+}
+
+SkillScheduler::Handle SkillScheduler::resume(EnemyBase* caster, const SkillScript* script, int pc, qreal wakeAt)
+{
+    if (!caster || !script || pc <= 0 || pc >= script->count) {
+        return INVALID_HANDLE;
+    }
+
+    // 挂起状态的脚本直接按唤醒时刻入堆，不立即执行
+    const int slot = allocateSlot();
+    Task &task = mTasks[slot];
+    task.caster = caster;
+    task.script = script;
+    task.pc = pc;
+    task.wakeAt = wakeAt;
+    ++task.generation;
+    task.active = true;
+    ++mRunningCount;
+
+    mHeap.append({ task.wakeAt, slot, task.generation });
+    std::push_heap(mHeap.begin(), mHeap.end(), &SkillScheduler::laterWake);
+    return makeHandle(slot, task.generation);
+}
+
+int SkillScheduler::allocateSlot()
+{
+    if (!mFreeSlots.isEmpty()) {
+        return mFreeSlots.takeLast();
+    }
+    Task task;
+    task.generation = 0;
+    mTasks.append(task);
+    return mTasks.size() - 1;
+}
+
+bool SkillScheduler::getTaskState(Handle handle, int &pc, qreal &wakeAt) const
+{
+    if (!isRunning(handle)) {
+        return false;
+    }
+    const Task &task = mTasks[static_cast<int>(handle & 0xffffffff)];
+    pc = task.pc;
+    wakeAt = task.wakeAt;
+    return true;
+}
+
+void SkillScheduler::saveState(SnapshotWriter &writer) const
+{
+    writer.beginSection(SNAPSHOT_TAG);
+    writer.write(mNow);
+}
+
+bool SkillScheduler::restoreState(SnapshotReader &reader)
+{
+    clear();
+    return reader.expectSection(SNAPSHOT_TAG) && reader.read(mNow);
+}
+
+void SkillScheduler::cancel(Handle handle)
+{
+    if (!isRunning(handle)) {
+        return;
+    }
+    // 堆中的条目因generation不匹配自动作废
+    finish(static_cast<int>(handle & 0xffffffff));
+}
+
+bool SkillScheduler::isRunning(Handle handle) const
+{
+    if (handle < 0) {
+        return false;
+    }
+    const int slot = static_cast<int>(handle & 0xffffffff);
+    const quint32 generation = static_cast<quint32>(handle >> 32);
+    return slot < mTasks.size() && mTasks[slot].active && mTasks[slot].generation == generation;
+}
+
+void SkillScheduler::advance(qreal dtMs)
+{
+    if (dtMs <= 0.0) {
+        return;
+    }
+    mNow += dtMs;
+
+    while (!mHeap.isEmpty() && mHeap.first().wakeAt <= mNow) {
+        std::pop_heap(mHeap.begin(), mHeap.end(), &SkillScheduler::laterWake);
+        const HeapEntry entry = mHeap.takeLast();
+        const Task &task = mTasks[entry.slot];
+        if (!task.active || task.generation != entry.generation) {
+            continue; // 已取消
+        }
+        run(entry.slot);
+    }
+}
+
+void SkillScheduler::clear()
+{
+    mTasks.clear();
+    mFreeSlots.clear();
+    mHeap.clear();
+    mNow = 0;
+    mRunningCount = 0;
+}
+
+bool SkillScheduler::laterWake(const HeapEntry &a, const HeapEntry &b)
+{
+    // 最小堆比较：唤醒越早越靠前
+    return a.wakeAt > b.wakeAt;
+}
+
+void SkillScheduler::run(int slot)
+{
+    // 执行到下一个Wait或脚本结束；指令可能回调到场景，所以每步都重新取引用
+    while (true) {
+        Task &task = mTasks[slot];
+        if (!task.active) {
+            return; // 执行过程中被取消（例如敌人死亡）
+        }
+        if (task.pc >= task.script->count) {
+            finish(slot);
+            return;
+        }
+
+        const SkillOp op = task.script->ops[task.pc++];
+        if (op.kind == SkillOp::Wait) {
+            // 以上次唤醒时刻为基准，帧长不整除时也不会累积误差
+            task.wakeAt += op.arg;
+            mHeap.append({ task.wakeAt, slot, task.generation });
+            std::push_heap(mHeap.begin(), mHeap.end(), &SkillScheduler::laterWake);
+            return;
+        }
+
+        EnemyBase* caster = task.caster;
+        if (op.kind == SkillOp::Pattern) {
+            caster->firePattern(static_cast<BulletPatternId>(op.arg));
+        } else {
+            caster->attack();
+        }
+    }
+}
+
+void SkillScheduler::finish(int slot)
+{
+    Task &task = mTasks[slot];
+    task.active = false;
+    task.caster = nullptr;
+    ++task.generation;
+    --mRunningCount;
+    mFreeSlots.append(slot);
+}
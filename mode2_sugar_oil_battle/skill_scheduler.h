@@ -0,0 +1,90 @@
+#ifndef SKILL_SCHEDULER_H
+#define SKILL_SCHEDULER_H
+
+#include <QtGlobal>
+#include <QVector>
+
+class EnemyBase;
+class SnapshotWriter;
+class SnapshotReader;
+
+// 技能脚本指令
+struct SkillOp {
+    enum Kind {
+        Fire,     // 朝玩家攻击一次
+        Pattern,  // 发射一次弹幕图案，arg为BulletPatternId
+        Wait      // 等待arg毫秒（敌人阵营的游戏时间）
+    };
+    Kind kind;
+    int arg;
+};
+
+// 技能脚本：一段静态的指令序列，按敌人类型共享
+struct SkillScript {
+    const SkillOp* ops;
+    int count;
+};
+
+// 敌人技能调度器
+// 技能写成"攻击 → 等待 → 攻击"的脚本，执行到Wait时挂起，按唤醒时刻放进最小堆；
+// 场景每帧用敌人阵营缩放后的时间推进一次，到期的脚本从同一个就绪队列里依次恢复。
+// 不需要为每次技能创建QTimer，暂停和冻结时自然停止；敌人死亡时cancel()使其失效
+class SkillScheduler
+{
+public:
+    typedef qint64 Handle;
+    static const Handle INVALID_HANDLE = -1;
+
+    SkillScheduler();
+
+    // 启动脚本，第一段指令立即执行到第一个Wait为止
+    Handle start(EnemyBase* caster, const SkillScript* script);
+    void cancel(Handle handle);
+    bool isRunning(Handle handle) const;
+
+    // 推进dtMs毫秒并恢复所有到期的脚本
+    void advance(qreal dtMs);
+
+    // 清除所有脚本并把时间归零（新一局游戏）
+    void clear();
+
+    // 快照：脚本在帧与帧之间总是停在某个Wait上，状态就是下一条指令和唤醒时刻。
+    // 调度器只保存自己的时间，各脚本的状态随施放者一起保存，读档时用resume()挂回
+    bool getTaskState(Handle handle, int &pc, qreal &wakeAt) const;
+    Handle resume(EnemyBase* caster, const SkillScript* script, int pc, qreal wakeAt);
+    void saveState(SnapshotWriter &writer) const;
+    bool restoreState(SnapshotReader &reader);
+
+    qreal getNow() const { return mNow; }
+    int getRunningCount() const { return mRunningCount; }
+
+private:
+    struct Task {
+        EnemyBase* caster;
+        const SkillScript* script;
+        int pc;              // 下一条要执行的指令
+        qreal wakeAt;
+        quint32 generation;  // 每次复用或取消递增，使旧句柄和堆中的旧条目失效
+        bool active;
+    };
+
+    struct HeapEntry {
+        qreal wakeAt;
+        int slot;
+        quint32 generation;
+    };
+
+    static Handle makeHandle(int slot, quint32 generation);
+    int allocateSlot();
+    static bool laterWake(const HeapEntry &a, const HeapEntry &b);
+    void run(int slot);
+    void finish(int slot);
+
+    QVector<Task> mTasks;
+    QVector<int> mFreeSlots;
+    QVector<HeapEntry> mHeap;
+    qreal mNow;
+    int mRunningCount;
+};
+
+#endif // SKILL_SCHEDULER_H
@@ -0,0 +1,109 @@
+#include "spatial_grid.h"
+#include "job_system.h"
+#include <cmath>
+
+SpatialGrid::SpatialGrid(float originX, float originY, float width, float height, float cellSize)
+    : mOriginX(originX)
+    , mOriginY(originY)
+    , mCellSize(cellSize)
+    , mInvCellSize(1.0f / cellSize)
+    , mCols(qMax(1, static_cast<int>(std::ceil(width / cellSize))))
+    , mRows(qMax(1, static_cast<int>(std::ceil(height / cellSize))))
+{
+    mCellStart.resize(mCols * mRows + 1);
+}
+
+int SpatialGrid::clampCol(float x) const
+{
+    const int col = static_cast<int>(std::floor((x - mOriginX) * mInvCellSize));
+    return qBound(0, col, mCols - 1);
+}
+
+int SpatialGrid::clampRow(float y) const
+{
+    const int row = static_cast<int>(std::floor((y - mOriginY) * mInvCellSize));
+    return qBound(0, row, mRows - 1);
+}
+
+void SpatialGrid::build(const float* xs, const float* ys, int count, JobSystem* jobs)
+{
+    if (jobs && jobs->getThreadCount() > 1 && count > BUILD_GRAIN) {
+        buildParallel(xs, ys, count, *jobs);
+        return;
+    }
+
+    const int cellCount = mCols * mRows;
+    mPointCell.resize(count);
+    mSortedIndices.resize(count);
+    mCellStart.fill(0);
+
+    // 第一遍：统计每个格子的点数
+    for (int i = 0; i < count; ++i) {
+        const int cell = clampRow(ys[i]) * mCols + clampCol(xs[i]);
+        mPointCell[i] = cell;
+        ++mCellStart[cell + 1];
+    }
+
+    // 前缀和得到每个格子的起始下标
+    for (int c = 0; c < cellCount; ++c) {
+        mCellStart[c + 1] += mCellStart[c];
+    }
+
+    // 第二遍：按格子分桶写入，mCellStart[cell]充当写入游标
+    for (int i = 0; i < count; ++i) {
+        mSortedIndices[mCellStart[mPointCell[i]]++] = i;
+    }
+
+    // 第二遍把起始下标推进到了结束位置，整体右移一格恢复
+    for (int c = cellCount; c > 0; --c) {
+        mCellStart[c] = mCellStart[c - 1];
+    }
+    mCellStart[0] = 0;
+}
+
+void SpatialGrid::buildParallel(const float* xs, const float* ys, int count, JobSystem &jobs)
+{
+    const int cellCount = mCols * mRows;
+    const int chunkCount = (count + BUILD_GRAIN - 1) / BUILD_GRAIN;
+    mPointCell.resize(count);
+    mSortedIndices.resize(count);
+    mChunkCounts.resize(chunkCount * cellCount);
+    mChunkCounts.fill(0);
+
+    // 工作线程中只通过裸指针访问，避免QVector的写时复制检查
+    int* pointCell = mPointCell.data();
+    int* sorted = mSortedIndices.data();
+    int* chunkCounts = mChunkCounts.data();
+
+    // 第一遍（并行）：每个块统计自己负责的点落在各格子的数量
+    jobs.parallelFor(count, BUILD_GRAIN, [=](int begin, int end) {
+        int* counts = chunkCounts + (begin / BUILD_GRAIN) * cellCount;
+        for (int i = begin; i < end; ++i) {
+            const int cell = clampRow(ys[i]) * mCols + clampCol(xs[i]);
+            pointCell[i] = cell;
+            ++counts[cell];
+        }
+    });
+
+    // 前缀和：格子为主序、块为次序，每个块在格子内得到自己的写入起点，
+    // 格子内的下标顺序因此与单线程重建一致
+    int running = 0;
+    for (int c = 0; c < cellCount; ++c) {
+        mCellStart[c] = running;
+        for (int chunk = 0; chunk < chunkCount; ++chunk) {
+            int &slot = chunkCounts[chunk * cellCount + c];
+            const int cellPoints = slot;
+            slot = running;
+            running += cellPoints;
+        }
+    }
+    mCellStart[cellCount] = running;
+
+    // 第二遍（并行）：各块按自己的游标分桶写入，写入位置互不重叠
+    jobs.parallelFor(count, BUILD_GRAIN, [=](int begin, int end) {
+        int* cursors = chunkCounts + (begin / BUILD_GRAIN) * cellCount;
+        for (int i = begin; i < end; ++i) {
+            sorted[cursors[pointCell[i]]++] = i;
+        }
+    });
+}
@@ -0,0 +1,104 @@
+#ifndef SPATIAL_GRID_H
+#define SPATIAL_GRID_H
+
+#include <QtGlobal>
+#include <QVector>
+
+class JobSystem;
+
+// 均匀网格空间索引
+// 每帧用计数排序重建一次（O(n)），邻居查询只遍历查询圆覆盖的格子，
+// 避免两两比较的O(n²)开销。超出网格范围的点会被归入边缘格子，查询结果仍然正确
+class SpatialGrid
+{
+public:
+    SpatialGrid(float originX, float originY, float width, float height, float cellSize);
+
+    // 用SoA坐标重建网格，索引即数组下标
+    // 传入jobs且点数超过一块时，计数和分桶两遍按块并行，结果与单线程重建完全相同
+    void build(const float* xs, const float* ys, int count, JobSystem* jobs = nullptr);
+
+    // 遍历(x, y)半径radius范围所在格子中的所有点（粗筛，距离需调用方自行判断）
+    // fn(int index)返回false时提前结束遍历
+    template<typename Fn>
+    void forEachCandidate(float x, float y, float radius, Fn fn) const
+    {
+        forEachCandidateInRect(x - radius, y - radius, x + radius, y + radius, fn);
+    }
+
+    // 遍历矩形[minX, maxX]×[minY, maxY]覆盖的格子中的所有点（粗筛）
+    template<typename Fn>
+    void forEachCandidateInRect(float minX, float minY, float maxX, float maxY, Fn fn) const
+    {
+        const int minCol = clampCol(minX);
+        const int maxCol = clampCol(maxX);
+        const int minRow = clampRow(minY);
+        const int maxRow = clampRow(maxY);
+        for (int row = minRow; row <= maxRow; ++row) {
+            for (int col = minCol; col <= maxCol; ++col) {
+                const int cell = row * mCols + col;
+                for (int k = mCellStart[cell]; k < mCellStart[cell + 1]; ++k) {
+                    if (!fn(mSortedIndices[k])) {
+                        return;
+                    }
+                }
+            }
+        }
+    }
+
+    // 遍历(x, y)所在格子外第ring圈（切比雪夫距离为ring）格子中的所有点，fn(int index)
+    // 返回false表示这一圈已完全落在网格之外，更外圈也不会再有点
+    template<typename Fn>
+    bool forEachInRing(float x, float y, int ring, Fn fn) const
+    {
+        const int centerCol = clampCol(x);
+        const int centerRow = clampRow(y);
+        if (centerCol - ring < 0 && centerCol + ring >= mCols
+            && centerRow - ring < 0 && centerRow + ring >= mRows) {
+            return false;
+        }
+        const int minRow = qMax(0, centerRow - ring);
+        const int maxRow = qMin(mRows - 1, centerRow + ring);
+        for (int row = minRow; row <= maxRow; ++row) {
+            // 上下两条边整行遍历，中间只取左右两列
+            const bool edgeRow = (row == centerRow - ring || row == centerRow + ring);
+            const int colStep = (edgeRow || ring == 0) ? 1 : 2 * ring;
+            for (int col = centerCol - ring; col <= centerCol + ring; col += colStep) {
+                if (col < 0 || col >= mCols) {
+                    continue;
+                }
+                const int cell = row * mCols + col;
+                for (int k = mCellStart[cell]; k < mCellStart[cell + 1]; ++k) {
+                    fn(mSortedIndices[k]);
+                }
+            }
+        }
+        return true;
+    }
+
+    float getCellSize() const { return mCellSize; }
+    int getCellCount() const { return mCols * mRows; }
+
+private:
+    int clampCol(float x) const;
+    int clampRow(float y) const;
+    void buildParallel(const float* xs, const float* ys, int count, JobSystem &jobs);
+
+    float mOriginX;
+    float mOriginY;
+    float mCellSize;
+    float mInvCellSize;
+    int mCols;
+    int mRows;
+
+    // 计数排序结果：格子c中的点为mSortedIndices[mCellStart[c] .. mCellStart[c+1])
+    QVector<int> mCellStart;
+    QVector<int> mSortedIndices;
+    QVector<int> mPointCell;
+    // 并行重建时每个块各自的格子计数，块号为主序
+    QVector<int> mChunkCounts;
+
+    static const int BUILD_GRAIN = 2048; // 并行重建时每块的点数
+};
+
+#endif // SPATIAL_GRID_H
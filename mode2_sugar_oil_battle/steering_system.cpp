@@ -0,0 +1,199 @@
+#include "steering_system.h"
+#include "spatial_grid.h"
+#include "job_system.h"
+#include <cmath>
+
+#if defined(__AVX__)
+#include <immintrin.h>
+#define STEERING_USE_AVX 1
+#elif defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+#include <xmmintrin.h>
+#define STEERING_USE_SSE 1
+#endif
+
+void SteeringSystem::computeSeekDirections(const float* xs, const float* ys, int count,
+                                           float targetX, float targetY, float arriveRadius,
+                                           float* outDirX, float* outDirY)
+{
+    int i = 0;
+
+#if defined(STEERING_USE_AVX)
+    // AVX：一次处理8个追踪者
+    const __m256 tx = _mm256_set1_ps(targetX);
+    const __m256 ty = _mm256_set1_ps(targetY);
+    const __m256 arrive = _mm256_set1_ps(arriveRadius);
+    for (; i + 8 <= count; i += 8) {
+        __m256 dx = _mm256_sub_ps(tx, _mm256_loadu_ps(xs + i));
+        __m256 dy = _mm256_sub_ps(ty, _mm256_loadu_ps(ys + i));
+        __m256 len = _mm256_sqrt_ps(_mm256_add_ps(_mm256_mul_ps(dx, dx), _mm256_mul_ps(dy, dy)));
+        // 已到达目标的通道置零，同时避免除以0
+        __m256 moving = _mm256_cmp_ps(len, arrive, _CMP_GT_OQ);
+        __m256 safeLen = _mm256_blendv_ps(_mm256_set1_ps(1.0f), len, moving);
+        _mm256_storeu_ps(outDirX + i, _mm256_and_ps(_mm256_div_ps(dx, safeLen), moving));
+        _mm256_storeu_ps(outDirY + i, _mm256_and_ps(_mm256_div_ps(dy, safeLen), moving));
+    }
+#elif defined(STEERING_USE_SSE)
+    // SSE：一次处理4个追踪者
+    const __m128 tx = _mm_set1_ps(targetX);
+    const __m128 ty = _mm_set1_ps(targetY);
+    const __m128 arrive = _mm_set1_ps(arriveRadius);
+    const __m128 one = _mm_set1_ps(1.0f);
+    for (; i + 4 <= count; i += 4) {
+        __m128 dx = _mm_sub_ps(tx, _mm_loadu_ps(xs + i));
+        __m128 dy = _mm_sub_ps(ty, _mm_loadu_ps(ys + i));
+        __m128 len = _mm_sqrt_ps(_mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy)));
+        // 已到达目标的通道置零，同时避免除以0
+        __m128 moving = _mm_cmpgt_ps(len, arrive);
+        __m128 safeLen = _mm_or_ps(_mm_and_ps(moving, len), _mm_andnot_ps(moving, one));
+        _mm_storeu_ps(outDirX + i, _mm_and_ps(_mm_div_ps(dx, safeLen), moving));
+        _mm_storeu_ps(outDirY + i, _mm_and_ps(_mm_div_ps(dy, safeLen), moving));
+    }
+#endif
+
+    // 剩余部分（或不支持SIMD的平台）走标量路径
+    computeSeekDirectionsScalar(xs, ys, i, count, targetX, targetY, arriveRadius, outDirX, outDirY);
+}
+
+void SteeringSystem::computeSeekDirectionsScalar(const float* xs, const float* ys, int begin, int end,
+                                                 float targetX, float targetY, float arriveRadius,
+                                                 float* outDirX, float* outDirY)
+{
+    // 循环体无分支依赖，编译器可以自动向量化
+    for (int i = begin; i < end; ++i) {
+        const float dx = targetX - xs[i];
+        const float dy = targetY - ys[i];
+        const float len = std::sqrt(dx * dx + dy * dy);
+        const bool moving = len > arriveRadius;
+        const float safeLen = moving ? len : 1.0f;
+        outDirX[i] = moving ? dx / safeLen : 0.0f;
+        outDirY[i] = moving ? dy / safeLen : 0.0f;
+    }
+}
+
+void SteeringSystem::integratePositions(float* xs, float* ys,
+                                        const float* dirX, const float* dirY,
+                                        const float* speeds, int count)
+{
+    for (int i = 0; i < count; ++i) {
+        xs[i] += dirX[i] * speeds[i];
+        ys[i] += dirY[i] * speeds[i];
+    }
+}
+
+void SteeringSystem::applyCrowdSteering(const float* xs, const float* ys, int count,
+                                        const SpatialGrid &grid,
+                                        const quint8* groups, const CrowdSteeringParams* groupParams,
+                                        float* dirX, float* dirY)
+{
+    applyCrowdSteeringRange(xs, ys, 0, count, grid, groups, groupParams, dirX, dirY);
+}
+
+void SteeringSystem::steer(JobSystem* jobs, float* xs, float* ys, int count, int total,
+                           float targetX, float targetY, float arriveRadius,
+                           SpatialGrid* grid, const quint8* groups, const CrowdSteeringParams* groupParams,
+                           const float* speeds, float* dirX, float* dirY)
+{
+    if (count <= 0) {
+        return;
+    }
+
+    auto forEachChunk = [jobs, count](auto fn) {
+        if (jobs) {
+            jobs->parallelFor(count, PARALLEL_GRAIN, fn);
+        } else {
+            fn(0, count);
+        }
+    };
+
+    forEachChunk([&](int begin, int end) {
+        computeSeekDirections(xs + begin, ys + begin, end - begin, targetX, targetY, arriveRadius,
+                              dirX + begin, dirY + begin);
+    });
+
+    // 群体转向读取邻居的位置，必须在积分改写位置之前全部完成
+    if (grid) {
+        grid->build(xs, ys, qMax(count, total), jobs);
+        forEachChunk([&](int begin, int end) {
+            applyCrowdSteeringRange(xs, ys, begin, end, *grid, groups, groupParams, dirX, dirY);
+        });
+    }
+
+    forEachChunk([&](int begin, int end) {
+        integratePositions(xs + begin, ys + begin, dirX + begin, dirY + begin, speeds + begin, end - begin);
+    });
+}
+
+void SteeringSystem::applyCrowdSteeringRange(const float* xs, const float* ys, int begin, int end,
+                                             const SpatialGrid &grid,
+                                             const quint8* groups, const CrowdSteeringParams* groupParams,
+                                             float* dirX, float* dirY)
+{
+    // 只改写[begin, end)的方向，邻居位置只读，不同区间可并行执行
+    for (int i = begin; i < end; ++i) {
+        const CrowdSteeringParams &params = groupParams[groups[i]];
+        const float x = xs[i];
+        const float y = ys[i];
+        const float sepRadiusSq = params.separationRadius * params.separationRadius;
+        const float cohRadiusSq = params.cohesionRadius * params.cohesionRadius;
+        const float queryRadiusSq = qMax(sepRadiusSq, cohRadiusSq);
+
+        float sepX = 0.0f, sepY = 0.0f;
+        float sumX = 0.0f, sumY = 0.0f;
+        int cohesionCount = 0;
+        int neighborCount = 0;
+
+        grid.forEachCandidate(x, y, qMax(params.separationRadius, params.cohesionRadius), [&](int j) {
+            if (j == i) {
+                return true;
+            }
+            const float dx = x - xs[j];
+            const float dy = y - ys[j];
+            const float distSq = dx * dx + dy * dy;
+            // 网格候选包含整格，半径外的不算邻居，也不占用邻居上限
+            if (distSq >= queryRadiusSq) {
+                return true;
+            }
+            if (distSq < sepRadiusSq) {
+                if (distSq > 1e-4f) {
+                    // 越近推力越大，线性衰减到半径处为0
+                    const float dist = std::sqrt(distSq);
+                    const float strength = 1.0f - dist / params.separationRadius;
+                    sepX += dx / dist * strength;
+                    sepY += dy / dist * strength;
+                } else {
+                    // 完全重合时按下标先后向两侧错开，保证结果确定
+                    sepX += (i < j) ? -1.0f : 1.0f;
+                }
+            }
+            if (distSq < cohRadiusSq) {
+                sumX += xs[j];
+                sumY += ys[j];
+                ++cohesionCount;
+            }
+            return ++neighborCount < MAX_CROWD_NEIGHBORS;
+        });
+
+        float steerX = dirX[i] + sepX * params.separationWeight;
+        float steerY = dirY[i] + sepY * params.separationWeight;
+
+        if (cohesionCount > 0) {
+            const float cx = sumX / cohesionCount - x;
+            const float cy = sumY / cohesionCount - y;
+            const float len = std::sqrt(cx * cx + cy * cy);
+            if (len > 1e-4f) {
+                steerX += cx / len * params.cohesionWeight;
+                steerY += cy / len * params.cohesionWeight;
+            }
+        }
+
+        // 合力超过单位长度时归一化，速度上限仍由speeds决定
+        const float lenSq = steerX * steerX + steerY * steerY;
+        if (lenSq > 1.0f) {
+            const float len = std::sqrt(lenSq);
+            steerX /= len;
+            steerY /= len;
+        }
+        dirX[i] = steerX;
+        dirY[i] = steerY;
+    }
+}
@@ -0,0 +1,69 @@
+#ifndef STEERING_SYSTEM_H
+#define STEERING_SYSTEM_H
+
+#include <QtGlobal>
+
+class SpatialGrid;
+class JobSystem;
+
+// 群体转向参数（分离/聚合的作用半径与权重）
+struct CrowdSteeringParams
+{
+    float separationRadius;  // 小于该距离的邻居会相互推开
+    float separationWeight;
+    float cohesionRadius;    // 该范围内的邻居会向彼此的中心靠拢
+    float cohesionWeight;
+};
+
+// 批量转向系统
+// 所有追踪者的坐标按x/y分别紧密排列（SoA），每帧统一计算一次，
+// 支持SSE/AVX时走向量化路径，否则退回到可自动向量化的标量循环
+class SteeringSystem
+{
+public:
+    // 计算每个追踪者指向目标点的单位向量
+    // 距离不大于arriveRadius时输出(0, 0)，表示已到达目标无需移动
+    static void computeSeekDirections(const float* xs, const float* ys, int count,
+                                      float targetX, float targetY, float arriveRadius,
+                                      float* outDirX, float* outDirY);
+
+    // 标量实现：SIMD路径的尾部和不支持SIMD的平台使用，基准中也作为对照
+    static void computeSeekDirectionsScalar(const float* xs, const float* ys, int begin, int end,
+                                            float targetX, float targetY, float arriveRadius,
+                                            float* outDirX, float* outDirY);
+
+    // 按方向和速度批量积分位置（原地写回xs/ys）
+    static void integratePositions(float* xs, float* ys,
+                                   const float* dirX, const float* dirY,
+                                   const float* speeds, int count);
+
+    // 在追踪方向上叠加分离与聚合力，邻居由空间网格提供
+    // groups[i]为第i个追踪者所用参数在groupParams中的下标；结果长度被限制在1以内，保证不超速
+    static void applyCrowdSteering(const float* xs, const float* ys, int count,
+                                   const SpatialGrid &grid,
+                                   const quint8* groups, const CrowdSteeringParams* groupParams,
+                                   float* dirX, float* dirY);
+
+    // 整条转向流水线：追踪方向 → 重建网格 → 群体转向 → 积分，结果写回xs/ys
+    // xs/ys中前count个是本次移动的追踪者，[count, total)只作为邻居放进网格，不转向也不移动
+    // （本帧轮空的敌人仍要推开别人）；dirX/dirY/speeds只需count个
+    // 每个阶段按块并行，块只写自己下标范围内的输出，阶段之间等待全部块完成；
+    // grid为空时跳过群体转向，jobs为空时全部在调用线程执行
+    static void steer(JobSystem* jobs, float* xs, float* ys, int count, int total,
+                      float targetX, float targetY, float arriveRadius,
+                      SpatialGrid* grid, const quint8* groups, const CrowdSteeringParams* groupParams,
+                      const float* speeds, float* dirX, float* dirY);
+
+    // 每个追踪者最多参考的邻居数，避免大量敌人挤在一起时单次查询退化
+    static const int MAX_CROWD_NEIGHBORS = 12;
+    // 并行时每块的追踪者数量（SIMD宽度的整数倍）
+    static const int PARALLEL_GRAIN = 1024;
+
+private:
+    static void applyCrowdSteeringRange(const float* xs, const float* ys, int begin, int end,
+                                        const SpatialGrid &grid,
+                                        const quint8* groups, const CrowdSteeringParams* groupParams,
+                                        float* dirX, float* dirY);
+};
+
+#endif // STEERING_SYSTEM_H
@@ -27,10 +27,10 @@ SugarOilEnemy::SugarOilEnemy(SugarOilEnemyType type, QObject *parent)
     , currentAnimationFrame(0)
     , targetPosition(0, 0)
     , lastPosition(0, 0)
+    , currentClip(AnimationClips::INVALID_CLIP)
 {
     initializeEnemy();
     setupTimers();
-    loadEnemyImages();
     updateEnemyImage();
     startMovementAnimation();
 }
@@ -80,54 +80,39 @@ void SugarOilEnemy::initializeEnemy()
     }
 }
 
-void SugarOilEnemy::loadEnemyImages()
+ClipId SugarOilEnemy::getClip(SugarOilEnemyType type, Pose pose)
 {
-    QString basePath = ":/img/";
-    
-    switch (enemyType) {
-    case ENEMY_FRIED_CHICKEN:
-        enemyImages["idle"] = QPixmap(basePath + "enemy_fried_chicken_idle.png");
-        enemyImages["move"] = QPixmap(basePath + "enemy_fried_chicken_move.png");
-        enemyImages["attack"] = QPixmap(basePath + "enemy_fried_chicken_attack.png");
-        enemyImages["damaged"] = QPixmap(basePath + "enemy_fried_chicken_damaged.png");
-        enemyImages["frozen"] = QPixmap(basePath + "enemy_fried_chicken_frozen.png");
-        break;
-    case ENEMY_BARBECUE:
-        enemyImages["idle"] = QPixmap(basePath + "enemy_barbecue_idle.png");
-        enemyImages["move"] = QPixmap(basePath + "enemy_barbecue_move.png");
-        enemyImages["attack"] = QPixmap(basePath + "enemy_barbecue_attack.png");
-        enemyImages["damaged"] = QPixmap(basePath + "enemy_barbecue_damaged.png");
-        enemyImages["frozen"] = QPixmap(basePath + "enemy_barbecue_frozen.png");
-        break;
-    case ENEMY_MILK_TEA:
-        enemyImages["idle"] = QPixmap(basePath + "enemy_milk_tea_idle.png");
-        enemyImages["move"] = QPixmap(basePath + "enemy_milk_tea_move.png");
-        enemyImages["attack"] = QPixmap(basePath + "enemy_milk_tea_attack.png");
-        enemyImages["damaged"] = QPixmap(basePath + "enemy_milk_tea_damaged.png");
-        enemyImages["frozen"] = QPixmap(basePath + "enemy_milk_tea_frozen.png");
-        break;
-    case ENEMY_SNAIL_NOODLES:
-        enemyImages["idle"] = QPixmap(basePath + "enemy_snail_noodles_idle.png");
-        enemyImages["move"] = QPixmap(basePath + "enemy_snail_noodles_move.png");
-        enemyImages["attack"] = QPixmap(basePath + "enemy_snail_noodles_attack.png");
-        enemyImages["damaged"] = QPixmap(basePath + "enemy_snail_noodles_damaged.png");
-        enemyImages["frozen"] = QPixmap(basePath + "enemy_snail_noodles_frozen.png");
-        break;
-    case ENEMY_CAKE:
-        enemyImages["idle"] = QPixmap(basePath + "enemy_cake_idle.png");
-        enemyImages["move"] = QPixmap(basePath + "enemy_cake_move.png");
-        enemyImages["attack"] = QPixmap(basePath + "enemy_cake_attack.png");
-        enemyImages["damaged"] = QPixmap(basePath + "enemy_cake_damaged.png");
-        enemyImages["frozen"] = QPixmap(basePath + "enemy_cake_frozen.png");
-        break;
-    }
-    
-    // 如果图片加载失败，创建默认图片
-    for (auto it = enemyImages.begin(); it != enemyImages.end(); ++it) {
-        if (it.value().isNull()) {
-            QColor enemyColor = getEnemyColor();
-            it.value() = createDefaultPixmap(SUGAR_OIL_ENEMY_SIZE, SUGAR_OIL_ENEMY_SIZE, enemyColor);
+    // 5种敌人×5种状态，所有实例共用，第一次用到时注册
+    static const QVector<ClipId> clips = []() {
+        const char* const names[] = { "fried_chicken", "barbecue", "milk_tea", "snail_noodles", "cake" };
+        const char* const poses[PoseCount] = { "idle", "move", "attack", "damaged", "frozen" };
+        // 与getEnemyColor()一致，图片加载失败时使用
+        const QColor colors[] = {
+            QColor(255, 100, 100), QColor(100, 100, 255), QColor(128, 0, 128),
+            QColor(255, 165, 0), QColor(128, 128, 128)
+        };
+        
+        AnimationClips* registry = AnimationClips::getInstance();
+        QVector<ClipId> ids;
+        for (int i = 0; i < 5; ++i) {
+            QPixmap fallback(SUGAR_OIL_ENEMY_SIZE, SUGAR_OIL_ENEMY_SIZE);
+            fallback.fill(colors[i]);
+            for (int j = 0; j < PoseCount; ++j) {
+                const QString name = QString("enemy_%1_%2").arg(names[i], poses[j]);
+                ids.append(registry->registerClip(name, { ":/img/" + name + ".png" }, 0, fallback));
+            }
         }
+        return ids;
+    }();
+    return clips[qBound(0, static_cast<int>(type), 4) * PoseCount + pose];
+}
+
+void SugarOilEnemy::showPose(Pose pose)
+{
+    const ClipId clip = getClip(enemyType, pose);
+    if (clip != currentClip) {
+        currentClip = clip;
+        setPixmap(AnimationClips::getInstance()->getFrame(clip, 0));
     }
 }
 
@@ -316,17 +301,17 @@ QPointF SugarOilEnemy::getCenter() const
 
 void SugarOilEnemy::updateEnemyImage()
 {
-    QString imageKey = "idle";
+    Pose pose = PoseIdle;
     
     if (frozen) {
-        imageKey = "frozen";
+        pose = PoseFrozen;
     } else if (attacking) {
-        imageKey = "attack";
+        pose = PoseAttack;
     } else if (isMoving()) {
-        imageKey = "move";
+        pose = PoseMove;
     }
     
-    setPixmap(enemyImages[imageKey]);
+    showPose(pose);
 }
 
 bool SugarOilEnemy::isMoving() const
@@ -411,7 +396,7 @@ void SugarOilEnemy::playDamageAnimation()
     flashAnimation->start(QAbstractAnimation::DeleteWhenStopped);
     
     // 临时显示受伤图片
-    setPixmap(enemyImages["damaged"]);
+    showPose(PoseDamaged);
 }
 
 void SugarOilEnemy::playDeathAnimation()
@@ -8,6 +8,7 @@
 #include <QPropertyAnimation>
 #include <QRandomGenerator>
 #include "sugar_oil_config.h"
+#include "animation_clips.h"
 
 class SugarOilEnemy : public QObject, public QGraphicsPixmapItem
 {
@@ -64,7 +65,6 @@ public:
     void playDestroyAnimation();
     void playFreezeAnimation();
     void playDamageAnimation();
-    void loadEnemyImages();
     void initializeEnemy();
     
     // 战斗相关
@@ -136,9 +136,19 @@ private:
     // 动画相关
     int animationFrame;
     int currentAnimationFrame;
-    QList<QPixmap> sprites;
-    QList<QPixmap> frozenSprites;
-    QMap<QString, QPixmap> enemyImages;
+    
+    // 各状态的图像是共享片段表中的单帧片段，按敌人类型注册一次，这里只记当前片段
+    enum Pose {
+        PoseIdle,
+        PoseMove,
+        PoseAttack,
+        PoseDamaged,
+        PoseFrozen,
+        PoseCount
+    };
+    static ClipId getClip(SugarOilEnemyType type, Pose pose);
+    void showPose(Pose pose);
+    ClipId currentClip;
     
     // 视觉效果
     QPropertyAnimation* destroyAnimation;
@@ -7,35 +7,70 @@
 #include <QSet>
 #include <QtMath>
 #include <QUrl>
+#include <QStandardPaths>
+#include <QFile>
+#include <QGuiApplication>
+#include <QScreen>
+#include "../asset_cache.h"
+
+namespace
+{
+    // 并行判断AI细节等级时的一个条目，index为敌人在列表中的下标（决定降频时的错帧）
+    struct AILevelEntry {
+        EnemyBase* enemy;
+        QPointF center;
+        EnemyBase::AILevel level;
+    };
+}
 
 SugarOilGameSceneNew::SugarOilGameSceneNew(QObject *parent)
     : QGraphicsScene(parent)
     , mPlayer(nullptr)
-    , mBackground(nullptr)
-    , mGameTimer(nullptr)
+    , mEnemyBulletStore(MAX_ENEMY_BULLETS)
+    , mEnemyBulletItem(nullptr)
+    , mEnemyGrid(-ENEMY_GRID_MARGIN, -ENEMY_GRID_MARGIN,
+                 SCENE_WIDTH + 2 * ENEMY_GRID_MARGIN, SCENE_HEIGHT + 2 * ENEMY_GRID_MARGIN,
+                 ENEMY_GRID_CELL_SIZE)
+    , mQueryIndex(-ENEMY_GRID_MARGIN, -ENEMY_GRID_MARGIN,
+                  SCENE_WIDTH + 2 * ENEMY_GRID_MARGIN, SCENE_HEIGHT + 2 * ENEMY_GRID_MARGIN,
+                  QUERY_GRID_CELL_SIZE)
     , mUpdateTimer(nullptr)
-    , mSpawnTimer(nullptr)
+    , mSimTimeNs(0)
     , mGameRunning(false)
     , mGamePaused(false)
     , mGameTime(0)
+    , mTick(0)
+    , mSeed(0)
     , mSpawnCounter(0)
+    , mNextEnemyId(0)
+    , mReplaying(false)
+    , mLastKeyMask(0)
+    , mNextAutosaveAt(AUTOSAVE_INTERVAL)
+    , mAutosaveEnabled(false)
+    , mAutosavePath(getAutosavePath())
     , mMousePressed(false)
     , mItemManager(nullptr)
     , mCreatureManager(nullptr)
-    , mItemSpawnTimer(nullptr)
-    , mCreatureSpawnTimer(nullptr)
+    , mNextItemSpawnAt(ITEM_SPAWN_INTERVAL)
+    , mNextCreatureSpawnAt(CREATURE_SPAWN_INTERVAL)
     , mItemSpawnCounter(0)
     , mCreatureSpawnCounter(0)
 {
+    // 帧循环在主线程，分配计数从这里开始统计本线程
+    AllocTracker::trackCurrentThread();
+    
     initializeScene();
     initializePlayer();
     initializeTimers();
     initializeAudio();
     initializeManagers();
     loadBackground();
+    applyRenderProfile(RenderProfiles::current());
     
     // 初始化性能监控
     mPerformanceTimer.start();
+    mSimTimer.start();
+    mInputQueue.reserve(INPUT_QUEUE_CAPACITY);
 }
 
 SugarOilGameSceneNew::~SugarOilGameSceneNew()
@@ -43,14 +78,15 @@ SugarOilGameSceneNew::~SugarOilGameSceneNew()
     stopGame();
     
     // 安全清理所有游戏对象，防止重复删除
+    // 敌人和道具先回收到对象池，再连同池中的实例一起删除（池中的实例仍在场景里）
     for (EnemyBase* enemy : mEnemies) {
         if (enemy) {
-            enemy->stopAI();
-            removeItem(enemy);
-            enemy->deleteLater();
+            releaseEnemy(enemy);
         }
     }
     mEnemies.clear();
+    qDeleteAll(mEnemyPool);
+    mEnemyPool.clear();
     
     // 子弹使用对象池，需要正确归还
     for (BulletBase* bullet : mPlayerBullets) {
@@ -61,27 +97,21 @@ SugarOilGameSceneNew::~SugarOilGameSceneNew()
     }
     mPlayerBullets.clear();
     
-    for (BulletBase* bullet : mEnemyBullets) {
-        if (bullet) {
-            removeItem(bullet);
-            BulletBase::returnBulletToPool(bullet);
-        }
-    }
-    mEnemyBullets.clear();
+    // 敌人子弹存储和绘制图元随场景一起释放
     
     // 清理道具和生物
     for (GameItem* item : mItems) {
         if (item) {
-            removeItem(item);
-            item->deleteLater();
+            mItemManager->releaseItem(item);
         }
     }
     mItems.clear();
+    mItemManager->clearPool();
     
     for (GameCreature* creature : mCreatures) {
         if (creature) {
             removeItem(creature);
-            creature->deleteLater();
+            mCreatureManager->releaseCreature(creature);
         }
     }
     mCreatures.clear();
@@ -97,17 +127,11 @@ SugarOilGameSceneNew::~SugarOilGameSceneNew()
 void SugarOilGameSceneNew::initializeScene()
 {
     setSceneRect(0, 0, SCENE_WIDTH, SCENE_HEIGHT);
-    // 使用与模式1相同的背景图片
-    QPixmap backgroundPixmap(":/img/GameBackground.png");
-    if (backgroundPixmap.isNull()) {
-        // 如果背景图片加载失败，使用默认背景
-        backgroundPixmap = QPixmap(SCENE_WIDTH, SCENE_HEIGHT);
-        backgroundPixmap.fill(QColor(20, 20, 40));
-    } else {
-        // 缩放背景图片以适应场景大小
-        backgroundPixmap = backgroundPixmap.scaled(SCENE_WIDTH, SCENE_HEIGHT, Qt::KeepAspectRatioByExpanding, Qt::SmoothTransformation);
-    }
-    setBackgroundBrush(QBrush(backgroundPixmap));
+    
+    // 所有敌人子弹由一个图元批量绘制
+    mEnemyBulletItem = new BulletStoreItem(sceneRect().adjusted(-BULLET_BOUNDS_MARGIN, -BULLET_BOUNDS_MARGIN,
+                                                                BULLET_BOUNDS_MARGIN, BULLET_BOUNDS_MARGIN));
+    addItem(mEnemyBulletItem);
     
     // 添加地图边界
     drawMapBoundaries();
@@ -132,28 +156,14 @@ void SugarOilGameSceneNew::initializePlayer()
 
 void SugarOilGameSceneNew::initializeTimers()
 {
-    // 游戏时间定时器（每秒更新）
-    mGameTimer = new QTimer(this);
-    mGameTimer->setInterval(1000);
-    connect(mGameTimer, &QTimer::timeout, this, &SugarOilGameSceneNew::onGameTimerTimeout);
-    
-    // 游戏更新定时器（60 FPS）
+    // 显示帧定时器：按屏幕刷新率触发，逻辑帧在其中按固定步长推进
     mUpdateTimer = new QTimer(this);
-    mUpdateTimer->setInterval(UPDATE_INTERVAL);
-    connect(mUpdateTimer, &QTimer::timeout, this, &SugarOilGameSceneNew::updateGame);
-    
-    // 敌人生成定时器
-    mSpawnTimer = new QTimer(this);
-    mSpawnTimer->setInterval(SPAWN_INTERVAL);
-    connect(mSpawnTimer, &QTimer::timeout, this, &SugarOilGameSceneNew::spawnEnemies);
+    mUpdateTimer->setTimerType(Qt::PreciseTimer);
+    mUpdateTimer->setInterval(getDisplayInterval());
+    connect(mUpdateTimer, &QTimer::timeout, this, &SugarOilGameSceneNew::onDisplayFrame);
     
-    // 道具生成定时器
-    mItemSpawnTimer = new QTimer(this);
-    connect(mItemSpawnTimer, &QTimer::timeout, this, &SugarOilGameSceneNew::updateItemSpawning);
-    
-    // 生物生成定时器
-    mCreatureSpawnTimer = new QTimer(this);
-    connect(mCreatureSpawnTimer, &QTimer::timeout, this, &SugarOilGameSceneNew::updateCreatureSpawning);
+    // 倒计时、敌人、道具和生物的生成都在帧更新中按游戏时钟推进，不再使用单独的定时器
+    // 这样整局模拟只由帧序号和输入决定，可以按录像精确重现
 }
 
 void SugarOilGameSceneNew::initializeAudio()
@@ -166,12 +176,27 @@ void SugarOilGameSceneNew::initializeManagers()
 {
     mItemManager = new ItemManager(this);
     mCreatureManager = new CreatureManager(this);
+    mItemManager->setRandomGenerator(&mRandom);
+    mCreatureManager->setRandomGenerator(&mRandom);
+    mWaveDirector.setRandomGenerator(&mRandom);
+    
+    // 波次表读取失败时使用内置的默认节奏
+    mWaveDirector.loadFromFile(":/data/sugar_oil_waves.json");
+    
+    // 敌人和道具在开局前一次性创建好，对局中只从池里取用和归还
+    mEnemies.reserve(ENEMY_POOL_SIZE);
+    mEnemyPool.reserve(ENEMY_POOL_SIZE);
+    for (int i = 0; i < ENEMY_POOL_SIZE; ++i) {
+        mEnemyPool.append(createPooledEnemy());
+    }
+    mItems.reserve(ITEM_POOL_SIZE);
+    mItemManager->reservePool(this, ITEM_POOL_SIZE);
 }
 
 void SugarOilGameSceneNew::loadBackground()
 {
     // 使用与模式1相同的背景图片
-    QPixmap backgroundPixmap(":/img/GameBackground.png");
+    QPixmap backgroundPixmap = AssetCache::getInstance()->pixmap(":/img/GameBackground.png");
     if (backgroundPixmap.isNull()) {
         // 如果背景图片加载失败，使用默认背景
         backgroundPixmap = QPixmap(SCENE_WIDTH, SCENE_HEIGHT);
@@ -181,8 +206,19 @@ void SugarOilGameSceneNew::loadBackground()
         backgroundPixmap = backgroundPixmap.scaled(SCENE_WIDTH, SCENE_HEIGHT, Qt::KeepAspectRatioByExpanding, Qt::SmoothTransformation);
     }
     
-    mBackground = addPixmap(backgroundPixmap);
-    mBackground->setZValue(-1); // 确保背景在最底层
+    // 背景只在drawBackground()中画一次，不再另加整屏的背景图元
+    mStaticLayer.setBackground(backgroundPixmap);
+}
+
+void SugarOilGameSceneNew::applyRenderProfile(RenderProfile profile)
+{
+    mStaticLayer.apply(profile);
+    invalidate(sceneRect(), QGraphicsScene::BackgroundLayer);
+}
+
+void SugarOilGameSceneNew::drawBackground(QPainter *painter, const QRectF &rect)
+{
+    mStaticLayer.draw(painter, rect);
 }
 
 void SugarOilGameSceneNew::startGame()
@@ -191,16 +227,17 @@ void SugarOilGameSceneNew::startGame()
         return;
     }
     
+    // 开始新的一局，旧的自动存档作废（回放不影响存档）
+    if (!mReplaying) {
+        discardAutosave();
+    }
+    
     resetGame();
     mGameRunning = true;
     mGamePaused = false;
     
-    // 启动所有定时器
-    mGameTimer->start();
-    mUpdateTimer->start();
-    mSpawnTimer->start();
-    mItemSpawnTimer->start(8000); // 每8秒生成一个道具
-    mCreatureSpawnTimer->start(15000); // 每15秒生成一个生物
+    // 启动帧更新定时器
+    startFrameLoop();
     
     // 音频切换由主窗口统一管理
     
@@ -217,43 +254,14 @@ void SugarOilGameSceneNew::pauseGame()
     
     mGamePaused = true;
     
-    // 暂停所有定时器
-    mGameTimer->stop();
+    // 暂停帧更新定时器
     mUpdateTimer->stop();
-    mSpawnTimer->stop();
-    mItemSpawnTimer->stop();
-    mCreatureSpawnTimer->stop();
+    mFrameTimer.invalidate(); // 暂停期间不计入帧时间
     
     // 音频暂停由AudioManager统一管理
     AudioManager::getInstance()->pauseCurrentMusic();
     
-    // 暂停所有敌人的AI和技能定时器
-    for (EnemyBase* enemy : mEnemies) {
-        if (enemy) {
-            enemy->stopAI();
-            // 确保敌人的所有定时器都被停止，包括技能定时器
-            enemy->stopAllTimers();
-        }
-    }
-    
-    // 暂停所有生物的移动
-    for (GameCreature* creature : mCreatures) {
-        if (creature) {
-            creature->pauseMovement();
-        }
-    }
-    
-    // 暂停所有子弹的移动
-    for (BulletBase* bullet : mPlayerBullets) {
-        if (bullet) {
-            bullet->stopMoving();
-        }
-    }
-    for (BulletBase* bullet : mEnemyBullets) {
-        if (bullet) {
-            bullet->stopMoving();
-        }
-    }
+    // 敌人AI、技能、子弹移动和玩家效果都由游戏时钟驱动，更新定时器停止后自然暂停
     
     // 暂停玩家的所有定时器
     if (mPlayer) {
@@ -273,44 +281,12 @@ void SugarOilGameSceneNew::resumeGame()
     
     mGamePaused = false;
     
-    // 恢复所有定时器
-    mGameTimer->start();
-    mUpdateTimer->start();
-    mSpawnTimer->start();
-    mItemSpawnTimer->start();
-    mCreatureSpawnTimer->start();
+    // 恢复帧更新定时器，暂停期间的时间不补帧
+    startFrameLoop();
     
     // 音频恢复由AudioManager统一管理
     AudioManager::getInstance()->resumeCurrentMusic();
     
-    // 恢复所有敌人的AI和技能定时器
-    for (EnemyBase* enemy : mEnemies) {
-        if (enemy) {
-            enemy->startAI();
-            // 恢复敌人的所有定时器
-            enemy->resumeAllTimers();
-        }
-    }
-    
-    // 恢复所有生物的移动
-    for (GameCreature* creature : mCreatures) {
-        if (creature) {
-            creature->resumeMovement();
-        }
-    }
-    
-    // 恢复所有子弹的移动
-    for (BulletBase* bullet : mPlayerBullets) {
-        if (bullet) {
-            bullet->startMoving();
-        }
-    }
-    for (BulletBase* bullet : mEnemyBullets) {
-        if (bullet) {
-            bullet->startMoving();
-        }
-    }
-    
     // 恢复玩家的所有定时器
     if (mPlayer) {
         mPlayer->resumeAllTimers();
@@ -330,12 +306,19 @@ void SugarOilGameSceneNew::stopGame()
     mGameRunning = false;
     mGamePaused = false;
     
-    // 停止所有定时器
-    if (mGameTimer) mGameTimer->stop();
+    // 停止帧更新定时器
     if (mUpdateTimer) mUpdateTimer->stop();
-    if (mSpawnTimer) mSpawnTimer->stop();
-    if (mItemSpawnTimer) mItemSpawnTimer->stop();
-    if (mCreatureSpawnTimer) mCreatureSpawnTimer->stop();
+    
+    // 结束录制并保存，回放结束时关闭录像
+    if (mReplaying) {
+        mReplaying = false;
+        mReplayReader.close();
+    } else if (mReplayWriter.isRecording()) {
+        mReplayWriter.finish(mTick);
+        if (mTick > 0 && !mReplayWriter.saveToFile(getLastReplayPath())) {
+            qDebug() << "Failed to save replay to" << getLastReplayPath();
+        }
+    }
     
     // 停止游戏音乐
     AudioManager::getInstance()->stopCurrentMusic();
@@ -351,21 +334,55 @@ void SugarOilGameSceneNew::stopGame()
 void SugarOilGameSceneNew::resetGame()
 {
     mGameTime = 0;
+    mClock.reset();
+    mTick = 0;
+    mNextItemSpawnAt = ITEM_SPAWN_INTERVAL;
+    mNextCreatureSpawnAt = CREATURE_SPAWN_INTERVAL;
+    
+    // 新一局的随机数种子：回放时取录像中的种子，否则随机生成并开始录制
+    mSeed = mReplaying ? mReplayReader.getSeed() : QRandomGenerator::global()->generate();
+    mRandom.seed(mSeed);
+    mLastKeyMask = 0;
+    mWaveDirector.setAutoBackoff(!mReplaying);
+    mAutosaveEnabled = !mReplaying;
+    if (!mReplaying) {
+        mReplayWriter.begin(ReplayWriter::SugarOil, mSeed);
+    }
+    mQueryIndex.clear();
     mSpawnCounter = 0;
+    mNextEnemyId = 0;
+    mWaveDirector.reset();
+    mFrameTimer.invalidate();
     mItemSpawnCounter = 0;
     mCreatureSpawnCounter = 0;
     mPressedKeys.clear();
+    mInputQueue.clear();
+    mInputHead = 0;
     mMousePressed = false;
+    mNextAutosaveAt = AUTOSAVE_INTERVAL;
+    
+    clearEntities();
+    
+    // 重置玩家
+    if (mPlayer) {
+        mPlayer->resetPlayer();
+        mPlayer->setPos(SCENE_WIDTH / 2, SCENE_HEIGHT / 2);
+    }
     
+    emit timeChanged(GAME_DURATION - mGameTime);
+    emit scoreChanged(getScore());
+}
+
+void SugarOilGameSceneNew::clearEntities()
+{
     // 清理所有游戏对象
     for (EnemyBase* enemy : mEnemies) {
         if (enemy) {
-            enemy->stopAI();
-            removeItem(enemy);
-            enemy->deleteLater();
+            releaseEnemy(enemy);
         }
     }
     mEnemies.clear();
+    mSkillScheduler.clear();
     
     for (BulletBase* bullet : mPlayerBullets) {
         if (bullet) {
@@ -375,19 +392,13 @@ void SugarOilGameSceneNew::resetGame()
     }
     mPlayerBullets.clear();
     
-    for (BulletBase* bullet : mEnemyBullets) {
-        if (bullet) {
-            removeItem(bullet);
-            BulletBase::returnBulletToPool(bullet);
-        }
-    }
-    mEnemyBullets.clear();
+    mEnemyBulletStore.clear();
+    publishRenderState();
     
     // 清理所有道具
     for (GameItem* item : mItems) {
         if (item) {
-            removeItem(item);
-            item->deleteLater();
+            mItemManager->releaseItem(item);
         }
     }
     mItems.clear();
@@ -396,19 +407,10 @@ void SugarOilGameSceneNew::resetGame()
     for (GameCreature* creature : mCreatures) {
         if (creature) {
             removeItem(creature);
-            creature->deleteLater();
+            mCreatureManager->releaseCreature(creature);
         }
     }
     mCreatures.clear();
-    
-    // 重置玩家
-    if (mPlayer) {
-        mPlayer->resetPlayer();
-        mPlayer->setPos(SCENE_WIDTH / 2, SCENE_HEIGHT / 2);
-    }
-    
-    emit timeChanged(GAME_DURATION - mGameTime);
-    emit scoreChanged(getScore());
 }
 
 int SugarOilGameSceneNew::getScore() const
@@ -423,12 +425,19 @@ int SugarOilGameSceneNew::getPlayerLevel() const
 
 void SugarOilGameSceneNew::handleKeyPress(int key)
 {
-    mPressedKeys.insert(key);
+    // 回放期间按键状态来自录像；未开局时的按键会在开局时清空，不必入队
+    if (mReplaying || !mGameRunning) {
+        return;
+    }
+    queueInput(InputKind::KeyPress, key, QPointF());
 }
 
 void SugarOilGameSceneNew::handleKeyRelease(int key)
 {
-    mPressedKeys.remove(key);
+    if (mReplaying || !mGameRunning) {
+        return;
+    }
+    queueInput(InputKind::KeyRelease, key, QPointF());
 }
 
 void SugarOilGameSceneNew::handleMousePress(const QPointF &scenePos)
@@ -436,8 +445,57 @@ void SugarOilGameSceneNew::handleMousePress(const QPointF &scenePos)
     mLastMousePos = scenePos;
     mMousePressed = true;
     
+    if (mReplaying || !mGameRunning || mGamePaused) {
+        return;
+    }
+    
+    // 射击在下一个逻辑帧开始时执行，录像也记在那一帧
+    queueInput(InputKind::MousePress, 0, scenePos);
+}
+
+void SugarOilGameSceneNew::queueInput(InputKind kind, int key, const QPointF &scenePos)
+{
+    if (mInputQueue.size() >= INPUT_QUEUE_CAPACITY) {
+        qWarning() << "Input queue full, dropping input";
+        return;
+    }
+    mInputQueue.append({ mSimTimer.nsecsElapsed(), kind, key, scenePos });
+}
+
+void SugarOilGameSceneNew::applyQueuedInput()
+{
+    // 只取发生在本逻辑帧结束之前的输入；一个显示帧补多个逻辑帧时，输入落在各自所属的那一帧
+    while (mInputHead < mInputQueue.size() && mInputQueue[mInputHead].timestampNs <= mSimTimeNs) {
+        const InputEvent event = mInputQueue[mInputHead++];
+        switch (event.kind) {
+        case InputKind::KeyPress:
+            mPressedKeys.insert(event.key);
+            break;
+        case InputKind::KeyRelease:
+            mPressedKeys.remove(event.key);
+            break;
+        case InputKind::MousePress: {
+            // 坐标先量化再使用，录像里记录的就是实际参与计算的值
+            const qint32 x = ReplayWriter::quantizeCoord(event.scenePos.x());
+            const qint32 y = ReplayWriter::quantizeCoord(event.scenePos.y());
+            mReplayWriter.append({ mTick, ReplayEvent::MousePress, x, y });
+            shootAt(QPointF(ReplayWriter::dequantizeCoord(x), ReplayWriter::dequantizeCoord(y)));
+            break;
+        }
+        }
+    }
+    
+    // 已处理的输入从开头移除，剩下的前移；不重新分配，容量保持预留的大小
+    if (mInputHead > 0) {
+        mInputQueue.remove(0, mInputHead);
+        mInputHead = 0;
+    }
+}
+
+void SugarOilGameSceneNew::shootAt(const QPointF &scenePos)
+{
     // 玩家朝鼠标方向射击
-    if (mPlayer && mGameRunning && !mGamePaused) {
+    if (mPlayer) {
         QPointF playerPos = mPlayer->getCenterPos();
         QPointF direction = scenePos - playerPos;
         qreal length = qSqrt(direction.x() * direction.x() + direction.y() * direction.y());
@@ -459,14 +517,20 @@ void SugarOilGameSceneNew::handleMouseRelease(const QPointF &scenePos)
     mMousePressed = false;
 }
 
-void SugarOilGameSceneNew::onGameTimerTimeout()
+void SugarOilGameSceneNew::updateGameTime()
 {
+    // 每满1秒游戏时间更新一次倒计时
+    if (mClock.getNow() < (mGameTime + 1) * 1000LL) {
+        return;
+    }
+    
     mGameTime++;
     emit timeChanged(GAME_DURATION - mGameTime);
     
     // 检查游戏是否结束
     if (mGameTime >= GAME_DURATION) {
         stopGame();
+        discardAutosave();
         // 播放胜利音效
         AudioManager::getInstance()->playGameMusic(AudioManager::MusicType::Victory);
         emit gameWon(getScore(), getPlayerLevel());
@@ -474,6 +538,465 @@ void SugarOilGameSceneNew::onGameTimerTimeout()
     }
 }
 
+void SugarOilGameSceneNew::updateTimedSpawns()
+{
+    // 道具和生物按固定的游戏时间间隔生成
+    if (mClock.getNow() >= mNextItemSpawnAt) {
+        mNextItemSpawnAt += ITEM_SPAWN_INTERVAL;
+        updateItemSpawning();
+    }
+    if (mClock.getNow() >= mNextCreatureSpawnAt) {
+        mNextCreatureSpawnAt += CREATURE_SPAWN_INTERVAL;
+        updateCreatureSpawning();
+    }
+}
+
+namespace
+{
+    // 影响模拟的按键，按位记录在回放的KeyMask事件中
+    const int MOVEMENT_KEYS[] = {
+        Qt::Key_W, Qt::Key_S, Qt::Key_A, Qt::Key_D,
+        Qt::Key_Up, Qt::Key_Down, Qt::Key_Left, Qt::Key_Right
+    };
+    const int MOVEMENT_KEY_COUNT = sizeof(MOVEMENT_KEYS) / sizeof(MOVEMENT_KEYS[0]);
+}
+
+quint32 SugarOilGameSceneNew::getMovementKeyMask() const
+{
+    quint32 mask = 0;
+    for (int i = 0; i < MOVEMENT_KEY_COUNT; ++i) {
+        if (mPressedKeys.contains(MOVEMENT_KEYS[i])) {
+            mask |= 1u << i;
+        }
+    }
+    return mask;
+}
+
+void SugarOilGameSceneNew::recordReplayInput()
+{
+    // 按键状态只在变化的帧记录一次
+    const quint32 mask = getMovementKeyMask();
+    if (mask != mLastKeyMask) {
+        mReplayWriter.append({ mTick, ReplayEvent::KeyMask, static_cast<qint32>(mask), 0 });
+        mLastKeyMask = mask;
+    }
+}
+
+void SugarOilGameSceneNew::applyReplayInput()
+{
+    while (mReplayReader.hasEventAt(mTick)) {
+        const ReplayEvent event = mReplayReader.takeEvent();
+        switch (event.kind) {
+        case ReplayEvent::KeyMask:
+            // 逐个增删而不是clear()，QSet清空会释放存储，之后再插入又要重新分配
+            for (int i = 0; i < MOVEMENT_KEY_COUNT; ++i) {
+                if (event.a & (1 << i)) {
+                    mPressedKeys.insert(MOVEMENT_KEYS[i]);
+                } else {
+                    mPressedKeys.remove(MOVEMENT_KEYS[i]);
+                }
+            }
+            break;
+        case ReplayEvent::MousePress:
+            shootAt(QPointF(ReplayWriter::dequantizeCoord(event.a), ReplayWriter::dequantizeCoord(event.b)));
+            break;
+        case ReplayEvent::Backoff:
+            mWaveDirector.setBackoff(event.a / 100.0);
+            break;
+        default:
+            break;
+        }
+    }
+    
+    // 录像播完
+    if (mReplayReader.isFinished() && mTick >= mReplayReader.getEndTick()) {
+        qDebug() << "Replay finished at tick" << mTick;
+        stopGame();
+    }
+}
+
+QString SugarOilGameSceneNew::getLastReplayPath()
+{
+    return QStandardPaths::writableLocation(QStandardPaths::AppLocalDataLocation)
+           + "/replays/last_sugar_oil.cnrp";
+}
+
+bool SugarOilGameSceneNew::startReplay(const QByteArray &data)
+{
+    stopGame();
+    if (!mReplayReader.open(data) || mReplayReader.getMode() != ReplayWriter::SugarOil) {
+        mReplayReader.close();
+        qDebug() << "Invalid sugar oil replay";
+        return false;
+    }
+    
+    // startGame()中的resetGame()会取录像里的种子
+    mReplaying = true;
+    startGame();
+    return true;
+}
+
+bool SugarOilGameSceneNew::runReplayHeadless(const QByteArray &data)
+{
+    if (!startReplay(data)) {
+        return false;
+    }
+    
+    // 不等待定时器，连续推进到录像结束或游戏结束
+    mUpdateTimer->stop();
+    QElapsedTimer replayTimer;
+    replayTimer.start();
+    while (mGameRunning && !mGamePaused) {
+        updateGame();
+    }
+    const qint64 elapsedMs = replayTimer.elapsed();
+    qDebug() << "Headless replay - Ticks:" << mTick
+             << "Total ms:" << elapsedMs
+             << "ms/tick:" << (mTick > 0 ? static_cast<double>(elapsedMs) / mTick : 0.0)
+             << "Score:" << getScore()
+             << "Level:" << getPlayerLevel();
+    return true;
+}
+
+namespace
+{
+    const quint32 SCENE_TAG = 0x454e4353;         // "SCNE"
+    const quint32 ENEMY_TAG = 0x594d4e45;         // "ENMY"
+    const quint32 PLAYER_BULLET_TAG = 0x544c4250; // "PBLT"
+    const quint32 ITEM_TAG = 0x4d455449;          // "ITEM"
+    const quint32 CREATURE_TAG = 0x52545243;      // "CRTR"
+    
+    // 场景自身的计时和计数
+    struct SavedScene {
+        qint64 tick;
+        qint64 nextItemSpawnAt;
+        qint64 nextCreatureSpawnAt;
+        quint32 seed;
+        qint32 gameTime;
+        qint32 spawnCounter;
+        qint32 itemSpawnCounter;
+        qint32 creatureSpawnCounter;
+        quint32 nextEnemyId;
+    };
+    
+    // 快照中的一颗玩家子弹
+    struct SavedBullet {
+        qreal x;
+        qreal y;
+        qreal directionX;
+        qreal directionY;
+        qreal speed;
+        qint32 damage;
+        qint32 reserved;
+    };
+}
+
+quint32 SugarOilGameSceneNew::getTickSeed() const
+{
+    // splitmix64：相邻帧序号得到互不相关的种子
+    quint64 x = (static_cast<quint64>(mSeed) << 32) ^ static_cast<quint64>(mTick);
+    x += 0x9E3779B97F4A7C15ULL;
+    x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    x = (x ^ (x >> 27)) * 0x94D049BB133111EBULL;
+    x ^= x >> 31;
+    return static_cast<quint32>(x);
+}
+
+QString SugarOilGameSceneNew::getAutosavePath()
+{
+    return QStandardPaths::writableLocation(QStandardPaths::AppLocalDataLocation)
+           + "/saves/sugar_oil.cnss";
+}
+
+bool SugarOilGameSceneNew::hasAutosave()
+{
+    return QFile::exists(getAutosavePath());
+}
+
+QByteArray SugarOilGameSceneNew::saveSnapshot()
+{
+    QElapsedTimer snapshotTimer;
+    snapshotTimer.start();
+    
+    // 快照总在两帧之间生成，此时销毁队列已在帧末清空，列表里都是存活的实体
+    const int estimate = 4096
+        + mEnemies.size() * static_cast<int>(sizeof(EnemyBase::SavedState))
+        + mPlayerBullets.size() * static_cast<int>(sizeof(SavedBullet))
+        + mItems.size() * static_cast<int>(sizeof(GameItem::SavedState))
+        + mCreatures.size() * static_cast<int>(sizeof(GameCreature::SavedState))
+        + mEnemyBulletStore.size() * 32;
+    SnapshotWriter &writer = mSnapshotWriter;
+    writer.begin(SnapshotWriter::SugarOil, estimate);
+    
+    writer.beginSection(SCENE_TAG);
+    writer.write(SavedScene{ mTick, mNextItemSpawnAt, mNextCreatureSpawnAt, mSeed, mGameTime,
+                             mSpawnCounter, mItemSpawnCounter, mCreatureSpawnCounter, mNextEnemyId });
+    mClock.saveState(writer);
+    mWaveDirector.saveState(writer);
+    mSkillScheduler.saveState(writer);
+    mPlayer->saveState(writer);
+    
+    // 各实体的记录直接写进复用的缓冲区，自动存档发生在帧循环里，不建临时数组
+    writer.beginSection(ENEMY_TAG);
+    writer.writeArrayOf<EnemyBase::SavedState>(mEnemies, [](const EnemyBase* enemy) {
+        return enemy->saveState();
+    });
+    
+    writer.beginSection(PLAYER_BULLET_TAG);
+    writer.writeArrayOf<SavedBullet>(mPlayerBullets, [](const BulletBase* bullet) {
+        const QPointF direction = bullet->getMoveDirection();
+        return SavedBullet{ bullet->x(), bullet->y(), direction.x(), direction.y(),
+                            bullet->getSpeed(), bullet->getDamage(), 0 };
+    });
+    
+    mEnemyBulletStore.saveState(writer);
+    
+    writer.beginSection(ITEM_TAG);
+    writer.writeArrayOf<GameItem::SavedState>(mItems, [](const GameItem* item) {
+        return item->saveState();
+    });
+    
+    writer.beginSection(CREATURE_TAG);
+    writer.writeArrayOf<GameCreature::SavedState>(mCreatures, [](const GameCreature* creature) {
+        return creature->saveState();
+    });
+    
+    mSnapshotNsecs = snapshotTimer.nsecsElapsed();
+    mSnapshotBytes = writer.data().size();
+    return writer.data();
+}
+
+bool SugarOilGameSceneNew::restoreSnapshot(const QByteArray &data)
+{
+    QElapsedTimer restoreTimer;
+    restoreTimer.start();
+    
+    SnapshotReader reader;
+    if (!reader.open(data, SnapshotWriter::SugarOil)) {
+        return false;
+    }
+    
+    // 各段依次读进临时变量，任何一段出错后面的读取都会失败；
+    // 整份快照校验通过之前不改动当前对局，读档失败时场景保持原样
+    SavedScene scene = {};
+    GameClock clock = mClock;
+    WaveDirector waveDirector = mWaveDirector; // 复制一份以沿用已读入的波次表和随机数生成器
+    SkillScheduler skillScheduler;
+    SugarOilPlayer::SavedState playerState = {};
+    EffectScheduler playerEffects;
+    BulletStore enemyBullets(MAX_ENEMY_BULLETS);
+    QVector<EnemyBase::SavedState> enemies;
+    QVector<SavedBullet> bullets;
+    QVector<GameItem::SavedState> items;
+    QVector<GameCreature::SavedState> creatures;
+    reader.expectSection(SCENE_TAG);
+    reader.read(scene);
+    const bool clockOk = clock.restoreState(reader);
+    const bool wavesOk = waveDirector.restoreState(reader);
+    const bool skillsOk = skillScheduler.restoreState(reader);
+    const bool playerOk = SugarOilPlayer::readState(reader, playerState, playerEffects);
+    reader.expectSection(ENEMY_TAG);
+    reader.readArray(enemies, MAX_SNAPSHOT_ENTITIES);
+    reader.expectSection(PLAYER_BULLET_TAG);
+    reader.readArray(bullets, MAX_SNAPSHOT_ENTITIES);
+    const bool bulletsOk = enemyBullets.restoreState(reader);
+    reader.expectSection(ITEM_TAG);
+    reader.readArray(items, MAX_SNAPSHOT_ENTITIES);
+    reader.expectSection(CREATURE_TAG);
+    reader.readArray(creatures, MAX_SNAPSHOT_ENTITIES);
+    
+    if (!reader.isOk() || !reader.atEnd() || !clockOk || !wavesOk || !skillsOk || !playerOk || !bulletsOk) {
+        return false;
+    }
+    
+    // 校验通过，清空当前对局后按快照重建
+    clearEntities();
+    mQueryIndex.clear();
+    mClock = clock;
+    mWaveDirector = waveDirector;
+    mSkillScheduler = skillScheduler;
+    mPlayer->restoreState(playerState, playerEffects);
+    mEnemyBulletStore = enemyBullets;
+    
+    mTick = scene.tick;
+    mSeed = scene.seed;
+    mGameTime = scene.gameTime;
+    mSpawnCounter = scene.spawnCounter;
+    mNextItemSpawnAt = scene.nextItemSpawnAt;
+    mNextCreatureSpawnAt = scene.nextCreatureSpawnAt;
+    mItemSpawnCounter = scene.itemSpawnCounter;
+    mCreatureSpawnCounter = scene.creatureSpawnCounter;
+    mRandom.seed(getTickSeed());
+    
+    // 实体按原有的创建路径重建（连接信号、对象池），再覆盖为快照中的状态
+    for (const EnemyBase::SavedState &state : enemies) {
+        const int type = qBound(0, state.type, SUGAR_OIL_ENEMY_COUNT - 1);
+        EnemyBase* enemy = spawnEnemy(static_cast<EnemyBase::EnemyType>(type), QPointF(state.x, state.y));
+        enemy->restoreState(state);
+    }
+    // 重建时spawnEnemy会分配新编号，这里换回快照中的计数
+    mNextEnemyId = scene.nextEnemyId;
+    for (const SavedBullet &state : bullets) {
+        BulletBase* bullet = createPlayerBullet(QPointF(state.x, state.y),
+                                                QPointF(state.directionX, state.directionY), state.damage);
+        bullet->setSpeed(state.speed);
+    }
+    publishRenderState();
+    for (const GameItem::SavedState &state : items) {
+        GameItem* item = mItemManager->createItem(static_cast<ItemType>(qBound(0, state.type, ITEM_COUNT - 1)),
+                                                  QPointF(state.x, state.y));
+        item->restoreState(state);
+        if (item->scene() != this) {
+            addItem(item);
+        }
+        mItems.append(item);
+    }
+    for (const GameCreature::SavedState &state : creatures) {
+        const int type = qBound(0, state.type, CREATURE_COUNT - 1);
+        GameCreature* creature = mCreatureManager->createCreature(static_cast<CreatureType>(type),
+                                                                  QPointF(state.x, state.y));
+        creature->restoreState(state);
+        addItem(creature);
+        mCreatures.append(creature);
+    }
+    
+    // 输入状态不进快照，读档后从松开所有按键开始；读档后的对局不录像
+    mPressedKeys.clear();
+    mInputQueue.clear();
+    mInputHead = 0;
+    mMousePressed = false;
+    mLastKeyMask = 0;
+    mFrameTimer.invalidate();
+    mWaveDirector.setAutoBackoff(true);
+    mAutosaveEnabled = true;
+    mNextAutosaveAt = mClock.getNow() + AUTOSAVE_INTERVAL;
+    
+    qDebug() << "Snapshot restored - Bytes:" << data.size()
+             << "Enemies:" << mEnemies.size()
+             << "Enemy Bullets:" << mEnemyBulletStore.size()
+             << "Load us:" << restoreTimer.nsecsElapsed() / 1000.0;
+    return true;
+}
+
+bool SugarOilGameSceneNew::continueFromSnapshot(const QByteArray &data)
+{
+    stopGame();
+    mReplaying = false;
+    if (!restoreSnapshot(data)) {
+        qDebug() << "Invalid sugar oil snapshot";
+        return false;
+    }
+    
+    mGameRunning = true;
+    mGamePaused = false;
+    startFrameLoop();
+    
+    emit gameStarted();
+    emit gameStateChanged(SUGAR_OIL_RUNNING);
+    emit timeChanged(GAME_DURATION - mGameTime);
+    emit scoreChanged(getScore());
+    qDebug() << "Game continued from snapshot at tick" << mTick;
+    return true;
+}
+
+bool SugarOilGameSceneNew::continueFromAutosave()
+{
+    QFile file(mAutosavePath);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return false;
+    }
+    return continueFromSnapshot(file.readAll());
+}
+
+bool SugarOilGameSceneNew::saveAutosaveNow()
+{
+    if (!mGameRunning || mReplaying) {
+        return false;
+    }
+    // 等后台的写盘结束，避免旧快照覆盖这一份
+    mAutosaver.waitForPending();
+    return SnapshotWriter::saveToFile(mAutosavePath, saveSnapshot());
+}
+
+void SugarOilGameSceneNew::discardAutosave()
+{
+    mAutosaver.waitForPending();
+    QFile::remove(mAutosavePath);
+}
+
+int SugarOilGameSceneNew::getDisplayInterval() const
+{
+    // 屏幕刷新率未知时按逻辑帧率显示
+    const QScreen* screen = QGuiApplication::primaryScreen();
+    const qreal refreshRate = screen ? screen->refreshRate() : 0.0;
+    if (refreshRate <= 0.0) {
+        return UPDATE_INTERVAL;
+    }
+    return qBound(1, qRound(1000.0 / refreshRate), UPDATE_INTERVAL);
+}
+
+void SugarOilGameSceneNew::startFrameLoop()
+{
+    mSimTimeNs = mSimTimer.nsecsElapsed();
+    mFrameTimer.invalidate();
+    mUpdateTimer->start();
+}
+
+void SugarOilGameSceneNew::onDisplayFrame()
+{
+    // 实测帧间隔交给波次导演做帧预算判断
+    if (mFrameTimer.isValid()) {
+        mWaveDirector.reportFrameTime(mFrameTimer.nsecsElapsed() / 1000000.0);
+    }
+    mFrameTimer.start();
+    ++mDisplayFrameCount;
+    
+    // 按实际经过的时间补齐逻辑帧：绘制慢时一次推进多帧，游戏速度不受显示帧率影响
+    const qint64 nowNs = mSimTimer.nsecsElapsed();
+    int ticks = 0;
+    while (mGameRunning && !mGamePaused && mSimTimeNs + TICK_NSECS <= nowNs) {
+        if (ticks == MAX_TICKS_PER_FRAME) {
+            // 逻辑帧本身跟不上时丢弃积压，避免越追越慢
+            mSimTimeNs = nowNs - TICK_NSECS;
+            break;
+        }
+        mSimTimeNs += TICK_NSECS;
+        updateGame();
+        ++ticks;
+    }
+    
+    if (ticks > 0) {
+        publishRenderState();
+    }
+    
+    // 画面停在上一个和当前逻辑帧之间，按剩余时间插值
+    if (mEnemyBulletItem) {
+        mEnemyBulletItem->setInterpolation(static_cast<qreal>(nowNs - mSimTimeNs) / TICK_NSECS);
+        mEnemyBulletItem->update();
+    }
+}
+
+void SugarOilGameSceneNew::publishRenderState()
+{
+    if (mEnemyBulletItem) {
+        mEnemyBulletItem->publish(mEnemyBulletStore);
+        mEnemyBulletItem->update();
+    }
+}
+
+qreal SugarOilGameSceneNew::takeAveragePaintUs()
+{
+    for (QGraphicsView* view : views()) {
+        if (ProfiledGraphicsView* profiled = dynamic_cast<ProfiledGraphicsView*>(view)) {
+            int paintCount = 0;
+            qreal averageUs = 0.0;
+            profiled->takePaintStats(paintCount, averageUs);
+            return averageUs;
+        }
+    }
+    return 0.0;
+}
+
 void SugarOilGameSceneNew::updateGame()
 {
     if (!mGameRunning || mGamePaused) {
@@ -483,26 +1006,117 @@ void SugarOilGameSceneNew::updateGame()
     // 性能监控
     mFrameCount++;
     if (mFrameCount % 100 == 0) {
-        qint64 elapsed = mPerformanceTimer.elapsed();
-        qreal fps = (mFrameCount * 1000.0) / elapsed;
-        qDebug() << "Performance Stats - FPS:" << fps 
-                 << "Enemies:" << mEnemies.size()
-                 << "Player Bullets:" << mPlayerBullets.size()
-                 << "Enemy Bullets:" << mEnemyBullets.size()
-                 << "Items:" << mItems.size()
-                 << "Creatures:" << mCreatures.size();
+        logPerformanceStats();
+    }
+    
+    // 统计帧循环本身的堆分配（不含上面的日志输出），一直统计到自动存档结束
+    const quint64 allocationsBefore = AllocTracker::allocationCount();
+    
+    // 每帧的随机数流由种子和帧序号重新派生，存档只需记录这两个数
+    mRandom.seed(getTickSeed());
+    
+    // 本帧的输入：回放时从录像读取，否则把变化录进录像
+    if (mReplaying) {
+        applyReplayInput();
+        if (!mGameRunning) {
+            return;
+        }
+    } else {
+        applyQueuedInput();
+        recordReplayInput();
+    }
+    
+    // 推进游戏时钟，限时效果和时间缩放随之到期
+    mClock.advance(UPDATE_INTERVAL);
+    if (mPlayer) {
+        mPlayer->updateEffects(mClock.getNow());
     }
     
     updatePlayerMovement();
+    updateEnemySteering();
+    updateEnemyAI();
+    updateBullets();
     updateItems();
     updateCreatures();
+    updateAnimations();
+    updateEnemySpawning();
+    updateTimedSpawns();
+    
+    // 所有移动结束后重建空间索引，之后的范围效果和碰撞都基于本帧位置
+    rebuildQueryIndex();
+    updateItemMagnet();
+    updateCreatureAuras();
+    updateCreatureTurrets();
     updateCollisions();
     
-    // 优化清理频率，每5帧清理一次以提升性能
-    static int cleanupCounter = 0;
-    if (++cleanupCounter % 5 == 0) {
-        cleanupObjects();
+    // 优化清理频率，每5帧清理一次以提升性能
+    if ((mTick + 1) % 5 == 0) {
+        cleanupObjects();
+    }
+    
+    // 帧末同步点：统一销毁本帧排队的实体
+    flushDeathQueues();
+    
+    // 回收本帧所有临时缓冲区
+    mFrameArena.reset();
+    
+    ++mTick;
+    
+    // 最后推进倒计时，时间到时会结束游戏
+    updateGameTime();
+    
+    // 定期自动存档：快照在这里生成，写盘交给后台线程
+    if (mGameRunning && mAutosaveEnabled && mClock.getNow() >= mNextAutosaveAt) {
+        mNextAutosaveAt = mClock.getNow() + AUTOSAVE_INTERVAL;
+        mAutosaver.saveAsync(mAutosavePath, saveSnapshot());
     }
+    
+    mLastTickAllocations = AllocTracker::allocationCount() - allocationsBefore;
+    mFrameAllocations += mLastTickAllocations;
+}
+
+void SugarOilGameSceneNew::logPerformanceStats()
+{
+    qint64 elapsed = mPerformanceTimer.elapsed();
+    qreal fps = (mFrameCount * 1000.0) / elapsed;
+    qDebug() << "Performance Stats - FPS:" << fps 
+             << "Display FPS:" << (mDisplayFrameCount * 1000.0) / elapsed
+             << "Paint us/frame:" << takeAveragePaintUs()
+             << "Asset misses:" << AssetCache::getInstance()->getMissCount()
+             << "Enemies:" << mEnemies.size()
+             << "Player Bullets:" << mPlayerBullets.size()
+             << "Enemy Bullets:" << mEnemyBulletStore.size()
+             << "Items:" << mItems.size()
+             << "Creatures:" << mCreatures.size()
+             << "Steering us/frame:" << mSteeringNsecs / 100 / 1000.0
+             << "Removed:" << mRemovalCount
+             << "Removal us/entity:" << (mRemovalCount > 0 ? mRemovalNsecs / 1000.0 / mRemovalCount : 0.0)
+             << "Frame arena KB:" << mFrameArena.getCapacity() / 1024
+             << "Queries:" << mQueryCount
+             << "Query us/call:" << (mQueryCount > 0 ? mQueryNsecs / 1000.0 / mQueryCount : 0.0)
+             << "Turret us/frame:" << mTurretNsecs / 100 / 1000.0
+             << "Enemy bullet us/frame:" << mEnemyBulletNsecs / 100 / 1000.0
+             << "Animation us/frame:" << mAnimationNsecs / 100 / 1000.0
+             << "Clips/frames:" << AnimationClips::getInstance()->getClipCount()
+             << AnimationClips::getInstance()->getFrameTotal()
+             << "AI LOD full/reduced/coarse:" << mAILevelCounts[0] << mAILevelCounts[1] << mAILevelCounts[2]
+             << "Worker threads:" << mJobs.getThreadCount()
+             << "Wave:" << mWaveDirector.getCurrentWave() + 1
+             << "Avg frame ms:" << mWaveDirector.getAverageFrameMs()
+             << "Spawn backoff:" << mWaveDirector.getBackoff()
+             << "Snapshot us/KB:" << mSnapshotNsecs / 1000.0 << mSnapshotBytes / 1024.0;
+    if (AllocTracker::isEnabled()) {
+        qDebug() << "Heap allocations in last 100 frames:" << mFrameAllocations;
+    }
+    mSteeringNsecs = 0;
+    mRemovalNsecs = 0;
+    mRemovalCount = 0;
+    mFrameAllocations = 0;
+    mQueryNsecs = 0;
+    mQueryCount = 0;
+    mTurretNsecs = 0;
+    mEnemyBulletNsecs = 0;
+    mAnimationNsecs = 0;
 }
 
 void SugarOilGameSceneNew::updatePlayerMovement()
@@ -512,7 +1126,7 @@ void SugarOilGameSceneNew::updatePlayerMovement()
     }
     
     QPointF movement(0, 0);
-    const qreal speed = mPlayer->getSpeed();
+    const qreal speed = mPlayer->getSpeed() * mClock.getScale(GameClock::Player);
     
     // 处理键盘输入
     if (mPressedKeys.contains(Qt::Key_W) || mPressedKeys.contains(Qt::Key_Up)) {
@@ -550,84 +1164,99 @@ void SugarOilGameSceneNew::updatePlayerMovement()
         
         mPlayer->setPos(newPos);
     }
+    
+    // 行走片段和朝向跟随输入，帧由updateAnimations()推进
+    if (movement.x() != 0 || movement.y() != 0) {
+        mPlayer->startMoving();
+    } else {
+        mPlayer->stopMoving();
+    }
+    if (movement.x() > 0 && !mPlayer->getFaceDirection()) {
+        mPlayer->setFaceDirection(true);
+    } else if (movement.x() < 0 && mPlayer->getFaceDirection()) {
+        mPlayer->setFaceDirection(false);
+    }
 }
 
-void SugarOilGameSceneNew::spawnEnemies()
+void SugarOilGameSceneNew::updateEnemySpawning()
 {
-    if (!mGameRunning || mGamePaused) {
+    // 到点时整组敌人在同一帧生成；节奏、构成和队形来自波次表
+    mWaveSpawns.clear();
+    const qreal backoffBefore = mWaveDirector.getBackoff();
+    const int spawned = mWaveDirector.advance(mClock.getNow(), mEnemies.size(), sceneRect(), mWaveSpawns);
+    if (!mReplaying && mWaveDirector.getBackoff() != backoffBefore) {
+        // 退避取决于实测帧时间，录下来回放时直接使用
+        mReplayWriter.append({ mTick, ReplayEvent::Backoff, qRound(mWaveDirector.getBackoff() * 100.0), 0 });
+    }
+    if (spawned == 0) {
         return;
     }
     
-    updateEnemySpawning();
-}
-
-void SugarOilGameSceneNew::updateEnemySpawning()
-{
     mSpawnCounter++;
-    
-    // 根据游戏时间调整生成频率（降低刷新速度）
-    int spawnInterval = 3000; // 基础间隔3秒
-    if (mGameTime > 60) {
-        spawnInterval = 2500; // 1分钟后加快到2.5秒
-    }
-    if (mGameTime > 120) {
-        spawnInterval = 2000; // 2分钟后加快到2秒
-    }
-    if (mGameTime > 180) {
-        spawnInterval = 1500; // 3分钟后加快到1.5秒
+    for (const WaveSpawn &spawn : mWaveSpawns) {
+        spawnEnemy(static_cast<EnemyBase::EnemyType>(spawn.enemyType), spawn.position);
     }
-    if (mGameTime > 240) {
-        spawnInterval = 1200; // 4分钟后加快到1.2秒
-    }
-    
-    mSpawnTimer->setInterval(spawnInterval);
-    
-    // 生成敌人
-    QPointF spawnPos = getRandomSpawnPosition();
-    
-    // 随机选择糖油混合物敌人类型
-    EnemyBase::EnemyType enemyType = static_cast<EnemyBase::EnemyType>(QRandomGenerator::global()->bounded(5));
-    
-    spawnEnemy(enemyType, spawnPos);
 }
 
 QPointF SugarOilGameSceneNew::getRandomSpawnPosition()
 {
     // 在场景边缘随机生成位置
-    int edge = QRandomGenerator::global()->bounded(4); // 0=上, 1=右, 2=下, 3=左
+    int edge = mRandom.bounded(4); // 0=上, 1=右, 2=下, 3=左
     QPointF pos;
     
     switch (edge) {
     case 0: // 上边缘
-        pos = QPointF(QRandomGenerator::global()->bounded(SCENE_WIDTH), -50);
+        pos = QPointF(mRandom.bounded(SCENE_WIDTH), -50);
         break;
     case 1: // 右边缘
-        pos = QPointF(SCENE_WIDTH + 50, QRandomGenerator::global()->bounded(SCENE_HEIGHT));
+        pos = QPointF(SCENE_WIDTH + 50, mRandom.bounded(SCENE_HEIGHT));
         break;
     case 2: // 下边缘
-        pos = QPointF(QRandomGenerator::global()->bounded(SCENE_WIDTH), SCENE_HEIGHT + 50);
+        pos = QPointF(mRandom.bounded(SCENE_WIDTH), SCENE_HEIGHT + 50);
         break;
     case 3: // 左边缘
-        pos = QPointF(-50, QRandomGenerator::global()->bounded(SCENE_HEIGHT));
+        pos = QPointF(-50, mRandom.bounded(SCENE_HEIGHT));
         break;
     }
     
     return pos;
 }
 
-void SugarOilGameSceneNew::spawnEnemy(EnemyBase::EnemyType type, const QPointF &position)
+EnemyBase* SugarOilGameSceneNew::spawnEnemy(EnemyBase::EnemyType type, const QPointF &position)
 {
-    EnemyBase* enemy = new EnemyBase(mPlayer, 100, 10, 2.0, 50, type);
+    // 优先复用池中的敌人，池用完时才新建
+    EnemyBase* enemy = mEnemyPool.isEmpty() ? createPooledEnemy() : mEnemyPool.takeLast();
+    enemy->resetEnemy(100, 10, 2.0, 50, type);
+    enemy->setSpawnId(mNextEnemyId++);
     enemy->setPos(position);
-    addItem(enemy);
     mEnemies.append(enemy);
     
-    // 连接敌人信号
-    connect(enemy, &EnemyBase::enemyAttack, this, &SugarOilGameSceneNew::onEnemyAttack);
-    connect(enemy, &EnemyBase::enemyDied, this, &SugarOilGameSceneNew::onEnemyDied);
-    
     // 启动敌人AI
     enemy->startAI();
+    return enemy;
+}
+
+EnemyBase* SugarOilGameSceneNew::createPooledEnemy()
+{
+    EnemyBase* enemy = new EnemyBase(mPlayer, 100, 10, 2.0, 50, EnemyBase::EnemyType::FriedChicken);
+    enemy->setVisible(false);
+    addItem(enemy);
+    
+    // 连接敌人信号，复用时不再重复连接
+    connect(enemy, &EnemyBase::enemyFirePattern, this, &SugarOilGameSceneNew::onEnemyFirePattern);
+    connect(enemy, &EnemyBase::enemyDied, this, &SugarOilGameSceneNew::onEnemyDied);
+    
+    // 技能脚本交给场景的调度器
+    enemy->setSkillScheduler(&mSkillScheduler);
+    return enemy;
+}
+
+void SugarOilGameSceneNew::releaseEnemy(EnemyBase* enemy)
+{
+    // 先停止AI，取消正在执行的技能脚本
+    enemy->stopAI();
+    enemy->setVisible(false);
+    mEnemyPool.append(enemy);
 }
 
 void SugarOilGameSceneNew::updateCollisions()
@@ -636,7 +1265,6 @@ void SugarOilGameSceneNew::updateCollisions()
     checkPlayerBulletEnemyCollisions();
     checkEnemyBulletPlayerCollisions();
     checkPlayerItemCollisions();
-    checkPlayerCreatureCollisions();
 }
 
 void SugarOilGameSceneNew::checkPlayerEnemyCollisions()
@@ -648,7 +1276,7 @@ void SugarOilGameSceneNew::checkPlayerEnemyCollisions()
     QRectF playerRect = mPlayer->sceneBoundingRect();
     
     for (EnemyBase* enemy : mEnemies) {
-        if (!enemy) {
+        if (!enemy || enemy->isPendingRemoval()) {
             continue;
         }
         
@@ -661,101 +1289,72 @@ void SugarOilGameSceneNew::checkPlayerEnemyCollisions()
 
 void SugarOilGameSceneNew::checkPlayerBulletEnemyCollisions()
 {
-    // 使用临时列表存储需要移除的对象，避免在循环中修改列表导致索引问题
-    QList<BulletBase*> bulletsToRemove;
-    QList<EnemyBase*> enemiesToRemove;
-    
-    for (int i = mPlayerBullets.size() - 1; i >= 0; --i) {
-        BulletBase* bullet = mPlayerBullets[i];
-        if (!bullet) {
-            mPlayerBullets.removeAt(i);
-            continue;
-        }
-        
-        // 跳过已销毁的子弹
-        if (bullet->isDestroyed()) {
+    // 命中的子弹和死亡的敌人只入队，帧末统一移除，遍历期间列表保持不变
+    for (BulletBase* bullet : mPlayerBullets) {
+        // 跳过无效或已销毁的子弹
+        if (!bullet || bullet->isDestroyed()) {
             continue;
         }
         
-        bool bulletHit = false;
+        // 扫掠线段：上次检测到现在子弹走过的全部路径
+        const QPointF sweepStart = bullet->getSweepStart();
+        const QPointF sweepEnd = bullet->getCenterPos();
+        bullet->resetSweep();
         
-        for (int j = 0; j < mEnemies.size(); ++j) {
-            EnemyBase* enemy = mEnemies[j];
-            if (!enemy || enemy->getHP() <= 0) {
-                continue; // 跳过无效或已死亡的敌人
+        // 找出路径上最早碰到的敌人：能被命中的敌人中心一定落在线段包围盒外扩碰撞半径的范围内，
+        // 只从本帧重建的敌人索引里取这些候选
+        const QRectF sweepBounds = QRectF(sweepStart, sweepEnd).normalized()
+                                       .adjusted(-SUGAR_OIL_COLLISION_DISTANCE, -SUGAR_OIL_COLLISION_DISTANCE,
+                                                 SUGAR_OIL_COLLISION_DISTANCE, SUGAR_OIL_COLLISION_DISTANCE);
+        EnemyBase* hitEnemy = nullptr;
+        qreal earliestT = 2.0;
+        mQueryIndex.queryRect(sweepBounds, QUERY_ENEMIES, [&](GameObjectBase* object, EntityQueryFaction) {
+            EnemyBase* enemy = static_cast<EnemyBase*>(object);
+            if (enemy->getHP() <= 0) {
+                return true; // 跳过本帧已被击杀的敌人
             }
             
-            // 使用距离检测提高碰撞精度
-            QPointF bulletPos = bullet->pos();
-            QPointF enemyPos = enemy->pos();
-            qreal distance = QLineF(bulletPos, enemyPos).length();
-            
-            if (distance < SUGAR_OIL_COLLISION_DISTANCE) {
-                // 添加调试信息
-                qDebug() << "Bullet collision detected! Distance:" << distance << "Bullet damage:" << bullet->getDamage();
-                
-                // 立即标记子弹为已销毁，避免重复处理
-                bullet->markForDestruction();
-                
-                // 敌人受伤
-                enemy->takeDamage(bullet->getDamage());
-                
-                // 如果敌人死亡，标记为需要移除
-                if (enemy->getHP() <= 0) {
-                    qDebug() << "Enemy killed by bullet";
-                    enemy->stopAI();
-                    enemiesToRemove.append(enemy);
-                }
-                
-                // 标记子弹为需要移除
-                qDebug() << "Marking bullet for removal";
-                bulletsToRemove.append(bullet);
-                bulletHit = true;
-                break;
+            qreal t;
+            // SUGAR_OIL_COLLISION_DISTANCE作为子弹与敌人的半径之和
+            if (SweptCollision::sweepCircleCircle(sweepStart, sweepEnd, 0.0,
+                                                  enemy->getCenterPos(), SUGAR_OIL_COLLISION_DISTANCE, &t)
+                && t < earliestT) {
+                earliestT = t;
+                hitEnemy = enemy;
             }
-        }
+            return true;
+        });
         
-        if (bulletHit) {
-            break;
+        if (!hitEnemy) {
+            continue;
         }
-    }
-    
-    // 移除被击中的子弹
-    qDebug() << "Removing" << bulletsToRemove.size() << "bullets from collision";
-    for (BulletBase* bullet : bulletsToRemove) {
-        qDebug() << "Removing bullet from scene and returning to pool";
-        mPlayerBullets.removeOne(bullet);
-        removeItem(bullet);
-        BulletBase::returnBulletToPool(bullet);
-    }
-    
-    // 移除死亡的敌人
-    for (EnemyBase* enemy : enemiesToRemove) {
-        mEnemies.removeOne(enemy);
-        removeItem(enemy);
-        enemy->deleteLater();
+        
+        // 立即标记子弹为已销毁，避免重复处理
+        bullet->markForDestruction();
+        mPlayerBullets.queueRemoval(bullet);
+        
+        // 敌人受伤，死亡时由onEnemyDied入队
+        hitEnemy->takeDamage(bullet->getDamage());
     }
 }
 
 void SugarOilGameSceneNew::checkEnemyBulletPlayerCollisions()
 {
+    // 无敌时跳过；存储每次积分都会更新上一位置，无敌结束后不会用过长的旧路径误判
     if (!mPlayer || mPlayer->isInvincible()) {
         return;
     }
     
-    QRectF playerRect = mPlayer->sceneBoundingRect();
-    
-    for (int i = mEnemyBullets.size() - 1; i >= 0; --i) {
-        BulletBase* bullet = mEnemyBullets[i];
-        if (bullet->sceneBoundingRect().intersects(playerRect)) {
-            // 玩家受伤
-            mPlayer->takeDamage(bullet->getDamage());
-            
-            // 移除子弹
-            removeItem(bullet);
-            mEnemyBullets.removeAt(i);
-            BulletBase::returnBulletToPool(bullet);
-        }
+    // 把玩家矩形按子弹半尺寸外扩，转化为线段与矩形求交；命中的子弹直接从存储中移除
+    const QSizeF bulletSize = mEnemyBulletItem->getBulletSize();
+    const QRectF hitRect = mPlayer->sceneBoundingRect().adjusted(-bulletSize.width() / 2, -bulletSize.height() / 2,
+                                                                 bulletSize.width() / 2, bulletSize.height() / 2);
+    const int hits = mEnemyBulletStore.collideRect(hitRect, [this](int damage) {
+        // 玩家受伤
+        mPlayer->takeDamage(damage);
+    });
+    if (hits > 0) {
+        mEnemyBulletItem->update();
     }
 }
 
@@ -764,34 +1363,47 @@ void SugarOilGameSceneNew::cleanupObjects()
     removeDeadEnemies();
     removeOutOfBoundsBullets();
     removeCollectedItems();
-    removeActivatedCreatures();
 }
 
 void SugarOilGameSceneNew::removeDeadEnemies()
 {
-    for (int i = mEnemies.size() - 1; i >= 0; --i) {
-        EnemyBase* enemy = mEnemies[i];
-        if (!enemy) {
-            mEnemies.removeAt(i);
-            continue;
-        }
-        
-        if (enemy->getHP() <= 0) {
-            // 先停止AI避免在删除过程中继续执行
-            enemy->stopAI();
-            
-            // 从场景中移除
-            removeItem(enemy);
-            
-            // 从列表中移除
-            mEnemies.removeAt(i);
-            
-            // 延迟删除，避免在信号处理过程中删除对象
-            enemy->deleteLater();
+    for (EnemyBase* enemy : mEnemies) {
+        if (enemy && enemy->getHP() <= 0) {
+            mEnemies.queueRemoval(enemy);
         }
     }
 }
 
+void SugarOilGameSceneNew::flushDeathQueues()
+{
+    QElapsedTimer removalTimer;
+    removalTimer.start();
+    
+    mRemovalCount += mEnemies.pendingRemovalCount() + mPlayerBullets.pendingRemovalCount()
+                   + mItems.pendingRemovalCount() + mCreatures.pendingRemovalCount();
+    
+    // 敌人和道具归还对象池，只隐藏不移出场景
+    mEnemies.flushRemovals([this](EnemyBase* enemy) {
+        releaseEnemy(enemy);
+    });
+    
+    // 子弹归还对象池
+    mPlayerBullets.flushRemovals([this](BulletBase* bullet) {
+        removeItem(bullet);
+        BulletBase::returnBulletToPool(bullet);
+    });
+    
+    mItems.flushRemovals([this](GameItem* item) {
+        mItemManager->releaseItem(item);
+    });
+    mCreatures.flushRemovals([this](GameCreature* creature) {
+        removeItem(creature);
+        mCreatureManager->releaseCreature(creature);
+    });
+    
+    mRemovalNsecs += removalTimer.nsecsElapsed();
+}
+
 // 道具系统方法
 void SugarOilGameSceneNew::updateItemSpawning()
 {
@@ -807,34 +1419,59 @@ void SugarOilGameSceneNew::spawnRandomItem()
     QPointF spawnPos = getRandomSpawnPosition();
     GameItem* item = mItemManager->spawnRandomItem(spawnPos);
     if (item) {
-        addItem(item);
+        // 池中的道具已在场景里，只有池用完时新建的才需要加入
+        if (item->scene() != this) {
+            addItem(item);
+        }
         mItems.append(item);
     }
 }
 
 void SugarOilGameSceneNew::updateItems()
 {
-    for (int i = mItems.size() - 1; i >= 0; --i) {
-        GameItem* item = mItems[i];
-        if (!item) {
-            mItems.removeAt(i);
-            continue;
+    const qreal dt = mClock.getDelta(GameClock::Items);
+    for (GameItem* item : mItems) {
+        if (item) {
+            item->updateAnimation(dt);
         }
-        
-        item->updateAnimation();
     }
 }
 
+void SugarOilGameSceneNew::updateAnimations()
+{
+    // 所有实体的帧动画在这里一次推进：帧表按原型共享，实体只有片段编号、帧序号和相位，
+    // 各阵营使用自己缩放后的时间，冻结的敌人随之停在当前帧；帧没变的实体不换图
+    QElapsedTimer animationTimer;
+    animationTimer.start();
+    
+    if (mPlayer) {
+        mPlayer->advanceAnimation(mClock.getDelta(GameClock::Player));
+    }
+    const qreal enemyDt = mClock.getDelta(GameClock::Enemies);
+    for (EnemyBase* enemy : mEnemies) {
+        if (enemy && !enemy->isPendingRemoval()) {
+            enemy->advanceAnimation(enemyDt);
+        }
+    }
+    const qreal itemDt = mClock.getDelta(GameClock::Items);
+    for (GameItem* item : mItems) {
+        if (item && !item->isPendingRemoval()) {
+            item->advanceAnimation(itemDt);
+        }
+    }
+    
+    mAnimationNsecs += animationTimer.nsecsElapsed();
+}
+
 void SugarOilGameSceneNew::checkPlayerItemCollisions()
 {
     if (!mPlayer) return;
     
     QRectF playerRect = mPlayer->boundingRect().translated(mPlayer->pos());
     
-    for (int i = mItems.size() - 1; i >= 0; --i) {
-        GameItem* item = mItems[i];
-        if (!item) {
-            mItems.removeAt(i);
+    for (GameItem* item : mItems) {
+        // 已拾取（等待帧末移除）的道具不再生效
+        if (!item || item->isPendingRemoval()) {
             continue;
         }
         
@@ -842,10 +1479,9 @@ void SugarOilGameSceneNew::checkPlayerItemCollisions()
         if (playerRect.intersects(itemRect)) {
             // 应用道具效果
             item->applyEffect(mPlayer);
+            applyItemWorldEffect(item);
             // 移除道具
-            removeItem(item);
-            mItems.removeAt(i);
-            item->deleteLater();
+            mItems.queueRemoval(item);
         }
     }
 }
@@ -854,10 +1490,8 @@ void SugarOilGameSceneNew::removeCollectedItems()
 {
     // 道具在碰撞检测中已经被移除，这里可以处理其他清理逻辑
     // 例如：移除超出屏幕边界的道具
-    for (int i = mItems.size() - 1; i >= 0; --i) {
-        GameItem* item = mItems[i];
+    for (GameItem* item : mItems) {
         if (!item) {
-            mItems.removeAt(i);
             continue;
         }
         
@@ -865,9 +1499,7 @@ void SugarOilGameSceneNew::removeCollectedItems()
         // 如果道具超出屏幕边界，移除它
         if (itemPos.x() < -100 || itemPos.x() > width() + 100 ||
             itemPos.y() < -100 || itemPos.y() > height() + 100) {
-            removeItem(item);
-            mItems.removeAt(i);
-            item->deleteLater();
+            mItems.queueRemoval(item);
         }
     }
 }
@@ -883,6 +1515,11 @@ void SugarOilGameSceneNew::spawnRandomCreature()
 {
     if (!mCreatureManager) return;
     
+    // 场上生物数量有上限，长时间对局的开销保持不变
+    if (mCreatures.size() >= MAX_CREATURES) {
+        return;
+    }
+    
     // 在屏幕边缘随机位置生成生物
     QPointF spawnPos = getRandomSpawnPosition();
     GameCreature* creature = mCreatureManager->spawnRandomCreature(spawnPos);
@@ -896,47 +1533,350 @@ void SugarOilGameSceneNew::updateCreatures()
 {
     if (!mPlayer) return;
     
-    for (int i = mCreatures.size() - 1; i >= 0; --i) {
-        GameCreature* creature = mCreatures[i];
-        if (!creature) {
-            mCreatures.removeAt(i);
+    // 先推进动画、冷却和寿命，收集需要跟随玩家的生物（效果激活由updateCreatureAuras()负责）
+    const qreal dt = mClock.getDelta(GameClock::Player);
+    FrameArray<GameCreature*> followers(mFrameArena);
+    for (GameCreature* creature : mCreatures) {
+        if (!creature || creature->isPendingRemoval()) {
             continue;
         }
         
-        creature->updateCreature();
+        creature->updateCreature(dt);
         
-        // 检查是否靠近玩家
-        if (creature->isNearPlayer(mPlayer->pos(), 50.0)) {
-            creature->activateEffect(mPlayer);
-        } else {
-            // 向玩家移动
-            creature->moveTowardsPlayer(mPlayer->pos());
+        // 寿命结束或一次性效果已用掉的生物回收到对象池
+        if (creature->isExpired()) {
+            mCreatures.queueRemoval(creature);
+            continue;
+        }
+        
+        // 已进入光环范围的生物停在原地
+        if (creature->isFollowingPlayer() && !creature->isNearPlayer(mPlayer->pos(), CREATURE_AURA_RADIUS)) {
+            followers.append(creature);
         }
     }
+    
+    if (followers.isEmpty()) {
+        return;
+    }
+    
+    // 向玩家移动，与敌人共用同一批量转向计算
+    const int count = followers.size();
+    mSteerX.resize(count);
+    mSteerY.resize(count);
+    mSteerDirX.resize(count);
+    mSteerDirY.resize(count);
+    mSteerSpeed.resize(count);
+    for (int i = 0; i < count; ++i) {
+        const QPointF pos = followers[i]->pos();
+        mSteerX[i] = static_cast<float>(pos.x());
+        mSteerY[i] = static_cast<float>(pos.y());
+        mSteerSpeed[i] = static_cast<float>(followers[i]->getMoveSpeed());
+    }
+    
+    const QPointF target = mPlayer->pos();
+    SteeringSystem::computeSeekDirections(mSteerX.constData(), mSteerY.constData(), count,
+                                          static_cast<float>(target.x()), static_cast<float>(target.y()), 5.0f,
+                                          mSteerDirX.data(), mSteerDirY.data());
+    SteeringSystem::integratePositions(mSteerX.data(), mSteerY.data(),
+                                       mSteerDirX.constData(), mSteerDirY.constData(),
+                                       mSteerSpeed.constData(), count);
+    
+    for (int i = 0; i < count; ++i) {
+        followers[i]->setPos(mSteerX[i], mSteerY[i]);
+    }
 }
 
-void SugarOilGameSceneNew::checkPlayerCreatureCollisions()
+void SugarOilGameSceneNew::updateEnemySteering()
 {
-    if (!mPlayer) return;
+    if (!mPlayer || mEnemies.size() == 0) {
+        return;
+    }
     
-    QRectF playerRect = mPlayer->boundingRect().translated(mPlayer->pos());
+    QElapsedTimer steeringTimer;
+    steeringTimer.start();
     
-    for (GameCreature* creature : mCreatures) {
-        if (!creature) {
+    // 先更新AI细节等级，把本帧需要转向的敌人分成两批：
+    // 完整/降频等级参与群体转向，粗略等级只做直线追踪；降频的敌人错开帧更新，步长按间隔放大
+    const QPointF target = mPlayer->getCenterPos();
+    const QRectF screenRect = sceneRect();
+    FrameArray<EnemyBase*, 256> crowdMovers(mFrameArena);
+    FrameArray<EnemyBase*, 256> coarseMovers(mFrameArena);
+    // 本帧不参与群体转向的存活敌人（轮空或粗略等级），仍放进网格推开移动中的敌人
+    FrameArray<EnemyBase*, 256> crowdNeighbors(mFrameArena);
+    for (int level = 0; level < EnemyBase::AI_LEVEL_COUNT; ++level) {
+        mAILevelCounts[level] = 0;
+    }
+    
+    // 图元只能在主线程访问：先按列表顺序收集存活敌人的中心点和当前等级
+    FrameArray<AILevelEntry, 256> entries(mFrameArena);
+    entries.reserve(mEnemies.size());
+    for (int i = 0; i < mEnemies.size(); ++i) {
+        EnemyBase* enemy = mEnemies[i];
+        // 已死亡的敌人不再移动
+        if (!enemy || enemy->getHP() <= 0) {
             continue;
         }
-        
-        QRectF creatureRect = creature->boundingRect().translated(creature->pos());
-        if (playerRect.intersects(creatureRect)) {
-            creature->activateEffect(mPlayer);
+        entries.append({ enemy, enemy->getCenterPos(), enemy->getAILevel() });
+    }
+    
+    // 等级判断是纯计算，按块并行，每个块只改写自己的条目
+    AILevelEntry* entryData = entries.data();
+    mJobs.parallelFor(entries.size(), AI_LEVEL_GRAIN, [=](int begin, int end) {
+        for (int k = begin; k < end; ++k) {
+            entryData[k].level = EnemyBase::chooseAILevel(entryData[k].level, entryData[k].center, target, screenRect);
+        }
+    });
+    
+    // 按列表顺序写回并分批，结果与逐个更新完全相同
+    for (const AILevelEntry &entry : entries) {
+        EnemyBase* enemy = entry.enemy;
+        enemy->setAILevel(entry.level);
+        ++mAILevelCounts[static_cast<int>(entry.level)];
+        // 按生成编号错开：移除敌人时列表会交换补位，下标不能用来决定哪一帧更新
+        const bool moving = (mTick + enemy->getSpawnId()) % enemy->getSteeringStride() == 0;
+        if (moving && enemy->getAILevel() != EnemyBase::AILevel::Coarse) {
+            crowdMovers.append(enemy);
+            continue;
+        }
+        crowdNeighbors.append(enemy);
+        if (moving) {
+            coarseMovers.append(enemy);
+        }
+    }
+    
+    // 分离/聚合：邻居由网格给出，避免所有敌人叠在玩家中心；网格包含全部存活敌人
+    steerEnemyBatch(crowdMovers.constData(), crowdMovers.size(),
+                    crowdNeighbors.constData(), crowdNeighbors.size(), true);
+    steerEnemyBatch(coarseMovers.constData(), coarseMovers.size(), nullptr, 0, false);
+    
+    mSteeringNsecs += steeringTimer.nsecsElapsed();
+}
+
+void SugarOilGameSceneNew::steerEnemyBatch(EnemyBase* const* enemies, int count,
+                                           EnemyBase* const* neighbors, int neighborCount, bool withCrowd)
+{
+    if (count == 0) {
+        return;
+    }
+    
+    // 减速/冻结只需读取一次阵营缩放
+    const qreal enemyScale = mClock.getScale(GameClock::Enemies);
+    
+    // 打包敌人的中心坐标：移动的敌人在前，只作邻居的敌人接在后面
+    const int total = count + neighborCount;
+    mSteerX.resize(total);
+    mSteerY.resize(total);
+    mSteerDirX.resize(count);
+    mSteerDirY.resize(count);
+    mSteerSpeed.resize(count);
+    mSteerGroup.resize(total);
+    for (int i = 0; i < neighborCount; ++i) {
+        const QPointF center = neighbors[i]->getCenterPos();
+        mSteerX[count + i] = static_cast<float>(center.x());
+        mSteerY[count + i] = static_cast<float>(center.y());
+        mSteerGroup[count + i] = static_cast<quint8>(neighbors[i]->getEnemyType());
+    }
+    for (int i = 0; i < count; ++i) {
+        EnemyBase* enemy = enemies[i];
+        mSteerGroup[i] = static_cast<quint8>(enemy->getEnemyType());
+        const QPointF center = enemy->getCenterPos();
+        mSteerX[i] = static_cast<float>(center.x());
+        mSteerY[i] = static_cast<float>(center.y());
+        // 隔帧更新的敌人一次走完间隔内的距离
+        mSteerSpeed[i] = static_cast<float>(enemy->getSpeedPerTick(UPDATE_INTERVAL * enemy->getSteeringStride()) * enemyScale);
+    }
+    
+    // 一次性计算所有敌人的追踪方向、群体转向并积分，各阶段在工作线程上按块并行
+    const QPointF target = mPlayer->getCenterPos();
+    SteeringSystem::steer(&mJobs, mSteerX.data(), mSteerY.data(), count, total,
+                          static_cast<float>(target.x()), static_cast<float>(target.y()), 0.0f,
+                          withCrowd ? &mEnemyGrid : nullptr,
+                          mSteerGroup.constData(), EnemyBase::getCrowdParamsTable(),
+                          mSteerSpeed.constData(), mSteerDirX.data(), mSteerDirY.data());
+    
+    // 批量写回位置
+    for (int i = 0; i < count; ++i) {
+        if (mSteerSpeed[i] > 0.0f) {
+            enemies[i]->applySteering(QPointF(mSteerX[i], mSteerY[i]));
+        }
+    }
+}
+
+void SugarOilGameSceneNew::updateEnemyAI()
+{
+    // 冻结时dt为0，所有敌人的AI和技能随之停止；粗略等级的敌人不运行AI
+    const qreal dt = mClock.getDelta(GameClock::Enemies);
+    mSkillScheduler.advance(dt);
+    for (EnemyBase* enemy : mEnemies) {
+        if (enemy && !enemy->isPendingRemoval() && enemy->getAILevel() != EnemyBase::AILevel::Coarse) {
+            enemy->advanceAI(dt);
+        }
+    }
+}
+
+void SugarOilGameSceneNew::updateBullets()
+{
+    // 玩家子弹跟随玩家阵营的时间，敌人子弹有独立的缩放
+    const qreal playerDt = mClock.getDelta(GameClock::Player);
+    for (BulletBase* bullet : mPlayerBullets) {
+        if (bullet && !bullet->isDestroyed()) {
+            bullet->moveBullet(playerDt);
+        }
+    }
+    
+    // 敌人子弹：整个存储一次积分，越界的直接swap-and-pop移除
+    QElapsedTimer bulletTimer;
+    bulletTimer.start();
+    mEnemyBulletStore.integrate(static_cast<float>(mClock.getDelta(GameClock::EnemyBullets)), &mJobs);
+    mEnemyBulletStore.removeOutside(mEnemyBulletItem->boundingRect());
+    mEnemyBulletNsecs += bulletTimer.nsecsElapsed();
+}
+
+void SugarOilGameSceneNew::applyItemWorldEffect(const GameItem* item)
+{
+    const ItemEffect effect = item->getEffect();
+    switch (item->getItemType()) {
+    case ITEM_TIME_SLOW:
+        // 时间减缓：敌人和敌人子弹降到30%速度
+        mClock.applyTimedScale(GameClock::Enemies, TIME_SLOW_SCALE, effect.duration);
+        mClock.applyTimedScale(GameClock::EnemyBullets, TIME_SLOW_SCALE, effect.duration);
+        break;
+    case ITEM_FREEZE_ENEMIES:
+        // 冰冻敌人：敌人移动和攻击完全停止，已发射的子弹不受影响
+        mClock.applyTimedScale(GameClock::Enemies, 0.0, effect.duration);
+        break;
+    case ITEM_BOMB:
+        // 炸弹：清除屏幕内的敌人和敌人子弹
+        queryRect(sceneRect(), QUERY_ENEMIES, [](GameObjectBase* object, EntityQueryFaction) {
+            EnemyBase* enemy = static_cast<EnemyBase*>(object);
+            if (enemy->getHP() > 0) {
+                // 死亡时由onEnemyDied入队
+                enemy->takeDamage(BOMB_DAMAGE);
+            }
+            return true;
+        });
+        mEnemyBulletStore.removeInside(sceneRect());
+        break;
+    default:
+        break;
+    }
+}
+
+void SugarOilGameSceneNew::rebuildQueryIndex()
+{
+    // 等待销毁的实体不进入索引
+    auto rebuildLayer = [this](EntityQueryFaction faction, const auto &list) {
+        mQueryIndex.clearLayer(faction);
+        for (GameObjectBase* object : list) {
+            if (object && !object->isPendingRemoval()) {
+                mQueryIndex.add(faction, object, object->getCenterPos());
+            }
+        }
+        mQueryIndex.buildLayer(faction);
+    };
+    rebuildLayer(QUERY_ENEMIES, mEnemies);
+    rebuildLayer(QUERY_ITEMS, mItems);
+    rebuildLayer(QUERY_CREATURES, mCreatures);
+    rebuildLayer(QUERY_PLAYER_BULLETS, mPlayerBullets);
+}
+
+void SugarOilGameSceneNew::updateItemMagnet()
+{
+    if (!mPlayer || !mPlayer->isMagnetismEnabled()) {
+        return;
+    }
+    
+    // 道具跟随道具阵营的时间缩放
+    const qreal step = MAGNET_PULL_SPEED * mClock.getScale(GameClock::Items);
+    const QPointF target = mPlayer->getCenterPos();
+    queryRadius(target, MAGNET_RADIUS, QUERY_ITEMS, [&](GameObjectBase* object, EntityQueryFaction) {
+        const QPointF delta = target - object->getCenterPos();
+        const qreal distance = qSqrt(delta.x() * delta.x() + delta.y() * delta.y());
+        if (distance > 0.0) {
+            // 不越过玩家中心
+            object->moveBy(delta.x() / distance * qMin(step, distance),
+                           delta.y() / distance * qMin(step, distance));
         }
+        return true;
+    });
+}
+
+void SugarOilGameSceneNew::updateCreatureAuras()
+{
+    if (!mPlayer) {
+        return;
     }
+    
+    // 光环范围内的生物为玩家提供效果
+    queryRadius(mPlayer->getCenterPos(), CREATURE_AURA_RADIUS, QUERY_CREATURES,
+                [this](GameObjectBase* object, EntityQueryFaction) {
+        static_cast<GameCreature*>(object)->tryActivate(mPlayer);
+        return true;
+    });
 }
 
-void SugarOilGameSceneNew::removeActivatedCreatures()
+void SugarOilGameSceneNew::updateCreatureTurrets()
 {
-    // 暂时保留所有生物，可以根据需要添加移除逻辑
-    // 例如：生物激活效果后一段时间后自动消失
+    if (!mPlayer || mEnemies.size() == 0) {
+        return;
+    }
+    
+    QElapsedTimer turretTimer;
+    turretTimer.start();
+    
+    // 所有炮台共用本帧的敌人索引；已被别的炮台选中的敌人尽量避开，分散火力
+    const qreal dt = mClock.getDelta(GameClock::Player);
+    const int damage = qMax(1, mPlayer->getAttackPoint() / 2);
+    FrameArray<GameObjectBase*, 16> claimed(mFrameArena);
+    for (GameCreature* creature : mCreatures) {
+        if (!creature || creature->isPendingRemoval() || !creature->isCombatCreature()) {
+            continue;
+        }
+        if (!creature->advanceFireCooldown(dt)) {
+            continue;
+        }
+        
+        const QPointF origin = creature->getCenterPos();
+        GameObjectBase* candidates[TURRET_TARGET_CANDIDATES];
+        const int found = mQueryIndex.findNearest(origin, TURRET_RANGE, QUERY_ENEMIES,
+                                                  candidates, TURRET_TARGET_CANDIDATES);
+        GameObjectBase* target = nullptr;
+        GameObjectBase* nearestAlive = nullptr;
+        for (int i = 0; i < found && !target; ++i) {
+            if (candidates[i]->isPendingRemoval() || static_cast<EnemyBase*>(candidates[i])->getHP() <= 0) {
+                continue;
+            }
+            if (!nearestAlive) {
+                nearestAlive = candidates[i];
+            }
+            bool taken = false;
+            for (GameObjectBase* other : claimed) {
+                if (other == candidates[i]) {
+                    taken = true;
+                    break;
+                }
+            }
+            if (!taken) {
+                target = candidates[i];
+            }
+        }
+        // 候选都已被选中时仍然打最近的存活敌人，没有存活的就不开火
+        if (!target) {
+            target = nearestAlive;
+        }
+        if (!target) {
+            continue;
+        }
+        claimed.append(target);
+        
+        QPointF direction = target->getCenterPos() - origin;
+        const qreal length = qSqrt(direction.x() * direction.x() + direction.y() * direction.y());
+        if (length > 0) {
+            createPlayerBullet(origin, direction / length, damage);
+        }
+    }
+    
+    mTurretNsecs += turretTimer.nsecsElapsed();
 }
 
 void SugarOilGameSceneNew::removeOutOfBoundsBullets()
@@ -948,35 +1888,15 @@ void SugarOilGameSceneNew::removeOutOfBoundsBullets()
     const qreal minY = -margin;
     const qreal maxY = SUGAR_OIL_SCENE_HEIGHT + margin;
     
-    // 检查玩家子弹
-    for (int i = mPlayerBullets.size() - 1; i >= 0; --i) {
-        BulletBase* bullet = mPlayerBullets[i];
-        if (!bullet) {
-            mPlayerBullets.removeAt(i);
-            continue;
-        }
-        
-        QPointF pos = bullet->pos();
-        if (pos.x() < minX || pos.x() > maxX || pos.y() < minY || pos.y() > maxY) {
-            removeItem(bullet);
-            mPlayerBullets.removeAt(i);
-            BulletBase::returnBulletToPool(bullet);
-        }
-    }
-    
-    // 检查敌人子弹
-    for (int i = mEnemyBullets.size() - 1; i >= 0; --i) {
-        BulletBase* bullet = mEnemyBullets[i];
-        if (!bullet) {
-            mEnemyBullets.removeAt(i);
+    // 敌人子弹在updateBullets()中随积分一起清理，这里只检查玩家子弹
+    for (BulletBase* bullet : mPlayerBullets) {
+        if (!bullet || bullet->isDestroyed()) {
             continue;
         }
         
         QPointF pos = bullet->pos();
         if (pos.x() < minX || pos.x() > maxX || pos.y() < minY || pos.y() > maxY) {
-            removeItem(bullet);
-            mEnemyBullets.removeAt(i);
-            BulletBase::returnBulletToPool(bullet);
+            queueBulletRemoval(bullet);
         }
     }
 }
@@ -986,44 +1906,28 @@ void SugarOilGameSceneNew::onPlayerShoot(QPointF position, QPointF direction, in
     createPlayerBullet(position, direction, damage);
 }
 
-void SugarOilGameSceneNew::onEnemyAttack(EnemyBase* enemy, QPointF position, QPointF direction, int damage)
+void SugarOilGameSceneNew::onEnemyFirePattern(EnemyBase* enemy, int patternId, QPointF origin, float baseAngleDeg, int damage)
 {
-    createEnemyBullet(enemy, position, direction, damage);
+    Q_UNUSED(enemy)
+    // 一次发射的所有子弹直接写入存储
+    BulletPatterns::fire(mEnemyBulletStore, static_cast<BulletPatternId>(patternId), origin, baseAngleDeg, damage);
 }
 
-void SugarOilGameSceneNew::createPlayerBullet(const QPointF &position, const QPointF &direction, int damage)
+BulletBase* SugarOilGameSceneNew::createPlayerBullet(const QPointF &position, const QPointF &direction, int damage)
 {
     // 使用对象池获取子弹，减少内存分配开销
     BulletBase* bullet = BulletBase::getBulletFromPool(mPlayer, BulletBase::BulletType::PlayerBullet);
     bullet->setPos(position);
     bullet->setMoveDirection(direction);
-    bullet->setSpeed(5.0); // 降低速度减少穿透问题
+    bullet->setSpeed(10.0); // 连续碰撞检测下速度不再受穿透问题限制
     bullet->setDamage(damage);
+    bullet->resetSweep();
     addItem(bullet);
     mPlayerBullets.append(bullet);
     
-    connect(bullet, &BulletBase::bulletOutOfBounds, this, &SugarOilGameSceneNew::onBulletOutOfBounds);
-    bullet->startMoving();
-}
-
-void SugarOilGameSceneNew::createEnemyBullet(EnemyBase* enemy, const QPointF &position, const QPointF &direction, int damage)
-{
-    // 使用对象池获取子弹，减少内存分配开销
-    BulletBase* bullet = BulletBase::getBulletFromPool(enemy, BulletBase::BulletType::EnemyBullet);
-    if (!bullet) {
-        qWarning("Failed to create enemy bullet!");
-        return;
-    }
-    
-    bullet->setPos(position);
-    bullet->setMoveDirection(direction);
-    bullet->setSpeed(6.0);
-    bullet->setDamage(damage);
-    addItem(bullet);
-    mEnemyBullets.append(bullet);
-    
-    connect(bullet, &BulletBase::bulletOutOfBounds, this, &SugarOilGameSceneNew::onBulletOutOfBounds);
+    // 越界由removeOutOfBoundsBullets()统一检查；池中的子弹反复取用，不再每次连接信号
     bullet->startMoving();
+    return bullet;
 }
 
 void SugarOilGameSceneNew::onEnemyDied(EnemyBase* enemy)
@@ -1037,14 +1941,15 @@ void SugarOilGameSceneNew::onEnemyDied(EnemyBase* enemy)
     
     emit scoreChanged(getScore());
     
-    // 确保敌人从列表中移除（如果还在的话）
-    mEnemies.removeAll(enemy);
+    // 加入销毁队列，帧末统一移除
+    mEnemies.queueRemoval(enemy);
 }
 
 void SugarOilGameSceneNew::onPlayerDied()
 {
     qDebug() << "Player died!";
     stopGame();
+    discardAutosave();
     // 播放失败音效
     AudioManager::getInstance()->playGameMusic(AudioManager::MusicType::Defeat);
     emit gameOver(getScore(), getPlayerLevel());
@@ -1056,28 +1961,11 @@ void SugarOilGameSceneNew::onPlayerLevelUp(int newLevel)
     qDebug() << "Player leveled up to level" << newLevel;
 }
 
-void SugarOilGameSceneNew::onBulletOutOfBounds(BulletBase* bullet)
+void SugarOilGameSceneNew::queueBulletRemoval(BulletBase* bullet)
 {
-    // 检查子弹是否已经被销毁，避免重复处理
-    if (!bullet || bullet->isDestroyed()) {
-        qDebug() << "onBulletOutOfBounds: Bullet already destroyed, skipping";
-        return;
-    }
-    
-    qDebug() << "onBulletOutOfBounds: Processing bullet removal";
-    
-    // 标记为已销毁
+    // 标记为已销毁，帧末从列表中O(1)移除并归还对象池（敌人子弹不是BulletBase，不会走到这里）
     bullet->markForDestruction();
-    
-    // 从列表中移除子弹
-    mPlayerBullets.removeAll(bullet);
-    mEnemyBullets.removeAll(bullet);
-    
-    // 从场景中移除
-    removeItem(bullet);
-    
-    // 使用对象池回收子弹，提高性能
-    BulletBase::returnBulletToPool(bullet);
+    mPlayerBullets.queueRemoval(bullet);
 }
 
 void SugarOilGameSceneNew::drawMapBoundaries()
@@ -1103,16 +1991,23 @@ void SugarOilGameSceneNew::drawMapBoundaries()
     // 右边界
     QGraphicsRectItem* rightBorder = addRect(SCENE_WIDTH - borderWidth, 0, borderWidth, SCENE_HEIGHT, boundaryPen, boundaryBrush);
     rightBorder->setZValue(10);
+    
+    // 边界不会移动，归入静态图层
+    mStaticLayer.setItems({ topBorder, bottomBorder, leftBorder, rightBorder });
 }
 
 void SugarOilGameSceneNew::keyPressEvent(QKeyEvent *event)
 {
-    handleKeyPress(event->key());
+    if (!event->isAutoRepeat()) {
+        handleKeyPress(event->key());
+    }
     QGraphicsScene::keyPressEvent(event);
 }
 
 void SugarOilGameSceneNew::keyReleaseEvent(QKeyEvent *event)
 {
-    handleKeyRelease(event->key());
+    if (!event->isAutoRepeat()) {
+        handleKeyRelease(event->key());
+    }
     QGraphicsScene::keyReleaseEvent(event);
 }
\ No newline at end of file
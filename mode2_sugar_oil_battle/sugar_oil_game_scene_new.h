@@ -4,6 +4,7 @@
 #include <QGraphicsScene>
 #include <QTimer>
 #include <QList>
+#include <QVector>
 #include <QKeyEvent>
 #include <QRandomGenerator>
 #include <QGraphicsPixmapItem>
@@ -16,10 +17,27 @@
 #include "bullet_base.h"
 #include "item_system.h"
 #include "creature_system.h"
+#include "steering_system.h"
+#include "spatial_grid.h"
+#include "swept_collision.h"
+#include "entity_list.h"
+#include "frame_arena.h"
+#include "game_clock.h"
+#include "entity_query.h"
+#include "bullet_store.h"
+#include "bullet_store_item.h"
+#include "bullet_patterns.h"
+#include "wave_director.h"
+#include "job_system.h"
+#include "../replay_log.h"
+#include "../snapshot_io.h"
+#include "../render_profile.h"
 
 class SugarOilGameSceneNew : public QGraphicsScene
 {
     Q_OBJECT
+    // 性能基准使用场景的常量和内部状态（摆放实体、逐帧推进），见../benchmarks.h
+    friend class Benchmarks;
 
 public:
     explicit SugarOilGameSceneNew(QObject *parent = nullptr);
@@ -52,6 +70,52 @@ public:
     
     // 获取玩家引用
     SugarOilPlayer* getPlayer() const { return mPlayer; }
+    
+    // 回放：每局都会把随机数种子和逐帧输入录进内存，结束时保存到本地数据目录
+    // startReplay()按录像重新开始一局（画面照常渲染，玩家输入被忽略）；
+    // runReplayHeadless()不等待定时器，连续推进到录像结束，可作为性能回归的固定负载
+    bool startReplay(const QByteArray &data);
+    bool runReplayHeadless(const QByteArray &data);
+    bool isReplaying() const { return mReplaying; }
+    
+    // 切换渲染档位时重建静态图层（背景和地图边界）
+    void applyRenderProfile(RenderProfile profile);
+    
+    const QByteArray &getReplayData() const { return mReplayWriter.data(); }
+    static QString getLastReplayPath();
+    
+    // 存档：整局状态（实体、限时效果、波次导演、随机数流）写成一份扁平的二进制快照。
+    // 游戏中每隔一段游戏时间在主线程生成快照、由后台线程写盘；关闭窗口时同步存档，
+    // continueFromAutosave()直接从快照接着玩，不重新开局
+    QByteArray saveSnapshot();
+    bool continueFromSnapshot(const QByteArray &data);
+    bool continueFromAutosave();
+    bool saveAutosaveNow();
+    void discardAutosave();
+    static QString getAutosavePath();
+    static bool hasAutosave();
+    
+    // 空间查询：factionMask为EntityQueryFaction的组合
+    // fn(GameObjectBase* object, EntityQueryFaction faction)返回false时提前结束
+    template<typename Fn>
+    void queryRadius(const QPointF &center, qreal radius, int factionMask, Fn fn)
+    {
+        QElapsedTimer queryTimer;
+        queryTimer.start();
+        mQueryIndex.queryRadius(center, radius, factionMask, fn);
+        mQueryNsecs += queryTimer.nsecsElapsed();
+        ++mQueryCount;
+    }
+    
+    template<typename Fn>
+    void queryRect(const QRectF &rect, int factionMask, Fn fn)
+    {
+        QElapsedTimer queryTimer;
+        queryTimer.start();
+        mQueryIndex.queryRect(rect, factionMask, fn);
+        mQueryNsecs += queryTimer.nsecsElapsed();
+        ++mQueryCount;
+    }
 
 signals:
     void gameStarted();
@@ -65,28 +129,50 @@ signals:
     void playerStatsChanged(int hp, int maxHp, int level, int exp);
 
 public slots:
-    void onGameTimerTimeout();
     void onPlayerShoot(QPointF position, QPointF direction, int damage);
-    void onEnemyAttack(EnemyBase* enemy, QPointF position, QPointF direction, int damage);
+    void onEnemyFirePattern(EnemyBase* enemy, int patternId, QPointF origin, float baseAngleDeg, int damage);
     void onEnemyDied(EnemyBase* enemy);
     void onPlayerDied();
     void onPlayerLevelUp(int newLevel);
-    void onBulletOutOfBounds(BulletBase* bullet);
 
 protected:
+    void drawBackground(QPainter *painter, const QRectF &rect) override;
     void keyPressEvent(QKeyEvent *event) override;
     void keyReleaseEvent(QKeyEvent *event) override;
     
 private slots:
+    void onDisplayFrame();
     void updateGame();
-    void spawnEnemies();
+    void logPerformanceStats();
     void updateCollisions();
     void updatePlayerMovement();
     void cleanupObjects();
     void updateItems();
     void updateCreatures();
+    void updateAnimations();
+    void updateEnemySteering();
+    void updateEnemyAI();
+    void updateBullets();
+    void rebuildQueryIndex();
+    void updateItemMagnet();
+    void updateCreatureAuras();
+    void updateCreatureTurrets();
     
 private:
+    // 一次键盘或鼠标输入，timestampNs为mSimTimer上的采集时刻
+    enum class InputKind : quint8 {
+        KeyPress,
+        KeyRelease,
+        MousePress
+    };
+    struct InputEvent {
+        qint64 timestampNs;
+        InputKind kind;
+        int key;
+        QPointF scenePos;
+    };
+    static const int INPUT_QUEUE_CAPACITY = 256; // 预留的容量，两个逻辑帧之间的输入远少于此
+    
     // 初始化方法
     void initializeScene();
     void initializePlayer();
@@ -97,22 +183,56 @@ private:
     void drawMapBoundaries();
     
     // 游戏逻辑
-    void spawnEnemy(EnemyBase::EnemyType type, const QPointF &position);
-    void createPlayerBullet(const QPointF &position, const QPointF &direction, int damage);
-    void createEnemyBullet(EnemyBase* enemy, const QPointF &position, const QPointF &direction, int damage);
+    EnemyBase* spawnEnemy(EnemyBase::EnemyType type, const QPointF &position);
+    // 敌人对象池：新建的敌人只在这里连接信号并加入场景，回收时隐藏留在场景中
+    EnemyBase* createPooledEnemy();
+    void releaseEnemy(EnemyBase* enemy);
+    void applyItemWorldEffect(const GameItem* item);
+    void steerEnemyBatch(EnemyBase* const* enemies, int count,
+                         EnemyBase* const* neighbors, int neighborCount, bool withCrowd);
+    BulletBase* createPlayerBullet(const QPointF &position, const QPointF &direction, int damage);
     
     // 碰撞检测
     void checkPlayerEnemyCollisions();
     void checkPlayerBulletEnemyCollisions();
     void checkEnemyBulletPlayerCollisions();
     void checkPlayerItemCollisions();
-    void checkPlayerCreatureCollisions();
     
     // 清理方法
     void removeDeadEnemies();
     void removeOutOfBoundsBullets();
     void removeCollectedItems();
-    void removeActivatedCreatures();
+    void flushDeathQueues();
+    void queueBulletRemoval(BulletBase* bullet);
+    
+    // 游戏时间（秒）、道具和生物的生成都按游戏时钟推进
+    void updateGameTime();
+    void updateTimedSpawns();
+    
+    // 读档：失败时回到新一局的初始状态
+    bool restoreSnapshot(const QByteArray &data);
+    void clearEntities();
+    
+    // 本帧随机数流的种子，由本局种子和帧序号派生
+    quint32 getTickSeed() const;
+    
+    // 显示帧循环：开始或继续时从当前时刻重新计时，暂停期间的时间不补帧
+    void startFrameLoop();
+    int getDisplayInterval() const;
+    // 发布一份子弹绘制快照并请求重绘
+    void publishRenderState();
+    // 视图自上次统计以来的平均绘制耗时（微秒）
+    qreal takeAveragePaintUs();
+    
+    // 输入先带时间戳进入队列，在对应的逻辑帧开始时生效
+    void queueInput(InputKind kind, int key, const QPointF &scenePos);
+    void applyQueuedInput();
+    
+    // 回放输入
+    void recordReplayInput();
+    void applyReplayInput();
+    void shootAt(const QPointF &scenePos);
+    quint32 getMovementKeyMask() const;
     
     // 敌人生成逻辑
     void updateEnemySpawning();
@@ -128,29 +248,97 @@ private:
     SugarOilPlayer* mPlayer;
      
      // 游戏对象列表
-    QList<EnemyBase*> mEnemies;
-    QList<BulletBase*> mPlayerBullets;
-    QList<BulletBase*> mEnemyBullets;
-    QList<GameItem*> mItems;
-    QList<GameCreature*> mCreatures;
+    // 删除采用swap-and-pop，帧内只入队，帧末由flushDeathQueues()统一销毁
+    EntityList<EnemyBase> mEnemies;
+    EntityList<BulletBase> mPlayerBullets;
+    EntityList<GameItem> mItems;
+    EntityList<GameCreature> mCreatures;
+    QVector<EnemyBase*> mEnemyPool; // 空闲的敌人
+    
+    // 敌人子弹：SoA存储 + 单个批量绘制图元
+    BulletStore mEnemyBulletStore;
+    BulletStoreItem* mEnemyBulletItem;
+    
+    // 批量转向缓冲区（SoA布局，跨帧复用避免重复分配）
+    QVector<float> mSteerX;
+    QVector<float> mSteerY;
+    QVector<float> mSteerDirX;
+    QVector<float> mSteerDirY;
+    QVector<float> mSteerSpeed;
+    QVector<quint8> mSteerGroup;
+    
+    // 敌人邻居查询网格（覆盖场景及场外生成区域）
+    SpatialGrid mEnemyGrid;
+    
+    // 场景实体空间索引，供炸弹、磁铁、光环等范围效果查询
+    EntityQueryIndex mQueryIndex;
     
     // 性能监控
     int mFrameCount = 0;
     QElapsedTimer mPerformanceTimer;
+    qint64 mSteeringNsecs = 0; // 统计周期内批量转向累计耗时
+    qint64 mRemovalNsecs = 0; // 统计周期内帧末销毁累计耗时
+    int mRemovalCount = 0; // 统计周期内销毁的实体数
+    quint64 mFrameAllocations = 0; // 统计周期内帧循环的堆分配次数（需开启alloc_tracking）
+    quint64 mLastTickAllocations = 0; // 上一帧的堆分配次数
+    qint64 mQueryNsecs = 0; // 统计周期内空间查询累计耗时
+    int mQueryCount = 0; // 统计周期内空间查询次数
+    qint64 mTurretNsecs = 0; // 统计周期内生物炮台选敌累计耗时
+    qint64 mEnemyBulletNsecs = 0; // 统计周期内敌人子弹积分与越界清理累计耗时
+    qint64 mAnimationNsecs = 0; // 统计周期内帧动画推进累计耗时
+    int mAILevelCounts[EnemyBase::AI_LEVEL_COUNT] = {}; // 上一帧各AI细节等级的敌人数
+    qint64 mSnapshotNsecs = 0; // 最近一次生成快照的耗时
+    int mSnapshotBytes = 0; // 最近一次快照的大小
     
-    // 背景
-    QGraphicsPixmapItem* mBackground;
+    // 帧内临时缓冲区，每帧结束时统一回收
+    FrameArena mFrameArena;
     
-    // 定时器
-    QTimer* mGameTimer;
+    // 工作线程池：AI细节等级、转向和子弹积分按块并行，触发技能、伤害结算等仍在主线程按顺序进行
+    JobSystem mJobs;
+    
+    // 背景图和地图边界
+    StaticLayer mStaticLayer;
+    
+    // 定时器：按显示刷新率触发，逻辑帧在其中按固定步长补齐
     QTimer* mUpdateTimer;
-    QTimer* mSpawnTimer;
+    
+    // 固定步长模拟
+    // 逻辑帧固定为UPDATE_INTERVAL，与显示帧率无关：显示帧慢时一次补多个逻辑帧，快时只重绘插值后的画面
+    // 逻辑帧和绘制在同一个GUI线程：一次绘制过慢仍会推迟逻辑帧，只是之后按实际时间补齐（最多MAX_TICKS_PER_FRAME帧）
+    QElapsedTimer mSimTimer; // 输入时间戳和模拟时间共用的单调时基
+    qint64 mSimTimeNs; // 已模拟到的时刻（mSimTimer时基）
+    // 等待逻辑帧处理的输入；事件处理和逻辑帧都在GUI线程，按时间先后追加，从mInputHead起依次取出
+    QVector<InputEvent> mInputQueue;
+    int mInputHead = 0;
+    int mDisplayFrameCount = 0; // 统计显示帧率用
     
     // 游戏状态
     bool mGameRunning;
     bool mGamePaused;
     int mGameTime; // 游戏时间（秒）
+    GameClock mClock; // 游戏时钟，只在游戏运行时随帧推进，暂停时停止；按阵营提供时间缩放
+    SkillScheduler mSkillScheduler; // 敌人技能脚本，按敌人阵营时间推进
+    qint64 mTick; // 本局已完成的模拟帧数，回放事件按它对齐
+    QRandomGenerator mRandom; // 本局所有模拟用随机数，按种子复现
+    quint32 mSeed;
     int mSpawnCounter;
+    quint32 mNextEnemyId; // 下一个生成的敌人的编号
+    WaveDirector mWaveDirector; // 敌人波次，按游戏时间和实测帧时间生成
+    QVector<WaveSpawn> mWaveSpawns; // 本帧的生成请求，复用容量
+    QElapsedTimer mFrameTimer; // 两次显示帧之间的实际间隔（含渲染），暂停时作废
+    
+    // 回放录制与播放
+    ReplayWriter mReplayWriter;
+    ReplayReader mReplayReader;
+    bool mReplaying;
+    quint32 mLastKeyMask;
+    
+    // 存档
+    SnapshotWriter mSnapshotWriter; // 跨存档复用缓冲区
+    SnapshotAutosaver mAutosaver;
+    qint64 mNextAutosaveAt; // 下次自动存档的游戏时间
+    bool mAutosaveEnabled; // 正常对局和读档后的对局自动存档，回放不存
+    QString mAutosavePath; // 构造时求一次，帧循环中不再拼接路径
     
     // 输入状态
     QSet<int> mPressedKeys;
@@ -163,18 +351,39 @@ private:
     ItemManager* mItemManager;
     CreatureManager* mCreatureManager;
     
-    // 生成计时器
-    QTimer* mItemSpawnTimer;
-    QTimer* mCreatureSpawnTimer;
+    // 道具和生物的下次生成时刻（游戏时间）
+    qint64 mNextItemSpawnAt;
+    qint64 mNextCreatureSpawnAt;
     int mItemSpawnCounter;
     int mCreatureSpawnCounter;
     
     // 游戏配置
     static const int GAME_DURATION = 300; // 5分钟
     static const int UPDATE_INTERVAL = 16; // 60 FPS，与配置文件保持一致
-    static const int SPAWN_INTERVAL = 3000; // 3秒，降低生成频率
+    static constexpr qint64 TICK_NSECS = UPDATE_INTERVAL * 1000000LL;
+    static const int MAX_TICKS_PER_FRAME = 5; // 单个显示帧最多补的逻辑帧数，超出的积压直接丢弃
+    static const int ITEM_SPAWN_INTERVAL = 8000; // 每8秒生成一个道具
+    static const int CREATURE_SPAWN_INTERVAL = 15000; // 每15秒生成一个生物
+    static const int AUTOSAVE_INTERVAL = 15000; // 每15秒游戏时间自动存档一次
+    static const int MAX_SNAPSHOT_ENTITIES = 100000; // 读档时拒绝超过该数量的实体列表
+    static constexpr qreal TIME_SLOW_SCALE = 0.3; // 时间减缓道具的速度比例
     static const int SCENE_WIDTH = SUGAR_OIL_SCENE_WIDTH;
     static const int SCENE_HEIGHT = SUGAR_OIL_SCENE_HEIGHT;
+    static const int ENEMY_GRID_MARGIN = 100; // 场外生成点在边界外50像素
+    static const int ENEMY_GRID_CELL_SIZE = 32; // 不小于最大分离半径
+    static const int MAX_ENEMY_BULLETS = 12000; // 敌人子弹存储上限，后期弹幕可达1万颗
+    static const int AI_LEVEL_GRAIN = 1024; // 并行判断AI细节等级时每块的敌人数
+    static const int BULLET_BOUNDS_MARGIN = 50; // 子弹离开场景超过该距离后移除
+    static const int QUERY_GRID_CELL_SIZE = 32; // 查询半径多为几十像素，小格子粗筛更准
+    static const int BOMB_DAMAGE = 999; // 炸弹对屏幕内敌人的伤害，足以清屏
+    static constexpr qreal MAGNET_RADIUS = 200.0; // 磁铁吸引范围
+    static constexpr qreal MAGNET_PULL_SPEED = 6.0; // 磁铁每帧拉动道具的距离
+    static constexpr qreal CREATURE_AURA_RADIUS = 50.0; // 生物光环生效范围
+    static constexpr qreal TURRET_RANGE = 250.0; // 战斗型生物的索敌范围
+    static const int TURRET_TARGET_CANDIDATES = 4; // 每个炮台取最近的几个敌人，用于分散火力
+    static const int MAX_CREATURES = 6; // 场上生物数量上限
+    static const int ENEMY_POOL_SIZE = 256; // 预先创建的敌人数，高于波次表中最大的maxAlive
+    static const int ITEM_POOL_SIZE = 16; // 预先创建的道具数
 };
 
 #endif // SUGAR_OIL_GAME_SCENE_NEW_H
\ No newline at end of file
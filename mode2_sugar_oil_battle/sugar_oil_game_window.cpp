@@ -1,4 +1,5 @@
 #include "sugar_oil_game_window.h"
+#include "../startup_trace.h"
 #include <QApplication>
 #include <QScreen>
 #include <QFont>
@@ -39,15 +40,6 @@ SugarOilGameWindow::SugarOilGameWindow(QWidget *parent)
     
     setupUI();
     
-    // 创建答题界面（独立窗口）
-    quizWindow = new NutritionQuizWindow(nullptr);
-    connect(quizWindow, &NutritionQuizWindow::quizCompleted, this, [this]() {
-        qDebug() << "答题完成";
-    });
-    connect(quizWindow, &NutritionQuizWindow::backToMenu, this, [this]() {
-        emit gameWindowClosed();
-    });
-    
     // 音乐由主窗口统一管理，此处不播放背景音乐
     // 保持主窗口设置的Mode2Game音乐继续播放
     
@@ -123,9 +115,10 @@ void SugarOilGameWindow::setupGameArea()
 {
     // 创建游戏场景和视图
     gameScene = new SugarOilGameSceneNew(this);
-    gameView = new QGraphicsView(gameScene);
+    gameView = new ProfiledGraphicsView(gameScene);
+    StartupTrace::markFirstPaint(gameView->viewport(), "game_first_frame");
     gameView->setFixedSize(SUGAR_OIL_SCENE_WIDTH, SUGAR_OIL_SCENE_HEIGHT);
-    gameView->setRenderHint(QPainter::Antialiasing);
+    RenderProfiles::apply(gameView, RenderProfiles::current());
     gameView->setVerticalScrollBarPolicy(Qt::ScrollBarAlwaysOff);
     gameView->setHorizontalScrollBarPolicy(Qt::ScrollBarAlwaysOff);
     gameView->setFrameStyle(QFrame::Box);
@@ -270,18 +263,7 @@ void SugarOilGameWindow::startNewGame()
         gameActive = true;
         statusLabel->setText("游戏进行中...");
         pauseButton->setText("暂停");
-        
-        // 连接暂停按钮
-        disconnect(pauseButton, &QPushButton::clicked, nullptr, nullptr);
-        connect(pauseButton, &QPushButton::clicked, [this]() {
-            if (gameScene->isGamePaused()) {
-                gameScene->resumeGame();
-                pauseButton->setText("暂停");
-            } else {
-                gameScene->pauseGame();
-                pauseButton->setText("继续");
-            }
-        });
+        connectPauseButton();
         
         qDebug() << "startNewGame方法完成";
     } else {
@@ -289,6 +271,55 @@ void SugarOilGameWindow::startNewGame()
     }
 }
 
+bool SugarOilGameWindow::continueSavedGame()
+{
+    if (!gameScene || !SugarOilGameSceneNew::hasAutosave()) {
+        return false;
+    }
+    
+    int ret = QMessageBox::question(this, "继续游戏",
+                                  "发现上次未完成的对局，是否继续？",
+                                  QMessageBox::Yes | QMessageBox::No,
+                                  QMessageBox::Yes);
+    if (ret != QMessageBox::Yes) {
+        return false;
+    }
+    
+    if (!gameScene->continueFromAutosave()) {
+        QMessageBox::warning(this, "继续游戏", "存档无法读取，将开始新的一局。");
+        gameScene->discardAutosave();
+        return false;
+    }
+    
+    gameActive = true;
+    statusLabel->setText("游戏进行中...");
+    pauseButton->setText("暂停");
+    connectPauseButton();
+    return true;
+}
+
+void SugarOilGameWindow::connectPauseButton()
+{
+    disconnect(pauseButton, &QPushButton::clicked, nullptr, nullptr);
+    connect(pauseButton, &QPushButton::clicked, [this]() {
+        if (gameScene->isGamePaused()) {
+            gameScene->resumeGame();
+            pauseButton->setText("暂停");
+        } else {
+            gameScene->pauseGame();
+            pauseButton->setText("继续");
+        }
+    });
+}
+
+void SugarOilGameWindow::startReplay(const QByteArray &data)
+{
+    startNewGame();
+    if (gameScene && gameScene->startReplay(data)) {
+        statusLabel->setText("回放中...");
+    }
+}
+
 void SugarOilGameWindow::showGameInstructions()
 {
     QMessageBox::information(this, "游戏说明", 
@@ -310,7 +341,8 @@ void SugarOilGameWindow::showGameInstructions()
 
 void SugarOilGameWindow::keyPressEvent(QKeyEvent *event)
 {
-    if (gameScene && gameActive) {
+    // 自动重复的按键不改变按住状态
+    if (gameScene && gameActive && !event->isAutoRepeat()) {
         gameScene->handleKeyPress(event->key());
     }
     QWidget::keyPressEvent(event);
@@ -318,7 +350,7 @@ void SugarOilGameWindow::keyPressEvent(QKeyEvent *event)
 
 void SugarOilGameWindow::keyReleaseEvent(QKeyEvent *event)
 {
-    if (gameScene && gameActive) {
+    if (gameScene && gameActive && !event->isAutoRepeat()) {
         gameScene->handleKeyRelease(event->key());
     }
     QWidget::keyReleaseEvent(event);
@@ -326,6 +358,13 @@ void SugarOilGameWindow::keyReleaseEvent(QKeyEvent *event)
 
 void SugarOilGameWindow::closeEvent(QCloseEvent *event)
 {
+    // 对局进行中时同步存档后停止，下次进入可以继续
+    if (gameScene && gameScene->isGameRunning() && !gameScene->isReplaying()) {
+        gameScene->saveAutosaveNow();
+        gameScene->stopGame();
+        gameActive = false;
+    }
+    
     emit gameWindowClosed();
     QWidget::closeEvent(event);
 }
@@ -345,7 +384,7 @@ void SugarOilGameWindow::onGameLost()
     AudioManager::getInstance()->playGameMusic(AudioManager::MusicType::Defeat);
     
     // 显示答题界面而不是游戏结果
-    if (quizWindow) {
+    if (ensureQuizWindow()) {
         quizWindow->startQuiz();
     } else {
         // 备用方案：如果答题界面创建失败，显示原来的结果
@@ -379,7 +418,7 @@ void SugarOilGameWindow::onGameStateChanged(SugarOilGameState newState)
 void SugarOilGameWindow::onBackButtonClicked()
 {
     int ret = QMessageBox::question(this, "返回主菜单", 
-                                  "确定要返回主菜单吗？当前游戏进度将丢失。",
+                                  "确定要返回主菜单吗？当前进度会自动保存，下次进入时可以继续。",
                                   QMessageBox::Yes | QMessageBox::No,
                                   QMessageBox::No);
     
@@ -522,7 +561,7 @@ void SugarOilGameWindow::showGameResult(bool won)
         // 检查用户点击了哪个按钮
         if (msgBox.clickedButton() == handbookButton) {
             // 直接打开营养知识宝典
-            if (quizWindow) {
+            if (ensureQuizWindow()) {
                 // 先加载数据
                 if (!quizWindow->loadKnowledgeFromDatabase() || !quizWindow->loadQuestionsFromDatabase()) {
                     QMessageBox::warning(this, "错误", "无法加载营养知识数据，请检查数据库连接。");
@@ -537,6 +576,21 @@ void SugarOilGameWindow::showGameResult(bool won)
     }
 }
 
+NutritionQuizWindow* SugarOilGameWindow::ensureQuizWindow()
+{
+    // 答题界面会读取数据库，第一次答题或查看宝典时才创建（独立窗口）
+    if (!quizWindow) {
+        quizWindow = new NutritionQuizWindow(nullptr);
+        connect(quizWindow, &NutritionQuizWindow::quizCompleted, this, [this]() {
+            qDebug() << "答题完成";
+        });
+        connect(quizWindow, &NutritionQuizWindow::backToMenu, this, [this]() {
+            emit gameWindowClosed();
+        });
+    }
+    return quizWindow;
+}
+
 void SugarOilGameWindow::updateControlPanel()
 {
     updateTimeDisplay(currentTime);
@@ -27,6 +27,9 @@ public:
     
     // 游戏控制
     void startNewGame();
+    // 有未完成的对局时询问是否继续，继续成功返回true
+    bool continueSavedGame();
+    void startReplay(const QByteArray &data);
     void showGameInstructions();
     
 protected:
@@ -56,7 +59,9 @@ private:
     void setupGameArea();
     void setupControlPanel();
     void updateControlPanel();
+    void connectPauseButton();
     void showGameResult(bool won);
+    NutritionQuizWindow* ensureQuizWindow();
     void updateTimeDisplay(int seconds);
     void updateLivesDisplay(int lives);
     void updateScoreDisplay(int score);
@@ -67,7 +72,7 @@ private:
     QVBoxLayout* controlPanelLayout;
     
     // 游戏区域
-    QGraphicsView* gameView;
+    ProfiledGraphicsView* gameView;
     SugarOilGameSceneNew* gameScene;
     
     // 控制面板
@@ -1,8 +1,16 @@
 #include "sugar_oil_player.h"
+#include "item_system.h"
+#include "creature_system.h"
+#include "../snapshot_io.h"
 #include <QPixmap>
 #include <QUrl>
 #include <QRandomGenerator>
 
+namespace
+{
+    const quint32 SNAPSHOT_TAG = 0x52594c50; // "PLYR"
+}
+
 SugarOilPlayer::SugarOilPlayer(QObject *parent)
     : GameObjectBase(parent)
     , mHP(100)
@@ -16,95 +24,30 @@ SugarOilPlayer::SugarOilPlayer(QObject *parent)
     , mFaceRight(true)
     , mInvincible(false)
     , mIsMoving(false)
-    , mAnimationFrame(0)
-    , mInvincibilityTimer(nullptr)
-    , mAnimationTimer(nullptr)
-    , mSpeedEffectTimer(nullptr)
-    , mAttackEffectTimer(nullptr)
-    , mDefenseEffectTimer(nullptr)
-    , mFastShootingTimer(nullptr)
-    , mMagnetismTimer(nullptr)
-    , mExperienceEffectTimer(nullptr)
-    , mSpeedMultiplier(1.0)
-    , mAttackMultiplier(1.0)
-    , mDefenseMultiplier(1.0)
-    , mExperienceMultiplier(1.0)
-    , mFastShootingEnabled(false)
-    , mMagnetismEnabled(false)
-
-
-    , mBlinkAnimation(nullptr)
+    , mInvincibleUntil(0)
+    , mRegenAccumulator(0.0)
+    , mBlinking(false)
+    , mBlinkUntil(0)
 {
-    // 设置初始图像
-    setPixmap(QPixmap(":/img/roles/usagi1.png"));
+    // 设置初始图像，行走动画由场景按游戏时钟推进
+    updatePixmap();
     setScale(0.15);
     setZValue(10); // 确保玩家在最上层
     
-    // 初始化定时器
-    mInvincibilityTimer = new QTimer(this);
-    mInvincibilityTimer->setSingleShot(true);
-    connect(mInvincibilityTimer, &QTimer::timeout, this, &SugarOilPlayer::onInvincibilityTimeout);
-    
-    mAnimationTimer = new QTimer(this);
-    mAnimationTimer->setInterval(ANIMATION_INTERVAL);
-    connect(mAnimationTimer, &QTimer::timeout, this, &SugarOilPlayer::onAnimationTimeout);
-    mAnimationTimer->start();
-    
-    // 初始化效果定时器
-    mSpeedEffectTimer = new QTimer(this);
-    mSpeedEffectTimer->setSingleShot(true);
-    connect(mSpeedEffectTimer, &QTimer::timeout, [this]() { mSpeedMultiplier = 1.0; });
-    
-    mAttackEffectTimer = new QTimer(this);
-    mAttackEffectTimer->setSingleShot(true);
-    connect(mAttackEffectTimer, &QTimer::timeout, [this]() { mAttackMultiplier = 1.0; });
-    
-    mDefenseEffectTimer = new QTimer(this);
-    mDefenseEffectTimer->setSingleShot(true);
-    connect(mDefenseEffectTimer, &QTimer::timeout, [this]() { mDefenseMultiplier = 1.0; });
-    
-    mFastShootingTimer = new QTimer(this);
-    mFastShootingTimer->setSingleShot(true);
-    connect(mFastShootingTimer, &QTimer::timeout, [this]() { mFastShootingEnabled = false; });
-    
-    mMagnetismTimer = new QTimer(this);
-    mMagnetismTimer->setSingleShot(true);
-    connect(mMagnetismTimer, &QTimer::timeout, [this]() { mMagnetismEnabled = false; });
-    
-    mExperienceEffectTimer = new QTimer(this);
-    mExperienceEffectTimer->setSingleShot(true);
-    connect(mExperienceEffectTimer, &QTimer::timeout, [this]() { mExperienceMultiplier = 1.0; });
-    
     // 音效播放现在由AudioManager统一管理
-    
-    // 初始化闪烁动画
-    mBlinkAnimation = new QPropertyAnimation(this, "opacity", this);
-    mBlinkAnimation->setDuration(100);
-    mBlinkAnimation->setStartValue(1.0);
-    mBlinkAnimation->setEndValue(0.3);
-    mBlinkAnimation->setLoopCount(5);
 }
 
 SugarOilPlayer::~SugarOilPlayer()
 {
-    if (mInvincibilityTimer) {
-        mInvincibilityTimer->stop();
-    }
-    if (mAnimationTimer) {
-        mAnimationTimer->stop();
-    }
-    if (mBlinkAnimation) {
-        mBlinkAnimation->stop();
-    }
 }
 
 void SugarOilPlayer::takeDamage(int damage)
 {
-    if (mInvincible) {
+    if (isInvincible()) {
         return;
     }
     
-    int effectiveDefense = static_cast<int>(mDefence * mDefenseMultiplier);
+    int effectiveDefense = static_cast<int>(mDefence * mEffects.getValue(EffectStat::Defense));
     int actualDamage = qMax(1, damage - effectiveDefense);
     mHP = qMax(0, mHP - actualDamage);
     
@@ -114,10 +57,9 @@ void SugarOilPlayer::takeDamage(int damage)
     // 设置无敌状态
     setInvincible(true);
     
-    // 播放闪烁动画
-    if (mBlinkAnimation) {
-        mBlinkAnimation->start();
-    }
+    // 开始闪烁，透明度由updateEffects()按游戏时间推进
+    mBlinking = true;
+    mBlinkUntil = mEffects.getNow() + BLINK_DURATION;
     
     emit healthChanged(mHP, mMaxHP);
     
@@ -134,7 +76,7 @@ void SugarOilPlayer::heal(int amount)
 
 void SugarOilPlayer::gainExp(int exp)
 {
-    int effectiveExp = static_cast<int>(exp * mExperienceMultiplier);
+    int effectiveExp = static_cast<int>(exp * mEffects.getValue(EffectStat::Experience));
     mExp += effectiveExp;
     emit expChanged(mExp, EXP_PER_LEVEL);
     checkLevelUp();
@@ -146,7 +88,7 @@ void SugarOilPlayer::shoot(const QPointF &direction)
     AudioManager::getInstance()->playSound(AudioManager::SoundType::PlayerAttack);
     
     // 计算有效攻击力
-    int effectiveAttack = static_cast<int>(mAttackPoint * mAttackMultiplier);
+    int effectiveAttack = static_cast<int>(mAttackPoint * mEffects.getValue(EffectStat::Attack));
     
     // 发射子弹信号
     emit playerShoot(getCenterPos(), direction, effectiveAttack);
@@ -157,48 +99,125 @@ void SugarOilPlayer::setInvincible(bool invincible)
     mInvincible = invincible;
     
     if (invincible) {
-        mInvincibilityTimer->start(INVINCIBILITY_DURATION);
+        mInvincibleUntil = mEffects.getNow() + INVINCIBILITY_DURATION;
     } else {
-        mInvincibilityTimer->stop();
         setOpacity(1.0);
     }
 }
 
-// 道具效果方法
+// 限时效果
+void SugarOilPlayer::updateEffects(qint64 gameTimeMs)
+{
+    const qint64 elapsed = gameTimeMs - mEffects.getNow();
+    mEffects.advanceTo(gameTimeMs);
+    
+    // 受伤无敌到期
+    if (mInvincible && gameTimeMs >= mInvincibleUntil) {
+        setInvincible(false);
+    }
+    
+    // 受伤闪烁：每个周期内透明度从1.0线性降到0.3，结束后恢复不透明
+    if (mBlinking) {
+        const qint64 remaining = mBlinkUntil - gameTimeMs;
+        if (remaining <= 0) {
+            mBlinking = false;
+            setOpacity(1.0);
+        } else {
+            const qint64 phase = (BLINK_DURATION - remaining) % BLINK_PERIOD;
+            setOpacity(1.0 - BLINK_OPACITY_DROP * phase / BLINK_PERIOD);
+        }
+    }
+    
+    // 持续生命恢复，按游戏时间累计，不足1点的部分留到下一帧
+    const double regenPerSecond = mEffects.getValue(EffectStat::HealthRegen);
+    if (regenPerSecond > 0.0 && elapsed > 0 && mHP > 0 && mHP < mMaxHP) {
+        mRegenAccumulator += regenPerSecond * elapsed / 1000.0;
+        const int amount = static_cast<int>(mRegenAccumulator);
+        if (amount > 0) {
+            mRegenAccumulator -= amount;
+            heal(amount);
+        }
+    } else if (regenPerSecond <= 0.0) {
+        mRegenAccumulator = 0.0;
+    }
+}
+
+void SugarOilPlayer::applyItemEffect(const ItemEffect &effect, int sourceKey)
+{
+    // 重复拾取同一种道具时延长持续时间，不同道具的加成相互叠加
+    const EffectStackRule rule = EffectStackRule::Extend;
+    if (effect.speedMultiplier != 1.0f) {
+        mEffects.apply(EffectStat::Speed, effect.speedMultiplier, effect.duration, rule, sourceKey);
+    }
+    if (effect.attackMultiplier != 1.0f) {
+        mEffects.apply(EffectStat::Attack, effect.attackMultiplier, effect.duration, rule, sourceKey);
+    }
+    if (effect.defenseMultiplier != 1.0f) {
+        mEffects.apply(EffectStat::Defense, effect.defenseMultiplier, effect.duration, rule, sourceKey);
+    }
+    if (effect.invincible) {
+        mEffects.apply(EffectStat::Invincible, 1.0, effect.duration, rule, sourceKey);
+    }
+    if (effect.rapidFire) {
+        mEffects.apply(EffectStat::FastShooting, 1.0, effect.duration, rule, sourceKey);
+    }
+    if (effect.magnetPower) {
+        mEffects.apply(EffectStat::Magnetism, 1.0, effect.duration, rule, sourceKey);
+    }
+}
+
+void SugarOilPlayer::applyCreatureEffect(const CreatureEffect &effect, int sourceKey)
+{
+    // 生物在玩家身边时会持续触发，只刷新持续时间，不会无限延长
+    // 生物的来源键与道具错开，避免相互覆盖
+    const EffectStackRule rule = EffectStackRule::Refresh;
+    const int key = CREATURE_EFFECT_KEY_BASE + sourceKey;
+    if (effect.speedBonus > 0.0f) {
+        mEffects.apply(EffectStat::Speed, 1.0 + effect.speedBonus, effect.duration, rule, key);
+    }
+    if (effect.attackBonus > 0.0f) {
+        mEffects.apply(EffectStat::Attack, 1.0 + effect.attackBonus, effect.duration, rule, key);
+    }
+    if (effect.defenseBonus > 0.0f) {
+        mEffects.apply(EffectStat::Defense, 1.0 + effect.defenseBonus, effect.duration, rule, key);
+    }
+    if (effect.expBonus != 1.0f) {
+        mEffects.apply(EffectStat::Experience, effect.expBonus, effect.duration, rule, key);
+    }
+    if (effect.healthRegen > 0) {
+        mEffects.apply(EffectStat::HealthRegen, effect.healthRegen, effect.duration, rule, key);
+    }
+}
+
+// 道具效果方法（单一来源，重复施加时覆盖旧效果）
 void SugarOilPlayer::applySpeedMultiplier(double multiplier, int duration)
 {
-    mSpeedMultiplier = multiplier;
-    mSpeedEffectTimer->start(duration);
+    mEffects.apply(EffectStat::Speed, multiplier, duration, EffectStackRule::Refresh, DIRECT_EFFECT_KEY);
 }
 
 void SugarOilPlayer::applyAttackMultiplier(double multiplier, int duration)
 {
-    mAttackMultiplier = multiplier;
-    mAttackEffectTimer->start(duration);
+    mEffects.apply(EffectStat::Attack, multiplier, duration, EffectStackRule::Refresh, DIRECT_EFFECT_KEY);
 }
 
 void SugarOilPlayer::applyDefenseMultiplier(double multiplier, int duration)
 {
-    mDefenseMultiplier = multiplier;
-    mDefenseEffectTimer->start(duration);
+    mEffects.apply(EffectStat::Defense, multiplier, duration, EffectStackRule::Refresh, DIRECT_EFFECT_KEY);
 }
 
 void SugarOilPlayer::enableFastShooting(int duration)
 {
-    mFastShootingEnabled = true;
-    mFastShootingTimer->start(duration);
+    mEffects.apply(EffectStat::FastShooting, 1.0, duration, EffectStackRule::Refresh, DIRECT_EFFECT_KEY);
 }
 
 void SugarOilPlayer::enableMagnetism(int duration)
 {
-    mMagnetismEnabled = true;
-    mMagnetismTimer->start(duration);
+    mEffects.apply(EffectStat::Magnetism, 1.0, duration, EffectStackRule::Refresh, DIRECT_EFFECT_KEY);
 }
 
 void SugarOilPlayer::applyExperienceMultiplier(double multiplier, int duration)
 {
-    mExperienceMultiplier = multiplier;
-    mExperienceEffectTimer->start(duration);
+    mEffects.apply(EffectStat::Experience, multiplier, duration, EffectStackRule::Refresh, DIRECT_EFFECT_KEY);
 }
 
 void SugarOilPlayer::resetPlayer()
@@ -208,47 +227,17 @@ void SugarOilPlayer::resetPlayer()
     mExp = 0;
     mScore = 0;
     mInvincible = false;
+    mInvincibleUntil = 0;
     mIsMoving = false;
-    mAnimationFrame = 0;
+    mBlinking = false;
     
     // 重置所有效果
-    mSpeedMultiplier = 1.0;
-    mAttackMultiplier = 1.0;
-    mDefenseMultiplier = 1.0;
-    mExperienceMultiplier = 1.0;
-    mFastShootingEnabled = false;
-    mMagnetismEnabled = false;
+    mEffects.clear();
+    mRegenAccumulator = 0.0;
     
     setOpacity(1.0);
     setPosition(400, 300); // 重置到中心位置
     
-    if (mInvincibilityTimer) {
-        mInvincibilityTimer->stop();
-    }
-    if (mBlinkAnimation) {
-        mBlinkAnimation->stop();
-    }
-    
-    // 停止所有效果定时器
-    if (mSpeedEffectTimer && mSpeedEffectTimer->isActive()) {
-        mSpeedEffectTimer->stop();
-    }
-    if (mAttackEffectTimer && mAttackEffectTimer->isActive()) {
-        mAttackEffectTimer->stop();
-    }
-    if (mDefenseEffectTimer && mDefenseEffectTimer->isActive()) {
-        mDefenseEffectTimer->stop();
-    }
-    if (mFastShootingTimer && mFastShootingTimer->isActive()) {
-        mFastShootingTimer->stop();
-    }
-    if (mMagnetismTimer && mMagnetismTimer->isActive()) {
-        mMagnetismTimer->stop();
-    }
-    if (mExperienceEffectTimer && mExperienceEffectTimer->isActive()) {
-        mExperienceEffectTimer->stop();
-    }
-    
     updatePixmap();
     
     emit healthChanged(mHP, mMaxHP);
@@ -256,44 +245,88 @@ void SugarOilPlayer::resetPlayer()
     emit scoreChanged(mScore);
 }
 
-void SugarOilPlayer::updateAnimation()
+void SugarOilPlayer::saveState(SnapshotWriter &writer) const
 {
-    if (mIsMoving) {
-        mAnimationFrame = (mAnimationFrame + 1) % 3; // 3帧动画
-    } else {
-        mAnimationFrame = 0; // 静止状态
-    }
-    updatePixmap();
+    SavedState state;
+    state.x = pos().x();
+    state.y = pos().y();
+    state.speed = mSpeed;
+    state.regenAccumulator = mRegenAccumulator;
+    state.invincibleUntil = mInvincibleUntil;
+    state.hp = mHP;
+    state.maxHp = mMaxHP;
+    state.attackPoint = mAttackPoint;
+    state.defence = mDefence;
+    state.level = mLevel;
+    state.exp = mExp;
+    state.score = mScore;
+    state.faceRight = mFaceRight;
+    state.invincible = mInvincible;
+    state.reserved[0] = 0;
+    state.reserved[1] = 0;
+    
+    writer.beginSection(SNAPSHOT_TAG);
+    writer.write(state);
+    mEffects.saveState(writer);
 }
 
-void SugarOilPlayer::onInvincibilityTimeout()
+bool SugarOilPlayer::readState(SnapshotReader &reader, SavedState &state, EffectScheduler &effects)
 {
-    setInvincible(false);
+    return reader.expectSection(SNAPSHOT_TAG) && reader.read(state) && effects.restoreState(reader);
 }
 
-void SugarOilPlayer::onAnimationTimeout()
+void SugarOilPlayer::restoreState(const SavedState &state, const EffectScheduler &effects)
 {
-    updateAnimation();
+    mEffects = effects;
+    setPos(state.x, state.y);
+    mSpeed = state.speed;
+    mRegenAccumulator = state.regenAccumulator;
+    mInvincibleUntil = state.invincibleUntil;
+    mHP = state.hp;
+    mMaxHP = state.maxHp;
+    mAttackPoint = state.attackPoint;
+    mDefence = state.defence;
+    mLevel = state.level;
+    mExp = state.exp;
+    mScore = state.score;
+    mFaceRight = state.faceRight;
+    mInvincible = state.invincible;
+    mIsMoving = false;
+    mBlinking = false;
+    
+    setOpacity(1.0);
+    updatePixmap();
+    
+    emit healthChanged(mHP, mMaxHP);
+    emit expChanged(mExp, EXP_PER_LEVEL);
+    emit scoreChanged(mScore);
 }
 
 void SugarOilPlayer::updatePixmap()
 {
-    QString imagePath;
-    
-    // 根据动画帧和朝向选择图像
-    if (mFaceRight) {
-        imagePath = QString(":/img/roles/usagi%1.png").arg(mAnimationFrame + 1);
-    } else {
-        imagePath = QString(":/img/roles/usagi%1_left.png").arg(mAnimationFrame + 1);
-    }
-    
-    QPixmap pixmap(imagePath);
-    if (!pixmap.isNull()) {
-        setPixmap(pixmap);
-    } else {
-        // 如果找不到特定图像，使用默认图像
-        setPixmap(QPixmap(":/img/roles/usagi1.png"));
-    }
+    playClip(getClip(mFaceRight, mIsMoving));
+}
+
+ClipId SugarOilPlayer::getClip(bool faceRight, bool moving)
+{
+    // 四个片段所有玩家实例共用，第一次用到时注册；朝左用镜像图
+    static const ClipId clips[2][2] = {
+        {
+            AnimationClips::getInstance()->registerClip("usagi/idle_left",
+                { ":/img/roles/usagi1-mir.png" }, 0),
+            AnimationClips::getInstance()->registerClip("usagi/walk_left",
+                { ":/img/roles/usagi1-mir.png", ":/img/roles/usagi2-mir.png", ":/img/roles/usagi3-mir.png" },
+                ANIMATION_INTERVAL)
+        },
+        {
+            AnimationClips::getInstance()->registerClip("usagi/idle_right",
+                { ":/img/roles/usagi1.png" }, 0),
+            AnimationClips::getInstance()->registerClip("usagi/walk_right",
+                { ":/img/roles/usagi1.png", ":/img/roles/usagi2.png", ":/img/roles/usagi3.png" },
+                ANIMATION_INTERVAL)
+        }
+    };
+    return clips[faceRight ? 1 : 0][moving ? 1 : 0];
 }
 
 void SugarOilPlayer::checkLevelUp()
@@ -316,55 +349,10 @@ void SugarOilPlayer::checkLevelUp()
 
 void SugarOilPlayer::pauseAllTimers()
 {
-    // 暂停无敌定时器
-    if (mInvincibilityTimer && mInvincibilityTimer->isActive()) {
-        mInvincibilityTimer->stop();
-    }
-    
-    // 暂停动画定时器
-    if (mAnimationTimer && mAnimationTimer->isActive()) {
-        mAnimationTimer->stop();
-    }
-    
-    // 暂停所有效果定时器
-    if (mSpeedEffectTimer && mSpeedEffectTimer->isActive()) {
-        mSpeedEffectTimer->stop();
-    }
-    if (mAttackEffectTimer && mAttackEffectTimer->isActive()) {
-        mAttackEffectTimer->stop();
-    }
-    if (mDefenseEffectTimer && mDefenseEffectTimer->isActive()) {
-        mDefenseEffectTimer->stop();
-    }
-    if (mFastShootingTimer && mFastShootingTimer->isActive()) {
-        mFastShootingTimer->stop();
-    }
-    if (mMagnetismTimer && mMagnetismTimer->isActive()) {
-        mMagnetismTimer->stop();
-    }
-    if (mExperienceEffectTimer && mExperienceEffectTimer->isActive()) {
-        mExperienceEffectTimer->stop();
-    }
-    
-    // 暂停闪烁动画
-    if (mBlinkAnimation && mBlinkAnimation->state() == QAbstractAnimation::Running) {
-        mBlinkAnimation->pause();
-    }
+    // 帧动画、限时效果和受伤闪烁都跑在游戏时钟上，暂停期间时钟不前进，无需单独处理
 }
 
 void SugarOilPlayer::resumeAllTimers()
 {
-    // 恢复动画定时器（这个应该始终运行）
-    if (mAnimationTimer && !mAnimationTimer->isActive()) {
-        mAnimationTimer->start();
-    }
-    
-    // 其他定时器根据状态恢复
-    // 无敌定时器和效果定时器通常是单次触发，不需要自动恢复
-    // 它们会在相应的事件触发时重新启动
-    
-    // 恢复闪烁动画
-    if (mBlinkAnimation && mBlinkAnimation->state() == QAbstractAnimation::Paused) {
-        mBlinkAnimation->resume();
-    }
+    // 帧动画、受伤无敌和闪烁跟随游戏时钟，不需要单独恢复
 }
\ No newline at end of file
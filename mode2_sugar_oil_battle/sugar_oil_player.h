@@ -2,9 +2,14 @@
 #define SUGAR_OIL_PLAYER_H
 
 #include "game_object_base.h"
+#include "effect_scheduler.h"
 #include <QTimer>
 #include "../audio_manager.h"
-#include <QPropertyAnimation>
+
+struct ItemEffect;
+struct CreatureEffect;
+class SnapshotWriter;
+class SnapshotReader;
 
 class SugarOilPlayer : public GameObjectBase
 {
@@ -19,7 +24,7 @@ public:
     // 基础属性获取
     int getHP() const { return mHP; }
     int getMaxHP() const { return mMaxHP; }
-    qreal getSpeed() const { return mSpeed; }
+    qreal getSpeed() const { return mSpeed * mEffects.getValue(EffectStat::Speed); }
     int getAttackPoint() const { return mAttackPoint; }
     int getDefence() const { return mDefence; }
     int getLevel() const { return mLevel; }
@@ -41,7 +46,17 @@ public:
     
     // 状态效果
     void setInvincible(bool invincible);
-    bool isInvincible() const { return mInvincible; }
+    bool isInvincible() const { return mInvincible || mEffects.isActive(EffectStat::Invincible); }
+    
+    // 限时效果（由游戏时钟驱动，暂停时自动停止计时）
+    void updateEffects(qint64 gameTimeMs);
+    const EffectScheduler& getEffects() const { return mEffects; }
+    bool isFastShootingEnabled() const { return mEffects.isActive(EffectStat::FastShooting); }
+    bool isMagnetismEnabled() const { return mEffects.isActive(EffectStat::Magnetism); }
+    
+    // 道具/生物效果，sourceKey为道具或生物类型
+    void applyItemEffect(const ItemEffect &effect, int sourceKey);
+    void applyCreatureEffect(const CreatureEffect &effect, int sourceKey);
     
     // 道具效果支持
     void applySpeedMultiplier(double multiplier, int duration);
@@ -56,12 +71,33 @@ public:
     // 重置功能
     void resetPlayer();
     
-    // 更新动画帧
-    void updateAnimation();
-    
-    // 移动控制
-    void startMoving() { mIsMoving = true; }
-    void stopMoving() { mIsMoving = false; }
+    // 快照：属性、位置、受伤无敌和所有限时效果
+    // 读档分两步：readState()只读进调用方的临时变量，整份快照校验通过后再用restoreState()写入玩家
+    struct SavedState {
+        qreal x;
+        qreal y;
+        qreal speed;
+        double regenAccumulator;
+        qint64 invincibleUntil;
+        qint32 hp;
+        qint32 maxHp;
+        qint32 attackPoint;
+        qint32 defence;
+        qint32 level;
+        qint32 exp;
+        qint32 score;
+        quint8 faceRight;
+        quint8 invincible;
+        quint8 reserved[2];
+    };
+    
+    void saveState(SnapshotWriter &writer) const;
+    static bool readState(SnapshotReader &reader, SavedState &state, EffectScheduler &effects);
+    void restoreState(const SavedState &state, const EffectScheduler &effects);
+    
+    // 移动控制，同时切换行走/静止的动画片段
+    void startMoving() { mIsMoving = true; updatePixmap(); }
+    void stopMoving() { mIsMoving = false; updatePixmap(); }
     bool isMoving() const { return mIsMoving; }
     
     // 暂停/恢复所有定时器（用于游戏暂停）
@@ -76,12 +112,10 @@ signals:
     void playerDied();
     void playerShoot(QPointF position, QPointF direction, int damage);
 
-public slots:
-    void onInvincibilityTimeout();
-    void onAnimationTimeout();
-
 protected:
+    // 按朝向和是否移动选择片段，帧由场景统一推进
     void updatePixmap();
+    static ClipId getClip(bool faceRight, bool moving);
     void checkLevelUp();
     
 private:
@@ -99,37 +133,29 @@ private:
     bool mFaceRight;
     bool mInvincible;
     bool mIsMoving;
-    int mAnimationFrame;
-    
-    // 定时器
-    QTimer* mInvincibilityTimer;
-    QTimer* mAnimationTimer;
-    
-    // 效果定时器
-    QTimer* mSpeedEffectTimer;
-    QTimer* mAttackEffectTimer;
-    QTimer* mDefenseEffectTimer;
-    QTimer* mFastShootingTimer;
-    QTimer* mMagnetismTimer;
-    QTimer* mExperienceEffectTimer;
-    
-    // 效果倍数
-    double mSpeedMultiplier;
-    double mAttackMultiplier;
-    double mDefenseMultiplier;
-    double mExperienceMultiplier;
-    bool mFastShootingEnabled;
-    bool mMagnetismEnabled;
+    
+    // 受伤后的无敌在游戏时钟上计时，到期由updateEffects()解除
+    qint64 mInvincibleUntil;
+    
+    // 限时效果（替代原来每种效果一个QTimer）
+    EffectScheduler mEffects;
+    double mRegenAccumulator; // 生命恢复的小数部分
     
     // 音效现在由AudioManager统一管理
     
-    // 动画相关
-    QPropertyAnimation* mBlinkAnimation;
+    // 受伤闪烁，和无敌一样在游戏时钟上计时
+    bool mBlinking;
+    qint64 mBlinkUntil;
     
     // 常量
     static const int INVINCIBILITY_DURATION = 1000; // 1秒无敌时间
-    static const int ANIMATION_INTERVAL = 200; // 动画帧间隔
+    static const int BLINK_PERIOD = 100; // 闪烁一个周期的时长
+    static const int BLINK_DURATION = 5 * BLINK_PERIOD; // 受伤后闪烁5次
+    static constexpr qreal BLINK_OPACITY_DROP = 0.7; // 每个周期内透明度从1.0降到0.3
+    static const int ANIMATION_INTERVAL = 200; // 行走动画每帧时长（游戏时间）
     static const int EXP_PER_LEVEL = 100; // 每级所需经验
+    static const int DIRECT_EFFECT_KEY = -1; // applyXxx接口直接施加的效果
+    static const int CREATURE_EFFECT_KEY_BASE = 1000; // 生物效果来源键偏移
 };
 
 #endif // SUGAR_OIL_PLAYER_H
\ No newline at end of file
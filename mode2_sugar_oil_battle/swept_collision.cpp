@@ -0,0 +1,72 @@
+#include "swept_collision.h"
+#include <QtMath>
+
+bool SweptCollision::sweepCircleCircle(const QPointF &start, const QPointF &end, qreal movingRadius,
+                                       const QPointF &center, qreal targetRadius, qreal *outT)
+{
+    // 等价于线段与半径之和的圆求交：|start + t*d - center| = r
+    const qreal r = movingRadius + targetRadius;
+    const QPointF d = end - start;
+    const QPointF m = start - center;
+    const qreal c = QPointF::dotProduct(m, m) - r * r;
+
+    // 起点已经重叠
+    if (c <= 0.0) {
+        if (outT) *outT = 0.0;
+        return true;
+    }
+
+    const qreal a = QPointF::dotProduct(d, d);
+    const qreal b = QPointF::dotProduct(m, d);
+    // 没有移动，或正在远离目标
+    if (a <= 0.0 || b >= 0.0) {
+        return false;
+    }
+
+    const qreal discr = b * b - a * c;
+    if (discr < 0.0) {
+        return false;
+    }
+
+    const qreal t = (-b - qSqrt(discr)) / a;
+    if (t > 1.0) {
+        return false;
+    }
+    if (outT) *outT = qMax<qreal>(0.0, t);
+    return true;
+}
+
+bool SweptCollision::sweepSegmentRect(const QPointF &start, const QPointF &end,
+                                      const QRectF &rect, qreal *outT)
+{
+    qreal tMin = 0.0;
+    qreal tMax = 1.0;
+    const qreal origin[2] = { start.x(), start.y() };
+    const qreal dir[2] = { end.x() - start.x(), end.y() - start.y() };
+    const qreal lo[2] = { rect.left(), rect.top() };
+    const qreal hi[2] = { rect.right(), rect.bottom() };
+
+    for (int axis = 0; axis < 2; ++axis) {
+        if (qFuzzyIsNull(dir[axis])) {
+            // 与该轴平行，起点必须在slab内
+            if (origin[axis] < lo[axis] || origin[axis] > hi[axis]) {
+                return false;
+            }
+            continue;
+        }
+        const qreal inv = 1.0 / dir[axis];
+        qreal t1 = (lo[axis] - origin[axis]) * inv;
+        qreal t2 = (hi[axis] - origin[axis]) * inv;
+        if (t1 > t2) {
+            qSwap(t1, t2);
+        }
+        tMin = qMax(tMin, t1);
+        tMax = qMin(tMax, t2);
+        if (tMin > tMax) {
+            return false;
+        }
+    }
+
+    if (outT) *outT = tMin;
+    return true;
+}
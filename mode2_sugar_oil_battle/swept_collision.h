@@ -0,0 +1,24 @@
+#ifndef SWEPT_COLLISION_H
+#define SWEPT_COLLISION_H
+
+#include <QPointF>
+#include <QRectF>
+
+// 连续碰撞检测
+// 用物体上一次检测时的位置到当前位置的线段做扫掠测试，
+// 无论单步移动多远都不会穿过目标，子弹速度与更新频率因此互不影响
+class SweptCollision
+{
+public:
+    // 半径为movingRadius的圆从start移动到end，与圆心center、半径targetRadius的静止圆求交
+    // 相交时返回true，并在outT中给出最早碰撞时刻（0表示起点，1表示终点）
+    static bool sweepCircleCircle(const QPointF &start, const QPointF &end, qreal movingRadius,
+                                  const QPointF &center, qreal targetRadius, qreal *outT);
+
+    // 线段start->end与矩形rect求交（slab法），outT同上
+    // 需要考虑移动物体大小时，由调用方先把rect按半径外扩
+    static bool sweepSegmentRect(const QPointF &start, const QPointF &end,
+                                 const QRectF &rect, qreal *outT);
+};
+
+#endif // SWEPT_COLLISION_H
@@ -39,12 +39,10 @@ UsagiPlayer::UsagiPlayer(QObject *parent)
     , animationFrame(0)
     , animationDirection(1)
     , currentAnimationFrame(0)
+    , currentClip(AnimationClips::INVALID_CLIP)
 {
-    // 加载玩家图片
-    loadPlayerImages();
-    
     // 设置初始图片
-    setPixmap(playerImages["idle"]);
+    showPose(PoseIdle);
     setScale(0.15);  // 缩小角色尺寸
     
     // 设置变换原点为中心
@@ -70,23 +68,39 @@ UsagiPlayer::~UsagiPlayer()
     if (blinkTimer) blinkTimer->stop();
 }
 
-void UsagiPlayer::loadPlayerImages()
-{
-    // 加载不同状态的玩家图片 - 修正资源路径
-    playerImages["idle"] = QPixmap(":/img/roles/usagi1.png");
-    playerImages["move_up"] = QPixmap(":/img/roles/usagi2.png");
-    playerImages["move_down"] = QPixmap(":/img/roles/usagi3.png");
-    playerImages["move_left"] = QPixmap(":/img/roles/usagi1-mir.png");
-    playerImages["move_right"] = QPixmap(":/img/roles/usagi1.png");
-    playerImages["damaged"] = QPixmap(":/img/roles/usagi2.png");
-    playerImages["shield"] = QPixmap(":/img/roles/usagi3.png");
-    playerImages["invincible"] = QPixmap(":/img/roles/usagi1-invincible.png");
-    
-    // 如果图片加载失败，创建默认图片
-    for (auto it = playerImages.begin(); it != playerImages.end(); ++it) {
-        if (it.value().isNull()) {
-            it.value() = createDefaultPixmap(USAGI_SIZE, USAGI_SIZE, QColor(255, 192, 203)); // 粉色
+ClipId UsagiPlayer::getClip(Pose pose)
+{
+    // 不同状态的玩家图片，所有实例共用，第一次用到时注册
+    static const QVector<ClipId> clips = []() {
+        const char* const paths[PoseCount] = {
+            ":/img/roles/usagi1.png",            // 静止
+            ":/img/roles/usagi2.png",            // 向上
+            ":/img/roles/usagi3.png",            // 向下
+            ":/img/roles/usagi1-mir.png",        // 向左
+            ":/img/roles/usagi1.png",            // 向右
+            ":/img/roles/usagi2.png",            // 受伤
+            ":/img/roles/usagi3.png",            // 护盾
+            ":/img/roles/usagi1-invincible.png"  // 无敌
+        };
+        // 如果图片加载失败，使用默认图片
+        QPixmap fallback(USAGI_SIZE, USAGI_SIZE);
+        fallback.fill(QColor(255, 192, 203)); // 粉色
+        QVector<ClipId> ids;
+        for (int i = 0; i < PoseCount; ++i) {
+            ids.append(AnimationClips::getInstance()->registerClip(
+                QString("usagi_player/pose%1").arg(i), { QString::fromLatin1(paths[i]) }, 0, fallback));
         }
+        return ids;
+    }();
+    return clips[pose];
+}
+
+void UsagiPlayer::showPose(Pose pose)
+{
+    const ClipId clip = getClip(pose);
+    if (clip != currentClip) {
+        currentClip = clip;
+        setPixmap(AnimationClips::getInstance()->getFrame(clip, 0));
     }
 }
 
@@ -390,33 +404,33 @@ void UsagiPlayer::setSpeedMultiplier(float multiplier)
 
 void UsagiPlayer::updateSprite()
 {
-    QString imageKey = "idle";
+    Pose pose = PoseIdle;
     
     if (invincible) {
-        imageKey = "invincible";
+        pose = PoseInvincible;
     } else if (shieldActive) {
-        imageKey = "shield";
+        pose = PoseShield;
     } else if (isMoving) {
         switch (currentDirection) {
         case SUGAR_OIL_DIR_UP:
-            imageKey = "move_up";
+            pose = PoseMoveUp;
             break;
         case SUGAR_OIL_DIR_DOWN:
-            imageKey = "move_down";
+            pose = PoseMoveDown;
             break;
         case SUGAR_OIL_DIR_LEFT:
-            imageKey = "move_left";
+            pose = PoseMoveLeft;
             break;
         case SUGAR_OIL_DIR_RIGHT:
-            imageKey = "move_right";
+            pose = PoseMoveRight;
             break;
         default:
-            imageKey = "idle";
+            pose = PoseIdle;
             break;
         }
     }
     
-    setPixmap(playerImages[imageKey]);
+    showPose(pose);
 }
 
 void UsagiPlayer::startIdleAnimation()
@@ -8,8 +8,8 @@
 #include <QPixmap>
 #include <QPropertyAnimation>
 #include <QGraphicsEffect>
-#include <QMap>
 #include "sugar_oil_config.h"
+#include "animation_clips.h"
 
 class UsagiPlayer : public QObject, public QGraphicsPixmapItem
 {
@@ -115,7 +115,6 @@ private slots:
     void startBlinking();
     void stopBlinking();
     void updateBlinking();
-    void loadPlayerImages();
     QPixmap createDefaultPixmap(int width, int height, const QColor& color);
     
 private:
@@ -163,9 +162,22 @@ private:
     int animationFrame;
     int animationDirection;
     int currentAnimationFrame;
-    QList<QPixmap> sprites;
-    QList<QPixmap> invincibleSprites;
-    QMap<QString, QPixmap> playerImages;
+    
+    // 各状态的图像是共享片段表中的单帧片段，这里只记当前片段
+    enum Pose {
+        PoseIdle,
+        PoseMoveUp,
+        PoseMoveDown,
+        PoseMoveLeft,
+        PoseMoveRight,
+        PoseDamaged,
+        PoseShield,
+        PoseInvincible,
+        PoseCount
+    };
+    static ClipId getClip(Pose pose);
+    void showPose(Pose pose);
+    ClipId currentClip;
     
     // 视觉效果
     QPropertyAnimation* damageAnimation;
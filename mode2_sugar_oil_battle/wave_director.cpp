@@ -0,0 +1,281 @@
+#include "wave_director.h"
+#include "../snapshot_io.h"
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QRandomGenerator>
+#include <QDebug>
+#include <QtMath>
+#include <algorithm>
+
+namespace
+{
+    const quint32 SNAPSHOT_TAG = 0x45564157; // "WAVE"
+
+    // 波次表中的敌人名称，按EnemyType的值下标
+    const char* const ENEMY_TYPE_NAMES[WaveDirector::ENEMY_TYPE_COUNT] = {
+        "FriedChicken", "Barbecue", "MilkTea", "SpiralShellNoodles", "SmallCake"
+    };
+
+    SpawnFormation parseFormation(const QString &name)
+    {
+        if (name == "line") {
+            return SpawnFormation::Line;
+        }
+        if (name == "ring") {
+            return SpawnFormation::Ring;
+        }
+        if (name == "cluster") {
+            return SpawnFormation::Cluster;
+        }
+        return SpawnFormation::Random;
+    }
+
+    // 场景边缘外的一个点：0=上, 1=右, 2=下, 3=左
+    QPointF edgePoint(int edge, qreal t, const QRectF &rect, qreal offset)
+    {
+        switch (edge) {
+        case 0:
+            return QPointF(rect.left() + t * rect.width(), rect.top() - offset);
+        case 1:
+            return QPointF(rect.right() + offset, rect.top() + t * rect.height());
+        case 2:
+            return QPointF(rect.left() + t * rect.width(), rect.bottom() + offset);
+        default:
+            return QPointF(rect.left() - offset, rect.top() + t * rect.height());
+        }
+    }
+}
+
+WaveDirector::WaveDirector()
+    : mWaves(defaultWaves())
+    , mCurrentWave(0)
+    , mNextSpawnAt(0)
+    , mAverageFrameMs(FRAME_BUDGET_MS)
+    , mBackoff(1.0)
+    , mFrameSamples(0)
+    , mAutoBackoff(true)
+    , mRandom(QRandomGenerator::global())
+{
+}
+
+QVector<WaveEntry> WaveDirector::defaultWaves()
+{
+    // 与原先写死的节奏一致：每组1个随机敌人，间隔逐步缩短
+    const QVector<int> uniform(ENEMY_TYPE_COUNT, 1);
+    return {
+        {      0, 3000, 1, SpawnFormation::Random, 200, uniform },
+        {  60000, 2500, 1, SpawnFormation::Random, 200, uniform },
+        { 120000, 2000, 1, SpawnFormation::Random, 200, uniform },
+        { 180000, 1500, 1, SpawnFormation::Random, 200, uniform },
+        { 240000, 1200, 1, SpawnFormation::Random, 200, uniform }
+    };
+}
+
+bool WaveDirector::loadFromFile(const QString &path)
+{
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly)) {
+        qWarning() << "WaveDirector: cannot open" << path << "- using built-in waves";
+        return false;
+    }
+
+    QJsonParseError error;
+    const QJsonDocument document = QJsonDocument::fromJson(file.readAll(), &error);
+    if (error.error != QJsonParseError::NoError || !document.isObject()) {
+        qWarning() << "WaveDirector: invalid wave table" << path << error.errorString();
+        return false;
+    }
+
+    QVector<WaveEntry> waves;
+    const QJsonArray array = document.object().value("waves").toArray();
+    for (const QJsonValue &value : array) {
+        const QJsonObject object = value.toObject();
+        WaveEntry wave;
+        wave.startMs = static_cast<qint64>(object.value("time").toDouble() * 1000.0);
+        wave.intervalMs = qMax(100, object.value("interval").toInt(3000));
+        wave.groupSize = qMax(1, object.value("group").toInt(1));
+        wave.formation = parseFormation(object.value("formation").toString());
+        wave.maxAlive = qMax(1, object.value("maxAlive").toInt(200));
+
+        // 未列出的敌人权重为0；全部为0时退回均匀分布
+        wave.weights = QVector<int>(ENEMY_TYPE_COUNT, 0);
+        const QJsonObject composition = object.value("composition").toObject();
+        int total = 0;
+        for (int type = 0; type < ENEMY_TYPE_COUNT; ++type) {
+            wave.weights[type] = qMax(0, composition.value(ENEMY_TYPE_NAMES[type]).toInt(0));
+            total += wave.weights[type];
+        }
+        if (total == 0) {
+            wave.weights.fill(1);
+        }
+        waves.append(wave);
+    }
+
+    if (waves.isEmpty()) {
+        qWarning() << "WaveDirector: no waves in" << path << "- using built-in waves";
+        return false;
+    }
+
+    setWaves(waves);
+    return true;
+}
+
+void WaveDirector::setWaves(const QVector<WaveEntry> &waves)
+{
+    mWaves = waves;
+    std::stable_sort(mWaves.begin(), mWaves.end(), [](const WaveEntry &a, const WaveEntry &b) {
+        return a.startMs < b.startMs;
+    });
+    reset();
+}
+
+void WaveDirector::reset()
+{
+    mCurrentWave = 0;
+    mNextSpawnAt = mWaves.isEmpty() ? 0 : mWaves.first().startMs + mWaves.first().intervalMs;
+    mAverageFrameMs = FRAME_BUDGET_MS;
+    mBackoff = 1.0;
+    mFrameSamples = 0;
+}
+
+void WaveDirector::saveState(SnapshotWriter &writer) const
+{
+    writer.beginSection(SNAPSHOT_TAG);
+    writer.write(SavedState{ mCurrentWave, mFrameSamples, mNextSpawnAt, mAverageFrameMs, mBackoff });
+}
+
+bool WaveDirector::restoreState(SnapshotReader &reader)
+{
+    SavedState state;
+    if (!reader.expectSection(SNAPSHOT_TAG) || !reader.read(state)) {
+        return false;
+    }
+    // 波次表可能被改短，波次号按当前表截断
+    mCurrentWave = qBound(0, state.currentWave, qMax(0, mWaves.size() - 1));
+    mFrameSamples = qMax(0, state.frameSamples);
+    mNextSpawnAt = state.nextSpawnAt;
+    mAverageFrameMs = state.averageFrameMs;
+    setBackoff(state.backoff);
+    return true;
+}
+
+void WaveDirector::reportFrameTime(qreal frameMs)
+{
+    if (frameMs <= 0.0) {
+        return;
+    }
+    mAverageFrameMs += (frameMs - mAverageFrameMs) * FRAME_SMOOTHING;
+    ++mFrameSamples;
+}
+
+void WaveDirector::setBackoff(qreal backoff)
+{
+    mBackoff = qBound(1.0, backoff, MAX_BACKOFF);
+}
+
+void WaveDirector::updateBackoff()
+{
+    if (!mAutoBackoff || mFrameSamples < MIN_FRAME_SAMPLES) {
+        return;
+    }
+
+    // 每组生成时调整一次：超预算快速退避，恢复时缓慢回落，避免来回振荡
+    if (mAverageFrameMs > FRAME_BUDGET_MS * BUDGET_TOLERANCE) {
+        mBackoff = qMin(MAX_BACKOFF, mBackoff * 1.5);
+    } else if (mAverageFrameMs < FRAME_BUDGET_MS * RECOVER_RATIO * BUDGET_TOLERANCE) {
+        mBackoff = qMax(1.0, mBackoff * 0.8);
+    }
+    // 量化到百分之一，回放录像中记录的就是这个值
+    mBackoff = qRound(mBackoff * 100.0) / 100.0;
+}
+
+int WaveDirector::advance(qint64 nowMs, int aliveEnemies, const QRectF &sceneRect, QVector<WaveSpawn> &out)
+{
+    if (mWaves.isEmpty()) {
+        return 0;
+    }
+
+    // 切换到当前时间所在的波次
+    while (mCurrentWave + 1 < mWaves.size() && nowMs >= mWaves[mCurrentWave + 1].startMs) {
+        ++mCurrentWave;
+    }
+
+    if (nowMs < mNextSpawnAt) {
+        return 0;
+    }
+
+    const WaveEntry &wave = mWaves[mCurrentWave];
+    updateBackoff();
+
+    // 退避时间隔按倍数拉长、组规模按倍数缩小；从本次生成时刻重新计时，掉帧时不会补发积压的组
+    mNextSpawnAt = nowMs + static_cast<qint64>(wave.intervalMs * mBackoff);
+
+    int count = qCeil(wave.groupSize / mBackoff);
+    count = qMin(count, wave.maxAlive - aliveEnemies);
+    if (count <= 0) {
+        return 0;
+    }
+
+    placeGroup(wave, count, sceneRect, out);
+    return count;
+}
+
+int WaveDirector::pickEnemyType(const WaveEntry &wave) const
+{
+    int total = 0;
+    for (int weight : wave.weights) {
+        total += weight;
+    }
+
+    int roll = mRandom->bounded(total);
+    for (int type = 0; type < wave.weights.size(); ++type) {
+        roll -= wave.weights[type];
+        if (roll < 0) {
+            return type;
+        }
+    }
+    return 0;
+}
+
+void WaveDirector::placeGroup(const WaveEntry &wave, int count, const QRectF &sceneRect, QVector<WaveSpawn> &out) const
+{
+    QRandomGenerator* random = mRandom;
+    const int edge = random->bounded(4);
+    const qreal anchor = random->generateDouble();
+    const qreal edgeLength = (edge == 0 || edge == 2) ? sceneRect.width() : sceneRect.height();
+
+    for (int i = 0; i < count; ++i) {
+        QPointF position;
+        switch (wave.formation) {
+        case SpawnFormation::Line: {
+            // 以锚点为中心沿边缘等距排开
+            const qreal offset = (i - (count - 1) * 0.5) * FORMATION_SPACING / edgeLength;
+            position = edgePoint(edge, qBound(0.0, anchor + offset, 1.0), sceneRect, EDGE_OFFSET);
+            break;
+        }
+        case SpawnFormation::Ring: {
+            // 以场景中心为圆心，半径取对角线的一半再向外偏移，保证全部在屏幕外
+            const QPointF center = sceneRect.center();
+            const qreal radius = qSqrt(sceneRect.width() * sceneRect.width()
+                                       + sceneRect.height() * sceneRect.height()) * 0.5 + EDGE_OFFSET;
+            const qreal angle = anchor * 2.0 * M_PI + 2.0 * M_PI * i / count;
+            position = center + QPointF(qCos(angle) * radius, qSin(angle) * radius);
+            break;
+        }
+        case SpawnFormation::Cluster: {
+            const QPointF base = edgePoint(edge, anchor, sceneRect, EDGE_OFFSET);
+            position = base + QPointF(random->bounded(2.0 * FORMATION_SPACING) - FORMATION_SPACING,
+                                      random->bounded(2.0 * FORMATION_SPACING) - FORMATION_SPACING);
+            break;
+        }
+        case SpawnFormation::Random:
+        default:
+            position = edgePoint(random->bounded(4), random->generateDouble(), sceneRect, EDGE_OFFSET);
+            break;
+        }
+
+        out.append({ pickEnemyType(wave), position });
+    }
+}
@@ -0,0 +1,112 @@
+#ifndef WAVE_DIRECTOR_H
+#define WAVE_DIRECTOR_H
+
+#include <QtGlobal>
+#include <QVector>
+#include <QPointF>
+#include <QRectF>
+#include <QString>
+
+class QRandomGenerator;
+class SnapshotWriter;
+class SnapshotReader;
+
+// 一组敌人的出场队形
+enum class SpawnFormation {
+    Random = 0,  // 各自在随机场景边缘出现
+    Line,        // 沿同一条边排成一列
+    Ring,        // 在场景外围一圈同时出现
+    Cluster      // 在同一边缘点附近扎堆
+};
+
+// 波次表中的一行：从startMs开始生效，直到下一波开始
+struct WaveEntry {
+    qint64 startMs;      // 开始时间（游戏时间，毫秒）
+    int intervalMs;      // 两组之间的间隔
+    int groupSize;       // 每组敌人数量
+    SpawnFormation formation;
+    int maxAlive;        // 场上敌人上限，达到后本组只补足差额
+    QVector<int> weights; // 敌人构成权重，按EnemyType的值下标
+};
+
+// 一次生成请求
+struct WaveSpawn {
+    int enemyType;       // EnemyBase::EnemyType的值
+    QPointF position;
+};
+
+// 波次导演
+// 波次表（时间、构成、队形、频率）从资源文件读取，读取失败时使用内置的默认表。
+// 场景每帧用游戏时间推进一次，到点时整组敌人一次性生成；
+// 同时根据实测帧时间调整节奏：超出帧预算时拉长间隔并缩小组规模，帧时间恢复后再逐步回到表中的数值，
+// 避免慢机器上"敌人越多越卡、越卡越追帧"的恶性循环
+class WaveDirector
+{
+public:
+    WaveDirector();
+
+    // 从Qt资源或磁盘读取JSON波次表，失败时保留当前表并返回false
+    bool loadFromFile(const QString &path);
+    void setWaves(const QVector<WaveEntry> &waves);
+
+    // 新一局游戏：回到第一波并清除帧时间统计
+    void reset();
+
+    // 上报一帧的实测时长（毫秒，含渲染），用于帧预算判断
+    void reportFrameTime(qreal frameMs);
+
+    // 回放时关闭自动退避，改由录像中的退避倍数驱动，保证生成结果一致
+    void setAutoBackoff(bool enabled) { mAutoBackoff = enabled; }
+    void setBackoff(qreal backoff);
+
+    // 使用外部的随机数生成器（可按种子复现），默认使用全局生成器
+    void setRandomGenerator(QRandomGenerator* generator) { mRandom = generator; }
+
+    // 推进到游戏时间nowMs，本帧需要生成的敌人追加到out，返回生成数量
+    int advance(qint64 nowMs, int aliveEnemies, const QRectF &sceneRect, QVector<WaveSpawn> &out);
+
+    // 快照：当前波次、下一组的生成时刻和退避状态（波次表本身从资源重新读取）
+    void saveState(SnapshotWriter &writer) const;
+    bool restoreState(SnapshotReader &reader);
+
+    int getCurrentWave() const { return mCurrentWave; }
+    int getWaveCount() const { return mWaves.size(); }
+    qreal getBackoff() const { return mBackoff; }
+    qreal getAverageFrameMs() const { return mAverageFrameMs; }
+
+    static const int ENEMY_TYPE_COUNT = 5;
+
+private:
+    struct SavedState {
+        qint32 currentWave;
+        qint32 frameSamples;
+        qint64 nextSpawnAt;
+        qreal averageFrameMs;
+        qreal backoff;
+    };
+
+    static QVector<WaveEntry> defaultWaves();
+    int pickEnemyType(const WaveEntry &wave) const;
+    void placeGroup(const WaveEntry &wave, int count, const QRectF &sceneRect, QVector<WaveSpawn> &out) const;
+    void updateBackoff();
+
+    QVector<WaveEntry> mWaves;
+    int mCurrentWave;
+    qint64 mNextSpawnAt;
+    qreal mAverageFrameMs;  // 帧时间的指数移动平均
+    qreal mBackoff;         // 间隔倍数，1为按表生成
+    int mFrameSamples;
+    bool mAutoBackoff;
+    QRandomGenerator* mRandom;
+
+    static constexpr qreal FRAME_BUDGET_MS = 1000.0 / 60.0;
+    static constexpr qreal BUDGET_TOLERANCE = 1.1;   // 计时器抖动的容忍量
+    static constexpr qreal RECOVER_RATIO = 0.9;      // 低于预算的该比例才开始恢复
+    static constexpr qreal FRAME_SMOOTHING = 0.1;
+    static constexpr qreal MAX_BACKOFF = 4.0;
+    static constexpr qreal EDGE_OFFSET = 50.0;       // 出生点到场景边缘的距离
+    static constexpr qreal FORMATION_SPACING = 40.0;
+    static const int MIN_FRAME_SAMPLES = 30;         // 样本太少时不做判断
+};
+
+#endif // WAVE_DIRECTOR_H
@@ -0,0 +1,166 @@
+#include "render_profile.h"
+#include <QGraphicsItem>
+#include <QGraphicsScene>
+#include <QPainter>
+#include <QStyleOptionGraphicsItem>
+
+namespace
+{
+    RenderProfile currentProfile = RenderProfile::Balanced;
+
+    const char* const PROFILE_NAMES[RenderProfiles::PROFILE_COUNT] = {
+        "quality", "balanced", "performance"
+    };
+}
+
+RenderProfile RenderProfiles::current()
+{
+    return currentProfile;
+}
+
+void RenderProfiles::setCurrent(RenderProfile profile)
+{
+    currentProfile = profile;
+}
+
+QString RenderProfiles::name(RenderProfile profile)
+{
+    return QString::fromLatin1(PROFILE_NAMES[static_cast<int>(profile)]);
+}
+
+bool RenderProfiles::fromName(const QString &name, RenderProfile &out)
+{
+    for (int i = 0; i < PROFILE_COUNT; ++i) {
+        if (name.compare(QLatin1String(PROFILE_NAMES[i]), Qt::CaseInsensitive) == 0) {
+            out = static_cast<RenderProfile>(i);
+            return true;
+        }
+    }
+    return false;
+}
+
+void RenderProfiles::apply(QGraphicsView* view, RenderProfile profile)
+{
+    QGraphicsScene* scene = view->scene();
+    switch (profile) {
+    case RenderProfile::Quality:
+        if (scene) {
+            scene->setItemIndexMethod(QGraphicsScene::BspTreeIndex);
+        }
+        view->setViewportUpdateMode(QGraphicsView::MinimalViewportUpdate);
+        view->setOptimizationFlags(QGraphicsView::OptimizationFlags());
+        view->setCacheMode(QGraphicsView::CacheNone);
+        view->setRenderHint(QPainter::Antialiasing, true);
+        view->setRenderHint(QPainter::SmoothPixmapTransform, true);
+        break;
+    case RenderProfile::Balanced:
+        // 图元每帧都在移动，BSP树的维护成本高于查询收益
+        if (scene) {
+            scene->setItemIndexMethod(QGraphicsScene::NoIndex);
+        }
+        view->setViewportUpdateMode(QGraphicsView::SmartViewportUpdate);
+        view->setOptimizationFlags(QGraphicsView::DontSavePainterState);
+        view->setCacheMode(QGraphicsView::CacheBackground);
+        // 场景里只有位图，抗锯齿只影响少量边框线条
+        view->setRenderHint(QPainter::Antialiasing, false);
+        view->setRenderHint(QPainter::SmoothPixmapTransform, true);
+        break;
+    case RenderProfile::Performance:
+        if (scene) {
+            scene->setItemIndexMethod(QGraphicsScene::NoIndex);
+        }
+        // 满屏移动的图元下，整屏重绘比逐块计算脏区域更省
+        view->setViewportUpdateMode(QGraphicsView::FullViewportUpdate);
+        view->setOptimizationFlags(QGraphicsView::DontSavePainterState | QGraphicsView::DontAdjustForAntialiasing);
+        view->setCacheMode(QGraphicsView::CacheBackground);
+        view->setRenderHint(QPainter::Antialiasing, false);
+        view->setRenderHint(QPainter::SmoothPixmapTransform, false);
+        break;
+    }
+    view->resetCachedContent();
+}
+
+void StaticLayer::setBackground(const QPixmap &background)
+{
+    mBackground = background;
+    mComposite = QPixmap();
+}
+
+void StaticLayer::setItems(const QList<QGraphicsItem*> &items)
+{
+    // 旧图元可能已随场景一起删除，只丢弃引用
+    mItems = items;
+    mComposite = QPixmap();
+    mComposited = false;
+}
+
+void StaticLayer::restoreItems()
+{
+    for (QGraphicsItem* item : mItems) {
+        item->setCacheMode(QGraphicsItem::NoCache);
+        if (mComposited) {
+            item->show();
+        }
+    }
+    mComposited = false;
+}
+
+void StaticLayer::apply(RenderProfile profile)
+{
+    restoreItems();
+
+    if (profile == RenderProfile::Balanced) {
+        for (QGraphicsItem* item : mItems) {
+            item->setCacheMode(QGraphicsItem::DeviceCoordinateCache);
+        }
+        return;
+    }
+    if (profile != RenderProfile::Performance || mItems.isEmpty() || mBackground.isNull()) {
+        return;
+    }
+
+    // 按场景坐标把图元画进背景图；合成后图元位于所有动态图元之下
+    mComposite = mBackground.copy();
+    QPainter painter(&mComposite);
+    QStyleOptionGraphicsItem option;
+    for (QGraphicsItem* item : mItems) {
+        if (!item->isVisible()) {
+            continue;
+        }
+        painter.save();
+        painter.setTransform(item->sceneTransform(), true);
+        option.exposedRect = item->boundingRect();
+        item->paint(&painter, &option, nullptr);
+        painter.restore();
+        item->hide();
+    }
+    mComposited = true;
+}
+
+void StaticLayer::draw(QPainter* painter, const QRectF &rect) const
+{
+    const QPixmap &pixmap = mComposited ? mComposite : mBackground;
+    painter->drawPixmap(rect.toRect(), pixmap, rect.toRect());
+}
+
+ProfiledGraphicsView::ProfiledGraphicsView(QGraphicsScene* scene, QWidget* parent)
+    : QGraphicsView(scene, parent)
+{
+}
+
+void ProfiledGraphicsView::paintEvent(QPaintEvent* event)
+{
+    QElapsedTimer paintTimer;
+    paintTimer.start();
+    QGraphicsView::paintEvent(event);
+    mPaintNsecs += paintTimer.nsecsElapsed();
+    ++mPaintCount;
+}
+
+void ProfiledGraphicsView::takePaintStats(int &count, qreal &averageUs)
+{
+    count = mPaintCount;
+    averageUs = mPaintCount > 0 ? mPaintNsecs / 1000.0 / mPaintCount : 0.0;
+    mPaintNsecs = 0;
+    mPaintCount = 0;
+}
@@ -0,0 +1,78 @@
+#ifndef RENDER_PROFILE_H
+#define RENDER_PROFILE_H
+
+#include <QGraphicsView>
+#include <QPixmap>
+#include <QList>
+#include <QString>
+#include <QElapsedTimer>
+
+class QGraphicsItem;
+class QPainter;
+
+// 渲染档位
+enum class RenderProfile {
+    Quality = 0,  // 与原先一致：BSP索引、最小区域刷新、抗锯齿和平滑缩放全开
+    Balanced,     // 不建索引、智能刷新、缓存背景，只保留平滑缩放
+    Performance   // 整屏刷新、关闭所有渲染提示，静态图层合成进背景
+};
+
+// 渲染档位配置
+// 两个模式的视图和场景共用：图元索引、视口刷新模式、优化标志、背景缓存和渲染提示。
+// 档位在启动时用--render-profile选择，默认均衡
+class RenderProfiles
+{
+public:
+    static RenderProfile current();
+    static void setCurrent(RenderProfile profile);
+
+    // 档位名称：quality / balanced / performance
+    static QString name(RenderProfile profile);
+    static bool fromName(const QString &name, RenderProfile &out);
+
+    // 配置视图及其场景
+    static void apply(QGraphicsView* view, RenderProfile profile);
+
+    static const int PROFILE_COUNT = 3;
+};
+
+// 静态图层：背景图和不会移动的图元（地图边界、墙体）
+// 性能档把图元预先画进背景图并隐藏，每帧只剩一次drawPixmap；
+// 均衡档保留图元，用设备坐标缓存避免重复光栅化；画质档逐个原样绘制。
+// 场景在drawBackground()中调用draw()，切换档位后需使背景层失效
+class StaticLayer
+{
+public:
+    // 背景图按场景坐标1:1绘制，原点对齐场景原点
+    void setBackground(const QPixmap &background);
+    void setItems(const QList<QGraphicsItem*> &items);
+    void apply(RenderProfile profile);
+    void draw(QPainter* painter, const QRectF &rect) const;
+
+private:
+    void restoreItems();
+
+    QPixmap mBackground;
+    QPixmap mComposite;
+    QList<QGraphicsItem*> mItems;
+    bool mComposited = false;
+};
+
+// 记录绘制耗时的视图，供性能统计和绘制基准使用
+class ProfiledGraphicsView : public QGraphicsView
+{
+public:
+    explicit ProfiledGraphicsView(QGraphicsScene* scene, QWidget* parent = nullptr);
+
+    // 自上次调用以来的绘制次数和平均每次耗时（微秒），调用后清零
+    void takePaintStats(int &count, qreal &averageUs);
+
+protected:
+    void paintEvent(QPaintEvent* event) override;
+
+private:
+    qint64 mPaintNsecs = 0;
+    int mPaintCount = 0;
+};
+
+#endif // RENDER_PROFILE_H
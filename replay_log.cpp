@@ -0,0 +1,269 @@
+#include "replay_log.h"
+#include <QFile>
+#include <QFileInfo>
+#include <QDir>
+#include <QtMath>
+
+namespace
+{
+    const char MAGIC[4] = { 'C', 'N', 'R', 'P' };
+    const int HEADER_SIZE = 6; // 魔数 + 版本 + 模式
+    const int KIND_BITS = 3;
+}
+
+ReplayWriter::ReplayWriter()
+    : mLastTick(0)
+    , mLastMouseX(0)
+    , mLastMouseY(0)
+    , mRecording(false)
+{
+}
+
+void ReplayWriter::begin(Mode mode, quint32 seed)
+{
+    mData.clear();
+    mData.reserve(16 * 1024);
+    mData.append(MAGIC, 4);
+    mData.append(static_cast<char>(FORMAT_VERSION));
+    mData.append(static_cast<char>(mode));
+    writeVarint(seed);
+    mLastTick = 0;
+    mLastMouseX = 0;
+    mLastMouseY = 0;
+    mRecording = true;
+}
+
+void ReplayWriter::append(const ReplayEvent &event)
+{
+    if (!mRecording) {
+        return;
+    }
+
+    const quint64 tickDelta = static_cast<quint64>(qMax<qint64>(0, event.tick - mLastTick));
+    mLastTick = qMax(mLastTick, event.tick);
+    writeVarint((tickDelta << KIND_BITS) | event.kind);
+
+    switch (event.kind) {
+    case ReplayEvent::KeyMask:
+    case ReplayEvent::Backoff:
+    case ReplayEvent::StateHash:
+        writeVarint(static_cast<quint32>(event.a));
+        break;
+    case ReplayEvent::MousePress:
+        writeSigned(static_cast<qint64>(event.a) - mLastMouseX);
+        writeSigned(static_cast<qint64>(event.b) - mLastMouseY);
+        mLastMouseX = event.a;
+        mLastMouseY = event.b;
+        break;
+    case ReplayEvent::KeyEvent:
+        writeVarint((static_cast<quint64>(static_cast<quint32>(event.a)) << 1) | (event.b ? 1 : 0));
+        break;
+    case ReplayEvent::End:
+        break;
+    }
+}
+
+void ReplayWriter::finish(qint64 tick)
+{
+    if (!mRecording) {
+        return;
+    }
+    append({ tick, ReplayEvent::End, 0, 0 });
+    mRecording = false;
+}
+
+bool ReplayWriter::saveToFile(const QString &path) const
+{
+    QDir().mkpath(QFileInfo(path).absolutePath());
+    QFile file(path);
+    if (!file.open(QIODevice::WriteOnly)) {
+        return false;
+    }
+    return file.write(mData) == mData.size();
+}
+
+qint32 ReplayWriter::quantizeCoord(qreal value)
+{
+    return qRound(value * 4.0);
+}
+
+qreal ReplayWriter::dequantizeCoord(qint32 value)
+{
+    return value / 4.0;
+}
+
+void ReplayWriter::writeVarint(quint64 value)
+{
+    // 每字节7位，最高位表示后面还有字节
+    while (value >= 0x80) {
+        mData.append(static_cast<char>((value & 0x7f) | 0x80));
+        value >>= 7;
+    }
+    mData.append(static_cast<char>(value));
+}
+
+void ReplayWriter::writeSigned(qint64 value)
+{
+    // zigzag：小的负数也只占一个字节
+    writeVarint((static_cast<quint64>(value) << 1) ^ static_cast<quint64>(value >> 63));
+}
+
+ReplayReader::ReplayReader()
+    : mPos(0)
+    , mMode(ReplayWriter::SugarOil)
+    , mSeed(0)
+    , mPending{ 0, ReplayEvent::End, 0, 0 }
+    , mHasPending(false)
+    , mLastTick(0)
+    , mLastMouseX(0)
+    , mLastMouseY(0)
+    , mEndTick(0)
+    , mOpen(false)
+    , mFinished(true)
+{
+}
+
+bool ReplayReader::open(const QByteArray &data)
+{
+    close();
+    if (data.size() < HEADER_SIZE || !data.startsWith(QByteArray(MAGIC, 4))
+        || static_cast<quint8>(data[4]) != ReplayWriter::FORMAT_VERSION) {
+        return false;
+    }
+
+    mData = data;
+    mMode = static_cast<ReplayWriter::Mode>(static_cast<quint8>(mData[5]));
+    mPos = HEADER_SIZE;
+
+    quint64 seed = 0;
+    if (!readVarint(seed)) {
+        close();
+        return false;
+    }
+    mSeed = static_cast<quint32>(seed);
+    mOpen = true;
+    mFinished = false;
+    return true;
+}
+
+bool ReplayReader::loadFromFile(const QString &path)
+{
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return false;
+    }
+    return open(file.readAll());
+}
+
+void ReplayReader::close()
+{
+    mData.clear();
+    mPos = 0;
+    mHasPending = false;
+    mLastTick = 0;
+    mLastMouseX = 0;
+    mLastMouseY = 0;
+    mEndTick = 0;
+    mOpen = false;
+    mFinished = true;
+}
+
+bool ReplayReader::hasEventAt(qint64 tick)
+{
+    if (!mHasPending && !readNext()) {
+        return false;
+    }
+    return mPending.tick <= tick;
+}
+
+ReplayEvent ReplayReader::takeEvent()
+{
+    mHasPending = false;
+    return mPending;
+}
+
+bool ReplayReader::readNext()
+{
+    if (!mOpen || mFinished) {
+        return false;
+    }
+
+    quint64 header = 0;
+    if (!readVarint(header)) {
+        mFinished = true;
+        return false;
+    }
+
+    ReplayEvent event;
+    event.tick = mLastTick + static_cast<qint64>(header >> KIND_BITS);
+    event.kind = static_cast<ReplayEvent::Kind>(header & ((1 << KIND_BITS) - 1));
+    event.a = 0;
+    event.b = 0;
+    mLastTick = event.tick;
+
+    bool ok = true;
+    quint64 value = 0;
+    qint64 dx = 0;
+    qint64 dy = 0;
+    switch (event.kind) {
+    case ReplayEvent::KeyMask:
+    case ReplayEvent::Backoff:
+    case ReplayEvent::StateHash:
+        ok = readVarint(value);
+        event.a = static_cast<qint32>(value);
+        break;
+    case ReplayEvent::MousePress:
+        ok = readSigned(dx) && readSigned(dy);
+        mLastMouseX += static_cast<qint32>(dx);
+        mLastMouseY += static_cast<qint32>(dy);
+        event.a = mLastMouseX;
+        event.b = mLastMouseY;
+        break;
+    case ReplayEvent::KeyEvent:
+        ok = readVarint(value);
+        event.a = static_cast<qint32>(value >> 1);
+        event.b = static_cast<qint32>(value & 1);
+        break;
+    case ReplayEvent::End:
+        mEndTick = event.tick;
+        mFinished = true;
+        return false;
+    default:
+        ok = false;
+        break;
+    }
+
+    if (!ok) {
+        mFinished = true;
+        return false;
+    }
+    mPending = event;
+    mHasPending = true;
+    return true;
+}
+
+bool ReplayReader::readVarint(quint64 &value)
+{
+    value = 0;
+    for (int shift = 0; shift < 64; shift += 7) {
+        if (mPos >= mData.size()) {
+            return false;
+        }
+        const quint8 byte = static_cast<quint8>(mData[mPos++]);
+        value |= static_cast<quint64>(byte & 0x7f) << shift;
+        if (!(byte & 0x80)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool ReplayReader::readSigned(qint64 &value)
+{
+    quint64 raw = 0;
+    if (!readVarint(raw)) {
+        return false;
+    }
+    value = static_cast<qint64>(raw >> 1) ^ -static_cast<qint64>(raw & 1);
+    return true;
+}
@@ -0,0 +1,106 @@
+#ifndef REPLAY_LOG_H
+#define REPLAY_LOG_H
+
+#include <QtGlobal>
+#include <QByteArray>
+#include <QString>
+
+// 回放中的一条输入事件，tick为该事件在第几次帧更新之前生效
+struct ReplayEvent {
+    enum Kind {
+        KeyMask = 0,     // 模式2：方向键按下状态的位掩码，a为掩码
+        MousePress = 1,  // 模式2：鼠标射击，a/b为场景坐标（1/4像素定点数）
+        KeyEvent = 2,    // 模式1：按键事件，a为Qt::Key，b为1按下/0松开
+        Backoff = 3,     // 模式2：波次导演的生成退避倍数，a为百分之一
+        StateHash = 4,   // 模式1：该帧结束时的状态校验值，a为32位校验值
+        End = 7          // 录制结束，tick为总帧数
+    };
+
+    qint64 tick;
+    Kind kind;
+    qint32 a;
+    qint32 b;
+};
+
+// 回放文件格式（小端、变长整数）：
+//   "CNRP" 版本(1字节) 模式(1字节) 随机数种子(varint)
+//   事件序列：varint((tick增量 << 3) | kind) + 按kind决定的负载
+// tick用与上一事件的差值编码，鼠标坐标用与上一次点击的差值做zigzag编码，
+// 一局5分钟的对局通常只有几KB
+class ReplayWriter
+{
+public:
+    enum Mode : quint8 {
+        Carbohydrate = 1,
+        SugarOil = 2
+    };
+
+    // 2：随机数改为按帧（模式1按AI步）由种子重新派生，旧录像无法复现
+    // 3：模式1全部按游戏帧推进并记录状态校验值
+    static const quint8 FORMAT_VERSION = 3;
+
+    ReplayWriter();
+
+    void begin(Mode mode, quint32 seed);
+    void append(const ReplayEvent &event);
+    void finish(qint64 tick);
+
+    bool isRecording() const { return mRecording; }
+    const QByteArray &data() const { return mData; }
+    bool saveToFile(const QString &path) const;
+
+    // 鼠标坐标量化为1/4像素，录制和回放都使用量化后的值，保证两边计算完全一致
+    static qint32 quantizeCoord(qreal value);
+    static qreal dequantizeCoord(qint32 value);
+
+private:
+    void writeVarint(quint64 value);
+    void writeSigned(qint64 value);
+
+    QByteArray mData;
+    qint64 mLastTick;
+    qint32 mLastMouseX;
+    qint32 mLastMouseY;
+    bool mRecording;
+};
+
+class ReplayReader
+{
+public:
+    ReplayReader();
+
+    // 解析文件头，失败时返回false
+    bool open(const QByteArray &data);
+    bool loadFromFile(const QString &path);
+    void close();
+
+    bool isOpen() const { return mOpen; }
+    ReplayWriter::Mode getMode() const { return mMode; }
+    quint32 getSeed() const { return mSeed; }
+
+    // 下一个事件是否在tick或之前生效；读到End或数据损坏时返回false
+    bool hasEventAt(qint64 tick);
+    ReplayEvent takeEvent();
+    bool isFinished() const { return mFinished; }
+    qint64 getEndTick() const { return mEndTick; }
+
+private:
+    bool readVarint(quint64 &value);
+    bool readSigned(qint64 &value);
+    bool readNext();
+
+    QByteArray mData;
+    int mPos;
+    ReplayWriter::Mode mMode;
+    quint32 mSeed;
+    ReplayEvent mPending;
+    bool mHasPending;
+    qint64 mLastTick;
+    qint32 mLastMouseX;
+    qint32 mLastMouseY;
+    qint64 mEndTick;
+    bool mOpen;
+    bool mFinished;
+};
+
+#endif // REPLAY_LOG_H
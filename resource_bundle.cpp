@@ -0,0 +1,50 @@
+#include "resource_bundle.h"
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QFileInfo>
+#include <QResource>
+#include <QStringList>
+#include <QDebug>
+
+QString ResourceBundle::findBundle(const QString &fileName)
+{
+    const QString appDir = QCoreApplication::applicationDirPath();
+    const QStringList candidates = {
+        appDir + "/" + fileName,
+        appDir + "/../" + fileName,           // Windows下debug/release子目录中的程序
+        appDir + "/../Resources/" + fileName  // macOS应用包
+    };
+    for (const QString &candidate : candidates) {
+        if (QFileInfo::exists(candidate)) {
+            return QFileInfo(candidate).canonicalFilePath();
+        }
+    }
+    return QString();
+}
+
+bool ResourceBundle::registerExternal(const QString &fileName)
+{
+#ifdef EMBED_EXTERNAL_ASSETS
+    // CONFIG+=embedded_assets：资源已编译进程序，用于和外部资源包对比启动时间与内存
+    Q_UNUSED(fileName)
+    qDebug() << "ResourceBundle: assets embedded in the executable";
+    return true;
+#else
+    const QString path = findBundle(fileName);
+    if (path.isEmpty()) {
+        qWarning() << "ResourceBundle: cannot find" << fileName << "next to the executable";
+        return false;
+    }
+
+    QElapsedTimer timer;
+    timer.start();
+    if (!QResource::registerResource(path)) {
+        qWarning() << "ResourceBundle: cannot register" << path;
+        return false;
+    }
+    qDebug() << "ResourceBundle: registered" << path
+             << "size KB:" << QFileInfo(path).size() / 1024
+             << "us:" << timer.nsecsElapsed() / 1000;
+    return true;
+#endif
+}
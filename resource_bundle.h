@@ -0,0 +1,20 @@
+#ifndef RESOURCE_BUNDLE_H
+#define RESOURCE_BUNDLE_H
+
+#include <QString>
+
+// 外部资源包
+// 背景图和音频由rcc -binary打包成可执行文件旁的external_assets.rcc（见external_assets.qrc），
+// 不再编译进程序。启动时注册一次：Qt会把文件映射进内存而不是整个读入，
+// 条目不压缩，播放或解码时才按需读到对应的页。注册后资源路径与嵌入时完全相同
+class ResourceBundle
+{
+public:
+    // 必须在创建任何用到这些资源的对象之前调用；找不到或注册失败时返回false，游戏照常运行，只是没有背景和声音
+    static bool registerExternal(const QString &fileName = QStringLiteral("external_assets.rcc"));
+
+    // 依次在程序目录、上一级目录和macOS包的Resources目录中查找，找不到时返回空字符串
+    static QString findBundle(const QString &fileName);
+};
+
+#endif // RESOURCE_BUNDLE_H
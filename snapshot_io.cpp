@@ -0,0 +1,153 @@
+#include "snapshot_io.h"
+#include <QFile>
+#include <QFileInfo>
+#include <QDir>
+#include <QSaveFile>
+#include <QDebug>
+
+namespace
+{
+    const char MAGIC[4] = { 'C', 'N', 'S', 'S' };
+    const int HEADER_SIZE = 8; // 魔数 + 版本 + 模式 + 保留
+}
+
+SnapshotWriter::SnapshotWriter()
+{
+}
+
+void SnapshotWriter::begin(Mode mode, int reserveBytes)
+{
+    // clear()会释放缓冲区，这里只截断，连续存档时复用同一块内存
+    mData.truncate(0);
+    mData.reserve(qMax(HEADER_SIZE, reserveBytes));
+    mData.append(MAGIC, 4);
+    write(static_cast<quint16>(FORMAT_VERSION));
+    write<quint8>(mode);
+    write<quint8>(0);
+}
+
+void SnapshotWriter::appendRaw(const void* data, int size)
+{
+    if (size <= 0) {
+        return;
+    }
+    const int offset = mData.size();
+    mData.resize(offset + size);
+    std::memcpy(mData.data() + offset, data, size);
+}
+
+bool SnapshotWriter::saveToFile(const QString &path, const QByteArray &data)
+{
+    QDir().mkpath(QFileInfo(path).absolutePath());
+    QSaveFile file(path);
+    if (!file.open(QIODevice::WriteOnly)) {
+        return false;
+    }
+    if (file.write(data) != data.size()) {
+        file.cancelWriting();
+        return false;
+    }
+    return file.commit();
+}
+
+SnapshotReader::SnapshotReader()
+    : mPos(0)
+    , mOk(false)
+{
+}
+
+bool SnapshotReader::open(const QByteArray &data, SnapshotWriter::Mode mode)
+{
+    mData = data;
+    mPos = 0;
+    mOk = true;
+
+    char magic[4];
+    quint16 version = 0;
+    quint8 fileMode = 0;
+    quint8 reserved = 0;
+    if (data.size() < HEADER_SIZE || !readRaw(magic, 4) || std::memcmp(magic, MAGIC, 4) != 0
+        || !read(version) || version != SnapshotWriter::FORMAT_VERSION
+        || !read(fileMode) || fileMode != mode || !read(reserved)) {
+        mOk = false;
+    }
+    return mOk;
+}
+
+bool SnapshotReader::loadFromFile(const QString &path, SnapshotWriter::Mode mode)
+{
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly)) {
+        mOk = false;
+        return false;
+    }
+    return open(file.readAll(), mode);
+}
+
+bool SnapshotReader::expectSection(quint32 tag)
+{
+    quint32 value = 0;
+    if (!read(value) || value != tag) {
+        mOk = false;
+    }
+    return mOk;
+}
+
+bool SnapshotReader::readRaw(void* out, int size)
+{
+    if (!mOk || size < 0 || mData.size() - mPos < size) {
+        mOk = false;
+        return false;
+    }
+    std::memcpy(out, mData.constData() + mPos, size);
+    mPos += size;
+    return true;
+}
+
+SnapshotAutosaver::WriteTask::WriteTask(SnapshotAutosaver* owner)
+    : mOwner(owner)
+{
+    setAutoDelete(false);
+}
+
+void SnapshotAutosaver::WriteTask::run()
+{
+    if (!SnapshotWriter::saveToFile(path, data)) {
+        qDebug() << "Autosave failed:" << path;
+    }
+    // 先放掉对快照缓冲区的引用，主线程下次生成快照时可以原地复用，不必复制
+    data = QByteArray();
+    mOwner->mBusy.storeRelease(0);
+}
+
+SnapshotAutosaver::SnapshotAutosaver()
+    : mBusy(0)
+    , mTask(this)
+{
+    // 单线程，写盘按提交顺序进行；线程常驻，每次存档不重新创建
+    mPool.setMaxThreadCount(1);
+    mPool.setExpiryTimeout(-1);
+}
+
+SnapshotAutosaver::~SnapshotAutosaver()
+{
+    waitForPending();
+}
+
+bool SnapshotAutosaver::saveAsync(const QString &path, const QByteArray &data)
+{
+    if (!mBusy.testAndSetAcquire(0, 1)) {
+        return false;
+    }
+
+    // QByteArray是隐式共享的，工作线程持有的是不再变化的一份数据
+    mTask.path = path;
+    mTask.data = data;
+    mPool.start(&mTask);
+    return true;
+}
+
+void SnapshotAutosaver::waitForPending()
+{
+    mPool.waitForDone();
+}
@@ -0,0 +1,161 @@
+#ifndef SNAPSHOT_IO_H
+#define SNAPSHOT_IO_H
+
+#include <QtGlobal>
+#include <QByteArray>
+#include <QString>
+#include <QVector>
+#include <QThreadPool>
+#include <QAtomicInt>
+#include <cstring>
+#include <type_traits>
+
+// 对局快照格式（本机字节序、定长字段）：
+//   "CNSS" 版本(2字节) 模式(1字节) 保留(1字节)
+//   各段依次排列：段标记(4字节) + 段内容
+//   定长值直接写入；数组为 元素数(4字节) + 连续的定长记录
+// 记录都是可平凡复制的结构体，一个数组只做一次memcpy，不逐字段编码。
+// 快照只在本机保存和读取，记录布局变化时递增FORMAT_VERSION，旧快照直接作废
+class SnapshotWriter
+{
+public:
+    enum Mode : quint8 {
+        Carbohydrate = 1,
+        SugarOil = 2
+    };
+
+    static const quint16 FORMAT_VERSION = 2;
+
+    SnapshotWriter();
+
+    // 开始一份新快照，reserveBytes为预估大小，避免写入过程中反复扩容
+    void begin(Mode mode, int reserveBytes = 0);
+
+    // 段标记用于读取时校验位置，数据错位时能尽早发现
+    void beginSection(quint32 tag) { write(tag); }
+
+    template<typename T>
+    void write(const T &value)
+    {
+        static_assert(std::is_trivially_copyable<T>::value, "snapshot fields must be trivially copyable");
+        appendRaw(&value, sizeof(T));
+    }
+
+    template<typename T>
+    void writeArray(const T* values, int count)
+    {
+        static_assert(std::is_trivially_copyable<T>::value, "snapshot records must be trivially copyable");
+        write<qint32>(count);
+        appendRaw(values, count * static_cast<int>(sizeof(T)));
+    }
+
+    template<typename T>
+    void writeArray(const QVector<T> &values)
+    {
+        writeArray(values.constData(), values.size());
+    }
+
+    // 格式与writeArray相同，记录由makeRecord(item)逐个生成后直接写入，不需要先收集到临时数组
+    template<typename T, typename Container, typename Fn>
+    void writeArrayOf(const Container &items, Fn makeRecord)
+    {
+        static_assert(std::is_trivially_copyable<T>::value, "snapshot records must be trivially copyable");
+        write<qint32>(static_cast<qint32>(items.size()));
+        for (const auto &item : items) {
+            const T record = makeRecord(item);
+            appendRaw(&record, sizeof(T));
+        }
+    }
+
+    const QByteArray &data() const { return mData; }
+
+    // 先写临时文件再替换，写到一半退出不会留下损坏的存档；可在工作线程调用
+    static bool saveToFile(const QString &path, const QByteArray &data);
+
+private:
+    void appendRaw(const void* data, int size);
+
+    QByteArray mData;
+};
+
+class SnapshotReader
+{
+public:
+    SnapshotReader();
+
+    // 校验文件头和模式，失败时返回false
+    bool open(const QByteArray &data, SnapshotWriter::Mode mode);
+    bool loadFromFile(const QString &path, SnapshotWriter::Mode mode);
+
+    bool expectSection(quint32 tag);
+
+    // 读取越界或段标记不符后所有读取都失败，调用方只需在最后检查一次isOk()
+    template<typename T>
+    bool read(T &value)
+    {
+        static_assert(std::is_trivially_copyable<T>::value, "snapshot fields must be trivially copyable");
+        return readRaw(&value, sizeof(T));
+    }
+
+    // maxCount用于拒绝损坏数据中的超大长度
+    template<typename T>
+    bool readArray(QVector<T> &values, int maxCount)
+    {
+        static_assert(std::is_trivially_copyable<T>::value, "snapshot records must be trivially copyable");
+        qint32 count = 0;
+        if (!read(count) || count < 0 || count > maxCount
+            || mData.size() - mPos < count * static_cast<qint64>(sizeof(T))) {
+            mOk = false;
+            values.clear();
+            return false;
+        }
+        values.resize(count);
+        return readRaw(values.data(), count * static_cast<int>(sizeof(T)));
+    }
+
+    bool isOk() const { return mOk; }
+    bool atEnd() const { return mPos == mData.size(); }
+
+private:
+    bool readRaw(void* out, int size);
+
+    QByteArray mData;
+    int mPos;
+    bool mOk;
+};
+
+// 自动存档：快照在主线程生成（一份拷贝出的字节数组），写盘放到工作线程执行。
+// 上一次写盘尚未完成时跳过本次，不会排队堆积
+class SnapshotAutosaver
+{
+public:
+    SnapshotAutosaver();
+    ~SnapshotAutosaver();
+
+    // 返回false表示上一次写盘仍在进行，本次被跳过
+    bool saveAsync(const QString &path, const QByteArray &data);
+
+    // 等待正在进行的写盘结束（同步存档或删除存档前调用）
+    void waitForPending();
+
+private:
+    // 写盘任务常驻复用，每次存档只替换路径和数据，提交时不再分配
+    class WriteTask : public QRunnable
+    {
+    public:
+        explicit WriteTask(SnapshotAutosaver* owner);
+        void run() override;
+
+        QString path;
+        QByteArray data;
+
+    private:
+        SnapshotAutosaver* mOwner;
+    };
+
+    QThreadPool mPool;
+    QAtomicInt mBusy;
+    WriteTask mTask;
+};
+
+#endif // SNAPSHOT_IO_H
@@ -0,0 +1,249 @@
+#include "startup_trace.h"
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QEvent>
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QTimer>
+#include <QVector>
+#include <QWidget>
+#include <QtMath>
+#include <QDebug>
+#if defined(Q_OS_WIN)
+#include <windows.h>
+#include <psapi.h>
+#elif defined(Q_OS_LINUX)
+#include <unistd.h>
+#endif
+
+namespace
+{
+    // 静态初始化时启动，近似为进程启动时刻
+    QElapsedTimer startTimer()
+    {
+        QElapsedTimer timer;
+        timer.start();
+        return timer;
+    }
+    const QElapsedTimer processTimer = startTimer();
+
+    struct Mark {
+        const char* name;
+        qint64 nsecs;
+        qint64 rssKb; // 打点时的常驻内存，取不到时为-1
+    };
+
+    QVector<Mark> marks;
+    bool traceEnabled = false;
+    QString exitAfter;
+
+    const Mark* findMark(const QString &name)
+    {
+        for (const Mark &mark : marks) {
+            if (name == QLatin1String(mark.name)) {
+                return &mark;
+            }
+        }
+        return nullptr;
+    }
+
+    qreal toMs(qint64 nsecs)
+    {
+        return nsecs / 1000000.0;
+    }
+
+    // 当前进程的常驻内存（KB），只支持Windows和Linux，其它平台返回-1
+    qint64 currentRssKb()
+    {
+#if defined(Q_OS_WIN)
+        PROCESS_MEMORY_COUNTERS counters;
+        if (GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters))) {
+            return static_cast<qint64>(counters.WorkingSetSize / 1024);
+        }
+        return -1;
+#elif defined(Q_OS_LINUX)
+        // statm的第二项是常驻页数
+        QFile statm("/proc/self/statm");
+        if (!statm.open(QIODevice::ReadOnly)) {
+            return -1;
+        }
+        const QList<QByteArray> fields = statm.readAll().split(' ');
+        if (fields.size() < 2) {
+            return -1;
+        }
+        return fields.at(1).toLongLong() * (sysconf(_SC_PAGESIZE) / 1024);
+#else
+        return -1;
+#endif
+    }
+
+    bool readBudgetFile(const QString &path, QJsonObject &document)
+    {
+        QFile file(path);
+        if (!file.open(QIODevice::ReadOnly)) {
+            qWarning() << "StartupTrace: cannot open budget file" << path;
+            return false;
+        }
+        QJsonParseError error;
+        document = QJsonDocument::fromJson(file.readAll(), &error).object();
+        if (error.error != QJsonParseError::NoError) {
+            qWarning() << "StartupTrace: invalid budget file" << path << error.errorString();
+            return false;
+        }
+        return true;
+    }
+
+    // from为空时从进程启动算起；任一端本次没有到达时返回false
+    bool measureInterval(const QString &fromName, const QString &markName, qreal &elapsedMs)
+    {
+        const Mark* end = findMark(markName);
+        const Mark* begin = fromName.isEmpty() ? nullptr : findMark(fromName);
+        if (!end || (!fromName.isEmpty() && !begin)) {
+            return false;
+        }
+        elapsedMs = toMs(end->nsecs - (begin ? begin->nsecs : 0));
+        return true;
+    }
+
+    // 第一次绘制后打点并自行移除
+    class FirstPaintFilter : public QObject
+    {
+    public:
+        FirstPaintFilter(QWidget* widget, const char* name)
+            : QObject(widget)
+            , mName(name)
+        {
+        }
+
+    protected:
+        bool eventFilter(QObject* watched, QEvent* event) override
+        {
+            if (event->type() == QEvent::Paint) {
+                StartupTrace::mark(mName);
+                watched->removeEventFilter(this);
+                deleteLater();
+            }
+            return false;
+        }
+
+    private:
+        const char* mName;
+    };
+}
+
+void StartupTrace::mark(const char* name)
+{
+    if (findMark(QLatin1String(name))) {
+        return;
+    }
+    // 前几个打点在解析命令行之前，所以总是读取内存；打点只有十来个，开销可以忽略
+    marks.append({ name, processTimer.nsecsElapsed(), currentRssKb() });
+
+    if (traceEnabled && !exitAfter.isEmpty() && exitAfter == QLatin1String(name)) {
+        // 等当前事件处理完再退出，避免在绘制过程中销毁窗口
+        QTimer::singleShot(0, QCoreApplication::instance(), &QCoreApplication::quit);
+    }
+}
+
+void StartupTrace::markFirstPaint(QWidget* widget, const char* name)
+{
+    if (!widget || findMark(QLatin1String(name))) {
+        return;
+    }
+    widget->installEventFilter(new FirstPaintFilter(widget, name));
+}
+
+void StartupTrace::setEnabled(bool enabled)
+{
+    traceEnabled = enabled;
+}
+
+bool StartupTrace::isEnabled()
+{
+    return traceEnabled;
+}
+
+void StartupTrace::setExitAfter(const QString &name)
+{
+    exitAfter = name;
+}
+
+void StartupTrace::printReport()
+{
+    qint64 previous = 0;
+    for (const Mark &mark : marks) {
+        qDebug().noquote() << QString("Startup trace - %1 at ms: %2 (+%3) RSS MB: %4")
+                                  .arg(QLatin1String(mark.name), -24)
+                                  .arg(toMs(mark.nsecs), 9, 'f', 2)
+                                  .arg(toMs(mark.nsecs - previous), 0, 'f', 2)
+                                  .arg(mark.rssKb >= 0 ? QString::number(mark.rssKb / 1024.0, 'f', 1) : QString("n/a"));
+        previous = mark.nsecs;
+    }
+}
+
+bool StartupTrace::checkBudgets(const QString &path)
+{
+    QJsonObject document;
+    if (!readBudgetFile(path, document)) {
+        return false;
+    }
+    if (!document.value("measured").toBool()) {
+        qDebug() << "Startup budget - values in" << path << "are unmeasured placeholders,"
+                 << "record real ones with --startup-record-budgets";
+    }
+
+    bool withinBudget = true;
+    for (const QJsonValue &value : document.value("budgets").toArray()) {
+        const QJsonObject budget = value.toObject();
+        const QString markName = budget.value("mark").toString();
+        const QString fromName = budget.value("from").toString();
+        const qreal maxMs = budget.value("maxMs").toDouble();
+
+        qreal elapsedMs = 0.0;
+        if (!measureInterval(fromName, markName, elapsedMs)) {
+            qDebug() << "Startup budget - skipped, not reached:" << markName;
+            continue;
+        }
+
+        const bool ok = elapsedMs <= maxMs;
+        qDebug().noquote() << QString("Startup budget - %1 %2 -> %3 ms: %4 budget: %5")
+                                  .arg(ok ? "ok  " : "FAIL")
+                                  .arg(fromName.isEmpty() ? QString("start") : fromName)
+                                  .arg(markName)
+                                  .arg(elapsedMs, 0, 'f', 2)
+                                  .arg(maxMs, 0, 'f', 2);
+        withinBudget = withinBudget && ok;
+    }
+    return withinBudget;
+}
+
+bool StartupTrace::recordBudgets(const QString &templatePath, const QString &outPath, qreal headroom)
+{
+    QJsonObject document;
+    if (!readBudgetFile(templatePath, document)) {
+        return false;
+    }
+
+    QJsonArray budgets;
+    for (const QJsonValue &value : document.value("budgets").toArray()) {
+        QJsonObject budget = value.toObject();
+        qreal elapsedMs = 0.0;
+        if (measureInterval(budget.value("from").toString(), budget.value("mark").toString(), elapsedMs)) {
+            budget.insert("maxMs", qCeil(elapsedMs * headroom / 10.0) * 10);
+        }
+        budgets.append(budget);
+    }
+    document.insert("measured", true);
+    document.insert("budgets", budgets);
+
+    QFile file(outPath);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        qWarning() << "StartupTrace: cannot write budget file" << outPath;
+        return false;
+    }
+    file.write(QJsonDocument(document).toJson());
+    qDebug() << "Startup budget - recorded" << budgets.size() << "budgets with headroom" << headroom << "to" << outPath;
+    return true;
+}
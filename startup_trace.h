@@ -0,0 +1,43 @@
+#ifndef STARTUP_TRACE_H
+#define STARTUP_TRACE_H
+
+#include <QtGlobal>
+#include <QString>
+
+class QWidget;
+
+// 启动关键路径追踪
+// 各阶段在完成时调用mark()打点，时间为单调时钟上距进程启动（静态初始化）的纳秒数，同名只记第一次。
+// 打点本身总是开启的（只是往数组里追加一项）；--startup-trace时在退出前输出报告，
+// 再配合--startup-budget <文件>检查各阶段预算，超出时main()返回非0，供CI判定回归。
+// 报告的终点有两个：登录窗口第一次绘制（login_first_paint）和游戏视图第一次绘制（game_first_frame），
+// 用--startup-exit-after <打点名>在到达某个打点后自动退出，例如：
+//   QT_QPA_PLATFORM=offscreen ./ChiikawaNutritionAdventure --startup-trace \
+//       --startup-budget startup_budgets.json --startup-exit-after login_first_paint
+class StartupTrace
+{
+public:
+    // name须为字符串字面量，只保存指针
+    static void mark(const char* name);
+    // widget第一次收到绘制事件时打点（QGraphicsView请传viewport()）
+    static void markFirstPaint(QWidget* widget, const char* name);
+
+    static void setEnabled(bool enabled);
+    static bool isEnabled();
+    // 到达该打点后退出事件循环
+    static void setExitAfter(const QString &name);
+
+    // 每个打点距启动和距上一个打点的毫秒数，以及打点时的常驻内存（Windows和Linux）
+    static void printReport();
+
+    // 预算文件：{"measured": true, "budgets": [{"mark": "...", "from": "...", "maxMs": 0}]}
+    // from省略时从进程启动算起；本次没有到达的打点跳过。全部在预算内时返回true。
+    // measured为false表示数值是未经实测的占位值，检查时会提示
+    static bool checkBudgets(const QString &path);
+
+    // 以templatePath中的区间为准，把本次实测的耗时乘以headroom（向上取整到10毫秒）写成新的预算文件；
+    // 本次没有到达的区间保留模板中的数值。用于在目标机器上跑几次后定出预算
+    static bool recordBudgets(const QString &templatePath, const QString &outPath, qreal headroom);
+};
+
+#endif // STARTUP_TRACE_H
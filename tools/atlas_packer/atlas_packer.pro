@@ -0,0 +1,11 @@
+QT = core gui
+
+CONFIG += c++17 console
+CONFIG -= app_bundle
+
+TARGET = atlas_packer
+
+# 构建时的图集打包工具，由主工程的sprite_atlas步骤调用：
+#   atlas_packer <图集描述.json> <输出目录>
+SOURCES += \
+    main.cpp
@@ -0,0 +1,306 @@
+#include <QCoreApplication>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QImage>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QPainter>
+#include <QSaveFile>
+#include <QTextStream>
+#include <QVector>
+#include <algorithm>
+
+// 图集打包：按描述文件把角色图和道具图缩小到屏幕上的实际尺寸，打包进若干张图集页
+// 每个倍率（1x和HiDPI的2x）各一套图集页；镜像图不打包，由运行时从原图翻转生成。
+// 输出：<name>@<倍率>x_<页号>.png、<name>.json清单，以及把它们挂到":/atlas"下的<描述文件名>.qrc
+namespace
+{
+    struct SourceSprite {
+        QString key;         // 运行时查找用的资源路径，如":/img/roles/chimera1.png"
+        QImage image;
+        qreal displayScale;  // 游戏中绘制时的缩放
+        QStringList mirrors; // 由本图水平翻转得到的资源路径
+    };
+
+    struct Placement {
+        int page;
+        QRect rect;
+    };
+
+    QTextStream &err()
+    {
+        static QTextStream stream(stderr);
+        return stream;
+    }
+
+    bool readSpec(const QString &specPath, QString &name, int &pageSize, int &padding,
+                  QVector<int> &scales, QVector<SourceSprite> &sprites)
+    {
+        QFile file(specPath);
+        if (!file.open(QIODevice::ReadOnly)) {
+            err() << "atlas_packer: cannot open " << specPath << Qt::endl;
+            return false;
+        }
+        QJsonParseError error;
+        const QJsonObject spec = QJsonDocument::fromJson(file.readAll(), &error).object();
+        if (error.error != QJsonParseError::NoError) {
+            err() << "atlas_packer: invalid spec " << specPath << ": " << error.errorString() << Qt::endl;
+            return false;
+        }
+
+        name = spec.value("name").toString("sprites");
+        pageSize = spec.value("pageSize").toInt(1024);
+        padding = qMax(0, spec.value("padding").toInt(1));
+        const QString resourcePrefix = spec.value("resourcePrefix").toString(":/");
+        for (const QJsonValue &value : spec.value("scales").toArray()) {
+            scales.append(qMax(1, value.toInt(1)));
+        }
+        if (scales.isEmpty()) {
+            scales = { 1, 2 };
+        }
+
+        // 源文件路径相对描述文件所在目录
+        const QDir root = QFileInfo(specPath).absoluteDir();
+        for (const QJsonValue &value : spec.value("sprites").toArray()) {
+            const QJsonObject object = value.toObject();
+            SourceSprite sprite;
+            const QString path = object.value("path").toString();
+            sprite.key = resourcePrefix + path;
+            sprite.displayScale = object.value("scale").toDouble(1.0);
+            if (!sprite.image.load(root.filePath(path))) {
+                err() << "atlas_packer: cannot load " << root.filePath(path) << Qt::endl;
+                return false;
+            }
+            sprite.image = sprite.image.convertToFormat(QImage::Format_ARGB32);
+            for (const QJsonValue &mirror : object.value("mirrors").toArray()) {
+                sprite.mirrors.append(resourcePrefix + mirror.toString());
+            }
+            sprites.append(sprite);
+        }
+        return true;
+    }
+
+    QSize scaledSize(const SourceSprite &sprite, int scale)
+    {
+        return QSize(qMax(1, qRound(sprite.image.width() * sprite.displayScale * scale)),
+                     qMax(1, qRound(sprite.image.height() * sprite.displayScale * scale)));
+    }
+
+    // 货架式装箱：按高度从高到低逐行排放，一行放不下换行，一页放不下换页
+    bool pack(const QVector<QSize> &sizes, int pageSize, int padding,
+              QVector<Placement> &placements, int &pageCount)
+    {
+        QVector<int> order(sizes.size());
+        for (int i = 0; i < order.size(); ++i) {
+            order[i] = i;
+        }
+        std::stable_sort(order.begin(), order.end(), [&sizes](int a, int b) {
+            return sizes[a].height() > sizes[b].height();
+        });
+
+        placements.resize(sizes.size());
+        pageCount = sizes.isEmpty() ? 0 : 1;
+        int x = padding;
+        int y = padding;
+        int shelfHeight = 0;
+        for (int index : order) {
+            const QSize size = sizes[index];
+            if (size.width() + 2 * padding > pageSize || size.height() + 2 * padding > pageSize) {
+                err() << "atlas_packer: sprite larger than page size " << pageSize << Qt::endl;
+                return false;
+            }
+            if (x + size.width() + padding > pageSize) {
+                x = padding;
+                y += shelfHeight + padding;
+                shelfHeight = 0;
+            }
+            if (y + size.height() + padding > pageSize) {
+                ++pageCount;
+                x = padding;
+                y = padding;
+                shelfHeight = 0;
+            }
+            placements[index] = { pageCount - 1, QRect(QPoint(x, y), size) };
+            x += size.width() + padding;
+            shelfHeight = qMax(shelfHeight, size.height());
+        }
+        return true;
+    }
+
+    // 按运行时（AssetPreloader）的读法重新解析清单并逐项核对：
+    // 每个倍率下的页号和矩形在图集页内、同一页上的矩形互不重叠、矩形尺寸等于按显示缩放算出的尺寸，
+    // 并且运行时用"原图宽/矩形宽"作为像素比时，还原出的逻辑尺寸与原图一致（高度允许一个图集像素的取整误差）
+    bool checkManifest(const QByteArray &manifestData, const QVector<SourceSprite> &sources,
+                       const QVector<int> &scales, int pageSize)
+    {
+        const QJsonObject manifest = QJsonDocument::fromJson(manifestData).object();
+        const QJsonArray scaleArray = manifest.value("scales").toArray();
+        const QJsonArray spriteArray = manifest.value("sprites").toArray();
+        if (scaleArray.size() != scales.size() || spriteArray.size() != sources.size()) {
+            err() << "atlas_packer: manifest lists " << scaleArray.size() << " scales and "
+                  << spriteArray.size() << " sprites, expected " << scales.size() << " and "
+                  << sources.size() << Qt::endl;
+            return false;
+        }
+
+        for (int s = 0; s < scales.size(); ++s) {
+            const int scale = scaleArray.at(s).toObject().value("scale").toInt();
+            const int pageCount = scaleArray.at(s).toObject().value("pages").toArray().size();
+            QVector<QPair<int, QRect>> placed;
+            for (int i = 0; i < sources.size(); ++i) {
+                const QJsonObject sprite = spriteArray.at(i).toObject();
+                const QString key = sprite.value("key").toString();
+                const QJsonArray values = sprite.value("rects").toArray().at(s).toArray();
+                const int page = values.at(0).toInt(-1);
+                const QRect rect(values.at(1).toInt(), values.at(2).toInt(), values.at(3).toInt(), values.at(4).toInt());
+                const int sourceWidth = sprite.value("width").toInt();
+                const int sourceHeight = sprite.value("height").toInt();
+
+                if (scale != scales[s] || key != sources[i].key || page < 0 || page >= pageCount
+                    || rect.isEmpty() || !QRect(0, 0, pageSize, pageSize).contains(rect)) {
+                    err() << "atlas_packer: " << key << " has an invalid rect at " << scale << "x" << Qt::endl;
+                    return false;
+                }
+                if (rect.size() != scaledSize(sources[i], scale)) {
+                    err() << "atlas_packer: " << key << " rect does not match its display size at "
+                          << scale << "x" << Qt::endl;
+                    return false;
+                }
+                if (sourceWidth != sources[i].image.width() || sourceHeight != sources[i].image.height()) {
+                    err() << "atlas_packer: " << key << " source size mismatch" << Qt::endl;
+                    return false;
+                }
+                const qreal devicePixelRatio = static_cast<qreal>(sourceWidth) / rect.width();
+                if (qAbs(rect.height() * devicePixelRatio - sourceHeight) > devicePixelRatio) {
+                    err() << "atlas_packer: " << key << " logical height " << rect.height() * devicePixelRatio
+                          << " differs from source height " << sourceHeight << " at " << scale << "x" << Qt::endl;
+                    return false;
+                }
+                for (const QPair<int, QRect> &other : placed) {
+                    if (other.first == page && other.second.intersects(rect)) {
+                        err() << "atlas_packer: " << key << " overlaps another sprite at " << scale << "x" << Qt::endl;
+                        return false;
+                    }
+                }
+                placed.append(qMakePair(page, rect));
+            }
+        }
+        return true;
+    }
+
+    bool writeFile(const QString &path, const QByteArray &data)
+    {
+        QSaveFile file(path);
+        if (!file.open(QIODevice::WriteOnly) || file.write(data) != data.size()) {
+            return false;
+        }
+        return file.commit();
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    const QStringList arguments = app.arguments();
+    if (arguments.size() != 3) {
+        err() << "usage: atlas_packer <spec.json> <output-dir>" << Qt::endl;
+        return 2;
+    }
+    const QString specPath = arguments.at(1);
+    const QDir outDir(arguments.at(2));
+    QDir().mkpath(outDir.absolutePath());
+
+    QString name;
+    int pageSize = 0;
+    int padding = 0;
+    QVector<int> scales;
+    QVector<SourceSprite> sprites;
+    if (!readSpec(specPath, name, pageSize, padding, scales, sprites)) {
+        return 1;
+    }
+
+    QJsonArray scaleArray;
+    QVector<QVector<Placement>> placementsByScale;
+    QStringList resourceFiles;
+    for (int scale : scales) {
+        QVector<QSize> sizes;
+        for (const SourceSprite &sprite : sprites) {
+            sizes.append(scaledSize(sprite, scale));
+        }
+        QVector<Placement> placements;
+        int pageCount = 0;
+        if (!pack(sizes, pageSize, padding, placements, pageCount)) {
+            return 1;
+        }
+
+        QVector<QImage> pages(pageCount);
+        for (QImage &page : pages) {
+            page = QImage(pageSize, pageSize, QImage::Format_ARGB32);
+            page.fill(Qt::transparent);
+        }
+        for (int i = 0; i < sprites.size(); ++i) {
+            // 一次缩到目标尺寸，Qt的平滑缩小按面积取平均
+            const QImage scaled = sprites[i].image.scaled(sizes[i], Qt::IgnoreAspectRatio, Qt::SmoothTransformation);
+            QPainter painter(&pages[placements[i].page]);
+            painter.setCompositionMode(QPainter::CompositionMode_Source);
+            painter.drawImage(placements[i].rect.topLeft(), scaled);
+        }
+
+        QJsonArray pageNames;
+        for (int page = 0; page < pageCount; ++page) {
+            const QString fileName = QString("%1@%2x_%3.png").arg(name).arg(scale).arg(page);
+            if (!pages[page].save(outDir.filePath(fileName), "PNG", 0)) {
+                err() << "atlas_packer: cannot write " << outDir.filePath(fileName) << Qt::endl;
+                return 1;
+            }
+            pageNames.append(fileName);
+            resourceFiles.append(fileName);
+        }
+        scaleArray.append(QJsonObject{ { "scale", scale }, { "pages", pageNames } });
+        placementsByScale.append(placements);
+    }
+
+    // 清单：每张图记录原始尺寸和各倍率下的位置 [页号, x, y, 宽, 高]，镜像图只记录来源
+    QJsonArray spriteArray;
+    for (int i = 0; i < sprites.size(); ++i) {
+        QJsonArray rects;
+        for (const QVector<Placement> &placements : placementsByScale) {
+            const Placement &placement = placements[i];
+            rects.append(QJsonArray{ placement.page, placement.rect.x(), placement.rect.y(),
+                                     placement.rect.width(), placement.rect.height() });
+        }
+        spriteArray.append(QJsonObject{
+            { "key", sprites[i].key },
+            { "width", sprites[i].image.width() },
+            { "height", sprites[i].image.height() },
+            { "rects", rects },
+            { "mirrors", QJsonArray::fromStringList(sprites[i].mirrors) }
+        });
+    }
+    const QJsonObject manifest{ { "version", 1 }, { "scales", scaleArray }, { "sprites", spriteArray } };
+    const QByteArray manifestData = QJsonDocument(manifest).toJson(QJsonDocument::Compact);
+    if (!checkManifest(manifestData, sprites, scales, pageSize)) {
+        return 1;
+    }
+    const QString manifestName = name + ".json";
+    if (!writeFile(outDir.filePath(manifestName), manifestData)) {
+        err() << "atlas_packer: cannot write manifest" << Qt::endl;
+        return 1;
+    }
+    resourceFiles.prepend(manifestName);
+
+    // 最后写qrc：它是qmake额外编译步骤的输出，写出即表示图集已全部生成
+    QByteArray qrc = "<RCC>\n    <qresource prefix=\"/atlas\">\n";
+    for (const QString &file : resourceFiles) {
+        qrc += "        <file>" + file.toUtf8() + "</file>\n";
+    }
+    qrc += "    </qresource>\n</RCC>\n";
+    const QString qrcPath = outDir.filePath(QFileInfo(specPath).completeBaseName() + ".qrc");
+    if (!writeFile(qrcPath, qrc)) {
+        err() << "atlas_packer: cannot write " << qrcPath << Qt::endl;
+        return 1;
+    }
+    return 0;
+}